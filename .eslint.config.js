@@ -21,7 +21,7 @@ module.exports = {
 	"rules": {
 		"semi": [2, "always"],
 		"no-console": ["error", {
-			"allow": ["log"]
+			"allow": ["log", "write"]
 		}],
 		"no-redeclare": ["error", {
 			"builtinGlobals": false
@@ -0,0 +1,272 @@
+// SPDX-FileCopyrightText: 2026 Giovanni Dante Grazioli <deroad@kumo.xn--q9jyb4c>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+
+#define ARENA_PAGE_SIZE (64 * 1024)
+#define ARENA_ALIGN     16
+#define ARENA_POOL_MAX  64 // empty pages kept by arena_recycle (4MB)
+#define ARENA_DEAD      UINT32_MAX
+
+static const uint32_t class_sizes[] = {
+	16, 32, 48, 64, 80, 96, 112, 128,
+	144, 160, 176, 192, 208, 224, 240, 256,
+	320, 384, 512, 768, 1024, 1536, 2048, 4096,
+};
+
+#define ARENA_N_CLASSES (sizeof(class_sizes) / sizeof(class_sizes[0]))
+#define ARENA_MAX_SMALL 4096
+
+typedef struct arena_page_s arena_page_t;
+
+// precedes every block; page is NULL when the block comes from the system malloc.
+typedef union arena_block_u {
+	struct {
+		arena_page_t *page;
+		size_t size;
+	};
+	uint8_t align[ARENA_ALIGN];
+} arena_block_t;
+
+struct arena_page_s {
+	arena_page_t *prev; // partial list of its class, or pool
+	arena_page_t *next;
+	arena_page_t *chain; // all the pages of the arena
+	arena_block_t *free; // released blocks, the next is stored in the payload
+	uint8_t *bump; // first never used block
+	uint8_t *end;
+	uint32_t live;
+	uint32_t klass;
+	int linked;
+};
+
+#define ARENA_PAGE_HEADER ((sizeof(arena_page_t) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+struct arena_s {
+	arena_page_t *partial[ARENA_N_CLASSES]; // pages with at least one free block
+	arena_page_t *pool;
+	arena_page_t *pages;
+	arena_stats_t stats;
+};
+
+static uint32_t size_class(size_t size) {
+	if (size <= 256) {
+		return size ? (uint32_t)((size + 15) >> 4) - 1 : 0;
+	}
+	uint32_t k = 16;
+	while (class_sizes[k] < size) {
+		k++;
+	}
+	return k;
+}
+
+static inline size_t class_stride(uint32_t klass) {
+	return sizeof(arena_block_t) + class_sizes[klass];
+}
+
+static void list_push(arena_page_t **head, arena_page_t *page) {
+	page->prev = NULL;
+	page->next = *head;
+	if (*head) {
+		(*head)->prev = page;
+	}
+	*head = page;
+	page->linked = 1;
+}
+
+static void list_unlink(arena_page_t **head, arena_page_t *page) {
+	if (page->prev) {
+		page->prev->next = page->next;
+	} else {
+		*head = page->next;
+	}
+	if (page->next) {
+		page->next->prev = page->prev;
+	}
+	page->prev = page->next = NULL;
+	page->linked = 0;
+}
+
+static arena_page_t *page_new(arena_t *arena, uint32_t klass) {
+	arena_page_t *page = arena->pool;
+	if (page) {
+		list_unlink(&arena->pool, page);
+		arena->stats.pooled--;
+		arena->stats.recycled++;
+	} else if ((page = malloc(ARENA_PAGE_SIZE))) {
+		page->chain = arena->pages;
+		arena->pages = page;
+		arena->stats.pages++;
+	} else {
+		return NULL;
+	}
+	page->free = NULL;
+	page->bump = (uint8_t *)page + ARENA_PAGE_HEADER;
+	page->end = (uint8_t *)page + ARENA_PAGE_SIZE;
+	page->live = 0;
+	page->klass = klass;
+	list_push(&arena->partial[klass], page);
+	return page;
+}
+
+arena_t *arena_new(void) {
+	return calloc(1, sizeof(arena_t));
+}
+
+void arena_free(arena_t *arena) {
+	if (!arena) {
+		return;
+	}
+	arena_page_t *page = arena->pages;
+	while (page) {
+		arena_page_t *chain = page->chain;
+		free(page);
+		page = chain;
+	}
+	free(arena);
+}
+
+void *arena_alloc(arena_t *arena, size_t size) {
+	arena_block_t *block;
+	arena->stats.allocs++;
+	if (size > ARENA_MAX_SMALL) {
+		if (!(block = malloc(sizeof(arena_block_t) + size))) {
+			return NULL;
+		}
+		block->page = NULL;
+		block->size = size;
+		arena->stats.large++;
+		return block + 1;
+	}
+
+	uint32_t klass = size_class(size);
+	arena_page_t *page = arena->partial[klass];
+	if (!page && !(page = page_new(arena, klass))) {
+		return NULL;
+	}
+
+	size_t stride = class_stride(klass);
+	if (page->free) {
+		block = page->free;
+		page->free = *(arena_block_t **)(block + 1);
+	} else {
+		block = (arena_block_t *)page->bump;
+		page->bump += stride;
+	}
+	page->live++;
+	if (!page->free && page->bump + stride > page->end) {
+		// full; it goes back to the partial list on the next release.
+		list_unlink(&arena->partial[klass], page);
+	}
+
+	block->page = page;
+	block->size = class_sizes[klass];
+	return block + 1;
+}
+
+void *arena_calloc(arena_t *arena, size_t count, size_t size) {
+	if (size && count > SIZE_MAX / size) {
+		return NULL;
+	}
+	void *ptr = arena_alloc(arena, count * size);
+	if (ptr) {
+		memset(ptr, 0, count * size);
+	}
+	return ptr;
+}
+
+void arena_release(arena_t *arena, void *ptr) {
+	if (!ptr) {
+		return;
+	}
+	arena_block_t *block = (arena_block_t *)ptr - 1;
+	arena_page_t *page = block->page;
+	if (!page) {
+		arena->stats.large--;
+		free(block);
+		return;
+	}
+
+	*(arena_block_t **)ptr = page->free;
+	page->free = block;
+	page->live--;
+
+	arena_page_t **partial = &arena->partial[page->klass];
+	if (!page->linked) {
+		list_push(partial, page);
+	} else if (!page->live && (page->prev || page->next)) {
+		// an empty page goes to the pool unless it is the last one of its class.
+		list_unlink(partial, page);
+		list_push(&arena->pool, page);
+		arena->stats.pooled++;
+	}
+}
+
+void *arena_realloc(arena_t *arena, void *ptr, size_t size) {
+	if (!ptr) {
+		return arena_alloc(arena, size);
+	} else if (!size) {
+		arena_release(arena, ptr);
+		return NULL;
+	}
+
+	arena_block_t *block = (arena_block_t *)ptr - 1;
+	if (!block->page && size > ARENA_MAX_SMALL) {
+		arena_block_t *resized = realloc(block, sizeof(arena_block_t) + size);
+		if (!resized) {
+			return NULL;
+		}
+		resized->size = size;
+		return resized + 1;
+	} else if (block->page && size <= block->size) {
+		return ptr;
+	}
+
+	void *moved = arena_alloc(arena, size);
+	if (!moved) {
+		return NULL;
+	}
+	memcpy(moved, ptr, block->size < size ? block->size : size);
+	arena_release(arena, ptr);
+	return moved;
+}
+
+size_t arena_usable_size(const void *ptr) {
+	return ptr ? ((const arena_block_t *)ptr - 1)->size : 0;
+}
+
+/**
+ * Called between runs: the pool keeps up to ARENA_POOL_MAX pages
+ * for the next run and gives the rest back to the system.
+ */
+void arena_recycle(arena_t *arena) {
+	if (arena->stats.pooled <= ARENA_POOL_MAX) {
+		return;
+	}
+	while (arena->stats.pooled > ARENA_POOL_MAX) {
+		arena_page_t *page = arena->pool;
+		list_unlink(&arena->pool, page);
+		page->klass = ARENA_DEAD;
+		arena->stats.pooled--;
+	}
+
+	arena_page_t **chain = &arena->pages;
+	while (*chain) {
+		arena_page_t *page = *chain;
+		if (page->klass == ARENA_DEAD) {
+			*chain = page->chain;
+			free(page);
+			arena->stats.pages--;
+		} else {
+			chain = &page->chain;
+		}
+	}
+}
+
+void arena_stats(const arena_t *arena, arena_stats_t *stats) {
+	*stats = arena->stats;
+}
@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: 2026 Giovanni Dante Grazioli <deroad@kumo.xn--q9jyb4c>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef R2DEC_ARENA_H
+#define R2DEC_ARENA_H
+
+#include <stddef.h>
+
+/**
+ * Size-classed page allocator used as the quickjs heap.
+ * Small blocks are carved out of fixed size pages, one size class per page,
+ * and the pages that become empty are returned to a shared pool, so they
+ * can be reused by any size class (i.e. by the next decompilation).
+ * Blocks bigger than the largest class are served by the system malloc.
+ * An arena is not thread-safe; each runtime owns its own.
+ */
+typedef struct arena_s arena_t;
+
+typedef struct arena_stats_s {
+	size_t pages; // pages allocated from the system
+	size_t pooled; // empty pages ready to be reused
+	size_t large; // live blocks served by the system malloc
+	size_t allocs; // total allocations
+	size_t recycled; // pages taken from the pool instead of the system
+} arena_stats_t;
+
+arena_t *arena_new(void);
+void arena_free(arena_t *arena);
+void *arena_alloc(arena_t *arena, size_t size);
+void *arena_calloc(arena_t *arena, size_t count, size_t size);
+void *arena_realloc(arena_t *arena, void *ptr, size_t size);
+void arena_release(arena_t *arena, void *ptr);
+size_t arena_usable_size(const void *ptr);
+void arena_recycle(arena_t *arena);
+void arena_stats(const arena_t *arena, arena_stats_t *stats);
+
+#endif /* R2DEC_ARENA_H */
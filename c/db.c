@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: 2026 Giovanni Dante Grazioli <deroad@kumo.xn--q9jyb4c>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "db.h"
+#include "db_tables.h"
+
+#define DB_COUNT(x) (sizeof(x) / sizeof(x[0]))
+
+static int compare_interrupt(const void *key, const void *elem) {
+	uint32_t number = *(const uint32_t *)key;
+	const db_interrupt_t *interrupt = (const db_interrupt_t *)elem;
+	return number < interrupt->number ? -1 : (number > interrupt->number);
+}
+
+static int compare_syscall(const void *key, const void *elem) {
+	uint32_t number = *(const uint32_t *)key;
+	const db_syscall_t *syscall = (const db_syscall_t *)elem;
+	return number < syscall->number ? -1 : (number > syscall->number);
+}
+
+static int compare_call(const void *key, const void *elem) {
+	return strcmp((const char *)key, ((const db_call_t *)elem)->name);
+}
+
+static int has_arch(const char *archs, const char *arch) {
+	size_t size = strlen(arch);
+	for (const char *p = archs; p; p = strchr(p, '|'), p = p ? p + 1 : NULL) {
+		if (!strncmp(p, arch, size) && (p[size] == '|' || !p[size])) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+const db_interrupt_t *db_interrupt(uint32_t number, const char *arch) {
+	const db_interrupt_t *interrupt = bsearch(&number, db_interrupts, DB_COUNT(db_interrupts), sizeof(db_interrupt_t), compare_interrupt);
+	return interrupt && has_arch(interrupt->archs, arch) ? interrupt : NULL;
+}
+
+const db_syscall_t *db_syscall(const db_interrupt_t *interrupt, uint32_t number) {
+	if (!interrupt || !interrupt->n_syscalls) {
+		return NULL;
+	}
+	return bsearch(&number, interrupt->syscalls, interrupt->n_syscalls, sizeof(db_syscall_t), compare_syscall);
+}
+
+const db_call_t *db_call(const char *name) {
+	return bsearch(name, db_calls, DB_COUNT(db_calls), sizeof(db_call_t), compare_call);
+}
+
+/**
+ * Reads a number written like the javascript keys of the old tables,
+ * i.e. lowercase hex without prefix and leading zeros.
+ */
+static int js_to_hex(JSContext *ctx, JSValueConst value, uint32_t *number) {
+	const char *text = JS_ToCString(ctx, value);
+	if (!text) {
+		return -1;
+	}
+	size_t size = strlen(text);
+	int ok = size > 0 && size <= 8 && strspn(text, "0123456789abcdef") == size && (size == 1 || text[0] != '0');
+	*number = ok ? (uint32_t)strtoul(text, NULL, 16) : 0;
+	JS_FreeCString(ctx, text);
+	return ok;
+}
+
+/**
+ * r2dec.syscall(interrupt, arch) returns {comment, size} of the interrupt
+ * and r2dec.syscall(interrupt, arch, number) returns {name, args, comment}
+ * of the syscall; the numbers are hex strings, null is returned when unknown.
+ */
+static JSValue js_syscall(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 2 && argc != 3) {
+		return JS_ThrowTypeError(ctx, "syscall expects (interrupt, arch[, number])");
+	}
+	uint32_t number = 0;
+	int ok = js_to_hex(ctx, argv[0], &number);
+	if (ok < 0) {
+		return JS_EXCEPTION;
+	} else if (!ok) {
+		return JS_NULL;
+	}
+	const char *arch = JS_ToCString(ctx, argv[1]);
+	if (!arch) {
+		return JS_EXCEPTION;
+	}
+	const db_interrupt_t *interrupt = db_interrupt(number, arch);
+	JS_FreeCString(ctx, arch);
+	if (!interrupt) {
+		return JS_NULL;
+	}
+
+	JSValue result;
+	if (argc == 2) {
+		result = JS_NewObject(ctx);
+		if (interrupt->comment) {
+			JS_SetPropertyStr(ctx, result, "comment", JS_NewString(ctx, interrupt->comment));
+		}
+		JS_SetPropertyStr(ctx, result, "size", JS_NewUint32(ctx, interrupt->n_syscalls));
+		return result;
+	}
+
+	if ((ok = js_to_hex(ctx, argv[2], &number)) < 0) {
+		return JS_EXCEPTION;
+	}
+	const db_syscall_t *syscall = ok ? db_syscall(interrupt, number) : NULL;
+	if (!syscall) {
+		return JS_NULL;
+	}
+	result = JS_NewObject(ctx);
+	if (syscall->name) {
+		JS_SetPropertyStr(ctx, result, "name", JS_NewString(ctx, syscall->name));
+	}
+	if (syscall->args >= 0) {
+		JS_SetPropertyStr(ctx, result, "args", JS_NewInt32(ctx, syscall->args));
+	}
+	if (syscall->comment) {
+		JS_SetPropertyStr(ctx, result, "comment", JS_NewString(ctx, syscall->comment));
+	}
+	return result;
+}
+
+/**
+ * r2dec.knownCall(name) returns {required, varargs} or null.
+ */
+static JSValue js_known_call(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 1) {
+		return JS_ThrowTypeError(ctx, "knownCall expects (name)");
+	}
+	const char *name = JS_ToCString(ctx, argv[0]);
+	if (!name) {
+		return JS_EXCEPTION;
+	}
+	const db_call_t *call = db_call(name);
+	JS_FreeCString(ctx, name);
+	if (!call) {
+		return JS_NULL;
+	}
+
+	JSValue result = JS_NewObject(ctx);
+	JS_SetPropertyStr(ctx, result, "required", JS_NewInt32(ctx, call->required));
+	JS_SetPropertyStr(ctx, result, "varargs", JS_NewBool(ctx, call->varargs));
+	return result;
+}
+
+void db_install(JSContext *ctx, JSValueConst r2dec) {
+	JS_SetPropertyStr(ctx, r2dec, "syscall", JS_NewCFunction(ctx, js_syscall, "syscall", 3));
+	JS_SetPropertyStr(ctx, r2dec, "knownCall", JS_NewCFunction(ctx, js_known_call, "knownCall", 1));
+}
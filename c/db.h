@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: 2026 Giovanni Dante Grazioli <deroad@kumo.xn--q9jyb4c>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef R2DEC_DB_H
+#define R2DEC_DB_H
+
+#include <stdint.h>
+#include <quickjs.h>
+
+/**
+ * Read-only databases, generated at build time by tools/db_gen.c from
+ * the tables of tools/db as sorted arrays; they are shared by all the runtimes
+ * and javascript reads them via r2dec.syscall and r2dec.knownCall.
+ */
+typedef struct db_syscall_s {
+	uint32_t number;
+	const char *name;
+	int32_t args; // -1 when unknown
+	const char *comment;
+} db_syscall_t;
+
+typedef struct db_interrupt_s {
+	uint32_t number;
+	const char *archs; // separated by '|'
+	const char *comment;
+	const db_syscall_t *syscalls; // sorted by number
+	uint32_t n_syscalls;
+} db_interrupt_t;
+
+typedef struct db_call_s {
+	const char *name;
+	int32_t required; // -1 when variable
+	int32_t varargs;
+} db_call_t;
+
+const db_interrupt_t *db_interrupt(uint32_t number, const char *arch);
+const db_syscall_t *db_syscall(const db_interrupt_t *interrupt, uint32_t number);
+const db_call_t *db_call(const char *name);
+void db_install(JSContext *ctx, JSValueConst r2dec);
+
+#endif /* R2DEC_DB_H */
@@ -0,0 +1,692 @@
+// SPDX-FileCopyrightText: 2026 Giovanni Dante Grazioli <deroad@kumo.xn--q9jyb4c>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "issue.h"
+
+#define ISSUE_HEADER_SIZE 12
+#define ISSUE_MAX_DEPTH   512
+#define FNV32_OFFSET      0x811c9dc5u
+#define FNV32_PRIME       0x01000193u
+
+typedef struct bytes_s {
+	uint8_t *data;
+	size_t size;
+	size_t capacity;
+} bytes_t;
+
+typedef struct pool_entry_s {
+	uint32_t hash;
+	uint32_t index; // 0 when empty, otherwise string index + 1
+	size_t offset; // of the bytes within the pool
+	size_t size;
+} pool_entry_t;
+
+struct issue_writer_s {
+	FILE *fp;
+	uint64_t bytes;
+	bytes_t section; // payload being encoded
+	bytes_t pool; // ISSUE_STRINGS payload, without the count
+	bytes_t scratch; // unescaped json string
+	bytes_t name; // section name of issue_pack
+	pool_entry_t *table;
+	uint32_t table_size;
+	uint32_t n_strings;
+	int failed;
+};
+
+typedef struct json_s {
+	issue_writer_t *writer;
+	const char *p;
+	const char *end;
+	int depth;
+} json_t;
+
+static int bytes_reserve(bytes_t *b, size_t size) {
+	if (b->size + size <= b->capacity) {
+		return 1;
+	}
+	size_t capacity = b->capacity ? b->capacity : 4096;
+	while (b->size + size > capacity) {
+		capacity *= 2;
+	}
+	uint8_t *data = realloc(b->data, capacity);
+	if (!data) {
+		return 0;
+	}
+	b->data = data;
+	b->capacity = capacity;
+	return 1;
+}
+
+static int bytes_append(bytes_t *b, const void *data, size_t size) {
+	if (!bytes_reserve(b, size)) {
+		return 0;
+	}
+	memcpy(b->data + b->size, data, size);
+	b->size += size;
+	return 1;
+}
+
+static int bytes_byte(bytes_t *b, uint8_t byte) {
+	return bytes_append(b, &byte, 1);
+}
+
+static size_t varint_encode(uint8_t *p, uint64_t value) {
+	size_t n = 0;
+	while (value >= 0x80) {
+		p[n++] = (uint8_t)(value | 0x80);
+		value >>= 7;
+	}
+	p[n++] = (uint8_t)value;
+	return n;
+}
+
+static int bytes_varint(bytes_t *b, uint64_t value) {
+	uint8_t buffer[10];
+	return bytes_append(b, buffer, varint_encode(buffer, value));
+}
+
+const uint8_t *issue_varint(const uint8_t *p, const uint8_t *end, uint64_t *value) {
+	uint64_t result = 0;
+	for (int shift = 0; p < end && shift < 64; shift += 7) {
+		uint8_t byte = *p++;
+		result |= (uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			*value = result;
+			return p;
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Returns the index of the string in the pool, adding it when missing;
+ * each distinct string (or object key) is stored once per file.
+ */
+static int64_t pool_intern(issue_writer_t *writer, const uint8_t *str, size_t size) {
+	uint32_t hash = FNV32_OFFSET;
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ str[i]) * FNV32_PRIME;
+	}
+
+	if ((writer->n_strings + 1) * 4 >= writer->table_size * 3) {
+		uint32_t table_size = writer->table_size ? writer->table_size * 2 : 1024;
+		pool_entry_t *table = calloc(table_size, sizeof(pool_entry_t));
+		if (!table) {
+			return -1;
+		}
+		for (uint32_t i = 0; i < writer->table_size; ++i) {
+			pool_entry_t *entry = &writer->table[i];
+			if (!entry->index) {
+				continue;
+			}
+			uint32_t k = entry->hash & (table_size - 1);
+			while (table[k].index) {
+				k = (k + 1) & (table_size - 1);
+			}
+			table[k] = *entry;
+		}
+		free(writer->table);
+		writer->table = table;
+		writer->table_size = table_size;
+	}
+
+	uint32_t k = hash & (writer->table_size - 1);
+	for (; writer->table[k].index; k = (k + 1) & (writer->table_size - 1)) {
+		pool_entry_t *entry = &writer->table[k];
+		if (entry->hash == hash && entry->size == size && !memcmp(writer->pool.data + entry->offset, str, size)) {
+			return entry->index - 1;
+		}
+	}
+
+	if (!bytes_varint(&writer->pool, size)) {
+		return -1;
+	}
+	size_t offset = writer->pool.size;
+	if (!bytes_append(&writer->pool, str, size)) {
+		return -1;
+	}
+	pool_entry_t *entry = &writer->table[k];
+	entry->hash = hash;
+	entry->index = ++writer->n_strings;
+	entry->offset = offset;
+	entry->size = size;
+	return entry->index - 1;
+}
+
+static int encode_string(issue_writer_t *writer, bytes_t *out, uint8_t tag, const uint8_t *str, size_t size) {
+	int64_t index = pool_intern(writer, str, size);
+	if (index < 0) {
+		return 0;
+	}
+	return (!tag || bytes_byte(out, tag)) && bytes_varint(out, (uint64_t)index);
+}
+
+static void json_white(json_t *js) {
+	while (js->p < js->end && (*js->p == ' ' || *js->p == '\t' || *js->p == '\n' || *js->p == '\r')) {
+		js->p++;
+	}
+}
+
+static int json_hex4(json_t *js, uint32_t *value) {
+	if (js->end - js->p < 4) {
+		return 0;
+	}
+	uint32_t v = 0;
+	for (int i = 0; i < 4; ++i) {
+		char c = *js->p++;
+		v <<= 4;
+		if (c >= '0' && c <= '9') {
+			v |= c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			v |= c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			v |= c - 'A' + 10;
+		} else {
+			return 0;
+		}
+	}
+	*value = v;
+	return 1;
+}
+
+static int utf8_append(bytes_t *b, uint32_t cp) {
+	uint8_t u[4];
+	size_t n = 0;
+	if (cp < 0x80) {
+		u[n++] = cp;
+	} else if (cp < 0x800) {
+		u[n++] = 0xc0 | (cp >> 6);
+		u[n++] = 0x80 | (cp & 0x3f);
+	} else if (cp < 0x10000) {
+		u[n++] = 0xe0 | (cp >> 12);
+		u[n++] = 0x80 | ((cp >> 6) & 0x3f);
+		u[n++] = 0x80 | (cp & 0x3f);
+	} else {
+		u[n++] = 0xf0 | (cp >> 18);
+		u[n++] = 0x80 | ((cp >> 12) & 0x3f);
+		u[n++] = 0x80 | ((cp >> 6) & 0x3f);
+		u[n++] = 0x80 | (cp & 0x3f);
+	}
+	return bytes_append(b, u, n);
+}
+
+/**
+ * Unescapes the json string at js->p (after the quote) into the scratch buffer.
+ */
+static int json_string(json_t *js, bytes_t *out) {
+	out->size = 0;
+	while (js->p < js->end) {
+		const char *start = js->p;
+		while (js->p < js->end && *js->p != '"' && *js->p != '\\') {
+			js->p++;
+		}
+		if (!bytes_append(out, start, js->p - start)) {
+			return 0;
+		} else if (js->p >= js->end) {
+			break;
+		} else if (*js->p == '"') {
+			js->p++;
+			return 1;
+		}
+
+		js->p++;
+		if (js->p >= js->end) {
+			break;
+		}
+		char c = *js->p++;
+		uint32_t cp = 0;
+		switch (c) {
+		case 'b':
+			cp = '\b';
+			break;
+		case 'f':
+			cp = '\f';
+			break;
+		case 'n':
+			cp = '\n';
+			break;
+		case 'r':
+			cp = '\r';
+			break;
+		case 't':
+			cp = '\t';
+			break;
+		case 'u':
+			if (!json_hex4(js, &cp)) {
+				return 0;
+			}
+			if (cp >= 0xd800 && cp < 0xdc00 && js->end - js->p >= 6 && js->p[0] == '\\' && js->p[1] == 'u') {
+				uint32_t low = 0;
+				js->p += 2;
+				if (!json_hex4(js, &low)) {
+					return 0;
+				} else if (low >= 0xdc00 && low < 0xe000) {
+					cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+				} else if (!utf8_append(out, cp)) {
+					return 0;
+				} else {
+					cp = low;
+				}
+			}
+			break;
+		default:
+			// \" \\ \/ and any other escaped character
+			cp = (uint8_t)c;
+			break;
+		}
+		if (!utf8_append(out, cp)) {
+			return 0;
+		}
+	}
+	return 0;
+}
+
+static int json_number(json_t *js, bytes_t *out) {
+	const char *start = js->p;
+	int negative = *js->p == '-';
+	int integer = 1;
+	if (negative) {
+		js->p++;
+	}
+	while (js->p < js->end) {
+		char c = *js->p;
+		if (c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+			integer = 0;
+		} else if (c < '0' || c > '9') {
+			break;
+		}
+		js->p++;
+	}
+
+	char number[64];
+	size_t size = js->p - start;
+	if (size < 1 || size >= sizeof(number) || (negative && size < 2)) {
+		return 0;
+	}
+	memcpy(number, start, size);
+	number[size] = 0;
+	if (integer) {
+		// same of JSONex.parse, which returns the integers as Long.
+		uint64_t value = strtoull(number + negative, NULL, 10);
+		return bytes_byte(out, negative ? ISSUE_TAG_NINT : ISSUE_TAG_UINT) && bytes_varint(out, value);
+	}
+
+	double value = strtod(number, NULL);
+	uint64_t bits = 0;
+	memcpy(&bits, &value, sizeof(bits));
+	uint8_t le[8];
+	for (int i = 0; i < 8; ++i) {
+		le[i] = (uint8_t)(bits >> (i * 8));
+	}
+	return bytes_byte(out, ISSUE_TAG_DOUBLE) && bytes_append(out, le, sizeof(le));
+}
+
+static int json_literal(json_t *js, const char *literal, uint8_t tag, bytes_t *out) {
+	size_t size = strlen(literal);
+	if ((size_t)(js->end - js->p) < size || memcmp(js->p, literal, size)) {
+		return 0;
+	}
+	js->p += size;
+	return bytes_byte(out, tag);
+}
+
+static int json_value(json_t *js, bytes_t *out);
+
+/**
+ * Encodes the members (or elements) until the closing character; the
+ * caller emits the container tag, so merging can drop it.
+ */
+static int json_members(json_t *js, bytes_t *out, int object) {
+	issue_writer_t *writer = js->writer;
+	char close = object ? '}' : ']';
+	json_white(js);
+	if (js->p < js->end && *js->p == close) {
+		js->p++;
+		return 1;
+	}
+	while (js->p < js->end) {
+		if (object) {
+			if (*js->p != '"') {
+				return 0;
+			}
+			js->p++;
+			if (!json_string(js, &writer->scratch) ||
+				!encode_string(writer, out, 0, writer->scratch.data, writer->scratch.size)) {
+				return 0;
+			}
+			json_white(js);
+			if (js->p >= js->end || *js->p != ':') {
+				return 0;
+			}
+			js->p++;
+		}
+		if (!json_value(js, out)) {
+			return 0;
+		}
+		json_white(js);
+		if (js->p < js->end && *js->p == ',') {
+			js->p++;
+			json_white(js);
+		} else if (js->p < js->end && *js->p == close) {
+			js->p++;
+			return 1;
+		} else {
+			return 0;
+		}
+	}
+	return 0;
+}
+
+static int json_value(json_t *js, bytes_t *out) {
+	issue_writer_t *writer = js->writer;
+	json_white(js);
+	if (js->p >= js->end) {
+		return 0;
+	}
+	int ok = 0;
+	switch (*js->p) {
+	case '{':
+	case '[':
+		if (js->depth >= ISSUE_MAX_DEPTH) {
+			return 0;
+		}
+		js->depth++;
+		ok = bytes_byte(out, *js->p == '{' ? ISSUE_TAG_OBJECT : ISSUE_TAG_ARRAY);
+		js->p++;
+		ok = ok && json_members(js, out, js->p[-1] == '{') && bytes_byte(out, ISSUE_TAG_END);
+		js->depth--;
+		return ok;
+	case '"':
+		js->p++;
+		return json_string(js, &writer->scratch) &&
+			encode_string(writer, out, ISSUE_TAG_STRING, writer->scratch.data, writer->scratch.size);
+	case 't':
+		return json_literal(js, "true", ISSUE_TAG_TRUE, out);
+	case 'f':
+		return json_literal(js, "false", ISSUE_TAG_FALSE, out);
+	case 'n':
+		return json_literal(js, "null", ISSUE_TAG_NULL, out);
+	default:
+		return json_number(js, out);
+	}
+}
+
+static int file_write(FILE *fp, const void *data, size_t size) {
+	return !size || fwrite(data, 1, size, fp) == size;
+}
+
+static int section_write(issue_writer_t *writer, const char *name, size_t name_size, const uint8_t *prefix, size_t prefix_size, const bytes_t *payload) {
+	uint8_t name_header[10], payload_header[10];
+	size_t name_header_size = varint_encode(name_header, name_size);
+	size_t payload_header_size = varint_encode(payload_header, prefix_size + payload->size);
+	if (!file_write(writer->fp, name_header, name_header_size) ||
+		!file_write(writer->fp, name, name_size) ||
+		!file_write(writer->fp, payload_header, payload_header_size) ||
+		!file_write(writer->fp, prefix, prefix_size) ||
+		!file_write(writer->fp, payload->data, payload->size)) {
+		writer->failed = 1;
+		return 0;
+	}
+	writer->bytes += name_header_size + name_size + payload_header_size + prefix_size + payload->size;
+	return 1;
+}
+
+issue_writer_t *issue_create(const char *file) {
+	issue_writer_t *writer = calloc(1, sizeof(issue_writer_t));
+	if (!writer) {
+		return NULL;
+	} else if (!(writer->fp = fopen(file, "wb"))) {
+		free(writer);
+		return NULL;
+	}
+
+	uint8_t header[ISSUE_HEADER_SIZE];
+	memcpy(header, ISSUE_MAGIC, 8);
+	for (int i = 0; i < 4; ++i) {
+		header[8 + i] = (uint8_t)(ISSUE_VERSION >> (i * 8));
+	}
+	if (fwrite(header, 1, sizeof(header), writer->fp) != sizeof(header)) {
+		writer->failed = 1;
+	}
+	writer->bytes = sizeof(header);
+	return writer;
+}
+
+/**
+ * Encodes the json text as a section; with merge the text is a sequence of
+ * values (i.e. one per line, like afsj @@i) whose arrays are concatenated
+ * into a single array, and empty objects are dropped.
+ */
+int issue_json(issue_writer_t *writer, const char *name, const char *json, size_t size, int merge) {
+	if (!writer || writer->failed) {
+		return 0;
+	}
+	json_t js = { writer, json, json + size, 0 };
+	bytes_t *out = &writer->section;
+	out->size = 0;
+
+	int ok = 1;
+	if (merge) {
+		ok = bytes_byte(out, ISSUE_TAG_ARRAY);
+		for (json_white(&js); ok && js.p < js.end; json_white(&js)) {
+			if (*js.p == '[') {
+				js.p++;
+				ok = json_members(&js, out, 0);
+				continue;
+			}
+			size_t mark = out->size;
+			ok = json_value(&js, out);
+			if (ok && out->size == mark + 2 && out->data[mark] == ISSUE_TAG_OBJECT) {
+				out->size = mark;
+			}
+		}
+		ok = ok && bytes_byte(out, ISSUE_TAG_END);
+	} else {
+		ok = json_value(&js, out);
+		json_white(&js);
+		ok = ok && js.p == js.end;
+	}
+	return ok && section_write(writer, name, strlen(name), NULL, 0, out);
+}
+
+int issue_string(issue_writer_t *writer, const char *name, const char *str, size_t size) {
+	if (!writer || writer->failed) {
+		return 0;
+	}
+	bytes_t *out = &writer->section;
+	out->size = 0;
+	return encode_string(writer, out, ISSUE_TAG_STRING, (const uint8_t *)str, size) &&
+		section_write(writer, name, strlen(name), NULL, 0, out);
+}
+
+/**
+ * Converts an issue json: each member of the top level object becomes a section.
+ */
+int issue_pack(issue_writer_t *writer, const char *json, size_t size) {
+	if (!writer || writer->failed) {
+		return 0;
+	}
+	json_t js = { writer, json, json + size, 0 };
+	json_white(&js);
+	if (js.p >= js.end || *js.p != '{') {
+		return 0;
+	}
+	js.p++;
+	json_white(&js);
+	if (js.p < js.end && *js.p == '}') {
+		return 1;
+	}
+	while (js.p < js.end && *js.p == '"') {
+		js.p++;
+		writer->section.size = 0;
+		if (!json_string(&js, &writer->name)) {
+			return 0;
+		}
+		json_white(&js);
+		if (js.p >= js.end || *js.p != ':') {
+			return 0;
+		}
+		js.p++;
+		if (!json_value(&js, &writer->section) ||
+			!section_write(writer, (const char *)writer->name.data, writer->name.size, NULL, 0, &writer->section)) {
+			return 0;
+		}
+		json_white(&js);
+		if (js.p < js.end && *js.p == ',') {
+			js.p++;
+			json_white(&js);
+		} else {
+			return js.p < js.end && *js.p == '}';
+		}
+	}
+	return 0;
+}
+
+/**
+ * Writes the string pool and closes the file; returns 0 when any write failed.
+ */
+int issue_close(issue_writer_t *writer, uint64_t *bytes) {
+	if (!writer) {
+		return 0;
+	}
+	uint8_t count[10];
+	size_t count_size = varint_encode(count, writer->n_strings);
+	if (!writer->failed) {
+		section_write(writer, ISSUE_STRINGS, strlen(ISSUE_STRINGS), count, count_size, &writer->pool);
+	}
+	int ok = !writer->failed && !fclose(writer->fp);
+	if (writer->failed) {
+		fclose(writer->fp);
+	}
+	if (bytes) {
+		*bytes = writer->bytes;
+	}
+	free(writer->section.data);
+	free(writer->pool.data);
+	free(writer->scratch.data);
+	free(writer->name.data);
+	free(writer->table);
+	free(writer);
+	return ok;
+}
+
+static uint8_t *issue_load(const char *file, size_t *size) {
+#if defined(_WIN32)
+	FILE *fp = fopen(file, "rb");
+	if (!fp) {
+		return NULL;
+	}
+	uint8_t *data = NULL;
+	long length = 0;
+	if (!fseek(fp, 0, SEEK_END) && (length = ftell(fp)) >= ISSUE_HEADER_SIZE) {
+		rewind(fp);
+		if ((data = malloc(length)) && fread(data, 1, length, fp) != (size_t)length) {
+			free(data);
+			data = NULL;
+		}
+		*size = length;
+	}
+	fclose(fp);
+	return data;
+#else
+	int fd = open(file, O_RDONLY);
+	if (fd < 0) {
+		return NULL;
+	}
+	struct stat st;
+	uint8_t *data = NULL;
+	if (!fstat(fd, &st) && S_ISREG(st.st_mode) && st.st_size >= ISSUE_HEADER_SIZE) {
+		// private and writable, so javascript can never fault on the buffers.
+		data = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		data = data == MAP_FAILED ? NULL : data;
+		*size = st.st_size;
+	}
+	close(fd);
+	return data;
+#endif
+}
+
+/**
+ * Maps the file and indexes its sections; returns NULL when the file is
+ * not a binary issue (i.e. it is json).
+ */
+issue_t *issue_map(const char *file) {
+	issue_t *issue = calloc(1, sizeof(issue_t));
+	if (!issue) {
+		return NULL;
+	} else if (!(issue->map = issue_load(file, &issue->size)) || memcmp(issue->map, ISSUE_MAGIC, 8)) {
+		issue_unmap(issue);
+		return NULL;
+	}
+
+	uint32_t capacity = 0;
+	const uint8_t *p = issue->map + ISSUE_HEADER_SIZE;
+	const uint8_t *end = issue->map + issue->size;
+	while (p < end) {
+		uint64_t name_size = 0, size = 0;
+		if (!(p = issue_varint(p, end, &name_size)) || name_size > (uint64_t)(end - p)) {
+			break;
+		}
+		const char *name = (const char *)p;
+		p += name_size;
+		if (!(p = issue_varint(p, end, &size)) || size > (uint64_t)(end - p)) {
+			break;
+		}
+		if (issue->n_sections >= capacity) {
+			capacity = capacity ? capacity * 2 : 16;
+			issue_section_t *sections = realloc(issue->sections, capacity * sizeof(issue_section_t));
+			if (!sections) {
+				break;
+			}
+			issue->sections = sections;
+		}
+		issue_section_t *section = &issue->sections[issue->n_sections++];
+		section->name = name;
+		section->name_size = (uint32_t)name_size;
+		section->data = (uint8_t *)p;
+		section->size = size;
+		p += size;
+	}
+
+	for (uint32_t i = 0; i < issue->n_sections; ++i) {
+		const issue_section_t *section = &issue->sections[i];
+		uint64_t count = 0;
+		if (section->name_size == strlen(ISSUE_STRINGS) && !memcmp(section->name, ISSUE_STRINGS, section->name_size) &&
+			issue_varint(section->data, section->data + section->size, &count) && count <= UINT32_MAX) {
+			issue->strings = section;
+			issue->n_strings = (uint32_t)count;
+		}
+	}
+	if (p != end || !issue->strings) {
+		// truncated file (i.e. pddi did not complete)
+		issue_unmap(issue);
+		return NULL;
+	}
+	return issue;
+}
+
+void issue_unmap(issue_t *issue) {
+	if (!issue) {
+		return;
+	}
+#if defined(_WIN32)
+	free(issue->map);
+#else
+	if (issue->map) {
+		munmap(issue->map, issue->size);
+	}
+#endif
+	free(issue->sections);
+	free(issue);
+}
@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: 2026 Giovanni Dante Grazioli <deroad@kumo.xn--q9jyb4c>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef R2DEC_ISSUE_H
+#define R2DEC_ISSUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Binary container of the issue data (pddi <file>), the compact alternative
+ * to the issue json read by r2dec-standalone.
+ * The file starts with the magic and the version (le32), followed by the
+ * sections: name size (varint), name, payload size (varint) and payload.
+ * Each payload is one value (see ISSUE_TAG_*) whose strings and object keys
+ * are indexes (varint) into the last section, ISSUE_STRINGS, which holds the
+ * count and then each string as size (varint) and utf-8 bytes.
+ * Integers are varints, thus addresses take from 1 to 10 bytes.
+ */
+#define ISSUE_MAGIC   "R2DECISS"
+#define ISSUE_VERSION 1
+#define ISSUE_STRINGS ".strings"
+
+#define ISSUE_TAG_NULL   0
+#define ISSUE_TAG_FALSE  1
+#define ISSUE_TAG_TRUE   2
+#define ISSUE_TAG_UINT   3 // varint
+#define ISSUE_TAG_NINT   4 // varint of the absolute value
+#define ISSUE_TAG_DOUBLE 5 // le64
+#define ISSUE_TAG_STRING 6 // varint string index
+#define ISSUE_TAG_ARRAY  7 // values until ISSUE_TAG_END
+#define ISSUE_TAG_OBJECT 8 // key string index and value until ISSUE_TAG_END
+#define ISSUE_TAG_END    9
+
+typedef struct issue_writer_s issue_writer_t;
+
+typedef struct issue_section_s {
+	const char *name; // not NUL terminated
+	uint32_t name_size;
+	uint8_t *data;
+	size_t size;
+} issue_section_t;
+
+typedef struct issue_s {
+	uint8_t *map;
+	size_t size;
+	issue_section_t *sections;
+	uint32_t n_sections;
+	const issue_section_t *strings;
+	uint32_t n_strings;
+} issue_t;
+
+issue_writer_t *issue_create(const char *file);
+int issue_json(issue_writer_t *writer, const char *name, const char *json, size_t size, int merge);
+int issue_string(issue_writer_t *writer, const char *name, const char *str, size_t size);
+int issue_pack(issue_writer_t *writer, const char *json, size_t size);
+int issue_close(issue_writer_t *writer, uint64_t *bytes);
+
+issue_t *issue_map(const char *file);
+void issue_unmap(issue_t *issue);
+const uint8_t *issue_varint(const uint8_t *p, const uint8_t *end, uint64_t *value);
+
+#endif /* R2DEC_ISSUE_H */
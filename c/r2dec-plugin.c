@@ -7,13 +7,34 @@
 #include <r_core.h>
 
 #include "r2dec.h"
+#include "trace.h"
+#include "issue.h"
 
 typedef struct exec_context_t {
 	RCore *core;
 	void *bed;
 	JSValue shared;
+	RList *config_stack;
+	r2dec_t *dec; // kept alive between runs
+	struct function_graph_t *graph; // last collected graph, valid for one run
+	ut64 graph_at;
+	struct export_writer_t *exporter; // pddf --export, valid for one run
+	struct prefetcher_t *prefetcher; // pddf data prefetch, valid for one run
+	RThreadLock *core_lock; // the core is shared with the prefetch thread
+	char *vars; // afvj of vars_at, taken from the prefetcher
+	ut64 vars_at;
+	char *sample_file; // pddP, kept when the runtime is recreated
+	ut32 sample_hz;
+	trace_writer_t *trace; // pddT, records the bridge traffic
+	issue_writer_t *issue; // pddi <file>, valid for one run
+	const char *arg_file; // pddi <file>, appended as it is to process.args
 } ExecContext;
 
+typedef struct config_saved_t {
+	char *name;
+	char *value;
+} ConfigSaved;
+
 #undef R_API
 #define R_API static
 #undef R_IPI
@@ -22,6 +43,33 @@ typedef struct exec_context_t {
 #define SETDESC(x, y)    r_config_node_desc(x, y)
 #define SETPREF(x, y, z) SETDESC(r_config_set(cfg, x, y), z)
 
+/**
+ * Natives and the prefetch thread touch the core only between core_enter
+ * and core_leave: the pdd task leaves the cons sleep (thus no other r2 task
+ * runs) and the lock keeps the two threads apart; the bed is the one of the
+ * pdd task, handed over by the lock.
+ */
+static RCore *core_enter(ExecContext *ectx) {
+	r_th_lock_enter(ectx->core_lock);
+	r_cons_sleep_end(ectx->core->cons, ectx->bed);
+	return ectx->core;
+}
+
+static void core_leave(ExecContext *ectx) {
+	ectx->bed = r_cons_sleep_begin(ectx->core->cons);
+	r_th_lock_leave(ectx->core_lock);
+}
+
+/**
+ * Records a string request/response of the bridge when pddT is active.
+ */
+static void trace_string(ExecContext *ectx, ut8 kind, const char *request, const char *response) {
+	if (ectx->trace) {
+		response = response ? response : "";
+		trace_write(ectx->trace, kind, request, strlen(request), response, strlen(response));
+	}
+}
+
 static JSValue js_command(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
 	if (argc != 1) {
 		return JS_EXCEPTION;
@@ -33,49 +81,1737 @@ static JSValue js_command(JSContext *ctx, JSValueConst jsThis, int argc, JSValue
 	}
 
 	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
-	RCore *core = ectx->core;
-	r_cons_sleep_end(core->cons, ectx->bed);
-
+	RCore *core = core_enter(ectx);
 	char *output = r_core_cmd_str(core, command);
+	core_leave(ectx);
+	trace_string(ectx, TRACE_COMMAND, command, output);
+
 	JS_FreeCString(ctx, command);
 	JSValue result = JS_NewString(ctx, output ? output : "");
 	free(output);
+	return result;
+}
 
-	ectx->bed = r_cons_sleep_begin(core->cons);
+#define R2DEC_READ_MAX (1024 * 1024)
+
+/**
+ * radare2.read(address, length) returns an ArrayBuffer filled via r_io_read_at;
+ * the address is a hex string or a BigInt. null is returned on failure.
+ */
+static JSValue js_read(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 2) {
+		return JS_ThrowTypeError(ctx, "read expects (address, length)");
+	}
+
+	ut64 addr = 0;
+	if (JS_IsString(argv[0])) {
+		const char *saddr = JS_ToCString(ctx, argv[0]);
+		if (!saddr) {
+			return JS_EXCEPTION;
+		}
+		addr = strtoull(saddr, NULL, 16);
+		JS_FreeCString(ctx, saddr);
+	} else if (JS_ToBigInt64(ctx, (int64_t *)&addr, argv[0])) {
+		return JS_EXCEPTION;
+	}
+
+	uint32_t length = 0;
+	if (JS_ToUint32(ctx, &length, argv[1])) {
+		return JS_EXCEPTION;
+	} else if (length < 1 || length > R2DEC_READ_MAX) {
+		return JS_ThrowRangeError(ctx, "read length must be between 1 and %d", R2DEC_READ_MAX);
+	}
+
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	ut8 *buffer = malloc(length);
+	if (!buffer) {
+		return JS_ThrowOutOfMemory(ctx);
+	}
+
+	JSValue result = JS_NULL;
+	RCore *core = core_enter(ectx);
+	bool ok = r_io_read_at(core->io, addr, buffer, length);
+	core_leave(ectx);
+	if (ok) {
+		result = JS_NewArrayBufferCopy(ctx, buffer, length);
+	}
+	if (ectx->trace) {
+		char request[64];
+		int size = snprintf(request, sizeof(request), "0x%" PFMT64x " %u", addr, length);
+		trace_write(ectx->trace, TRACE_READ, request, size, (const char *)buffer, ok ? length : 0);
+	}
+	free(buffer);
+	return result;
+}
+
+typedef bool (*MetadataCallback)(RCore *core, ut64 addr, const char *text);
+
+static bool metadata_comment(RCore *core, ut64 addr, const char *text) {
+	return r_meta_set_string(core->anal, R_META_TYPE_COMMENT, addr, text);
+}
+
+/**
+ * text is "file:line code", like the argument of CL; the address line
+ * keeps only the file and the line.
+ */
+static bool metadata_codeline(RCore *core, ut64 addr, const char *text) {
+	const char *colon = strchr(text, ':');
+	if (!colon || colon == text) {
+		return false;
+	}
+	char *file = r_str_ndup(text, colon - text);
+	if (!file) {
+		return false;
+	}
+	bool ok = r_bin_addrline_add(core->bin, addr, file, atoi(colon + 1), 0);
+	free(file);
+	return ok;
+}
+
+/**
+ * Applies a batch of [address, text] pairs, where the address is an hex string.
+ */
+static JSValue js_metadata_apply(JSContext *ctx, JSValueConst list, MetadataCallback apply) {
+	JSValue jslen = JS_GetPropertyStr(ctx, list, "length");
+	uint32_t length = 0;
+	if (JS_ToUint32(ctx, &length, jslen)) {
+		JS_FreeValue(ctx, jslen);
+		return JS_EXCEPTION;
+	}
+	JS_FreeValue(ctx, jslen);
+
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	RCore *core = core_enter(ectx);
+
+	JSValue result = JS_UNDEFINED;
+	for (uint32_t i = 0; i < length; ++i) {
+		JSValue pair = JS_GetPropertyUint32(ctx, list, i);
+		JSValue jsaddr = JS_GetPropertyUint32(ctx, pair, 0);
+		JSValue jstext = JS_GetPropertyUint32(ctx, pair, 1);
+		const char *addr = JS_ToCString(ctx, jsaddr);
+		const char *text = JS_ToCString(ctx, jstext);
+		if (addr && text) {
+			apply(core, strtoull(addr, NULL, 16), text);
+		}
+		JS_FreeCString(ctx, addr);
+		JS_FreeCString(ctx, text);
+		JS_FreeValue(ctx, jstext);
+		JS_FreeValue(ctx, jsaddr);
+		JS_FreeValue(ctx, pair);
+		if (!addr || !text) {
+			result = JS_EXCEPTION;
+			break;
+		}
+	}
+
+	core_leave(ectx);
+	return result;
+}
+
+static JSValue js_comments(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 1 || !JS_IsArray(ctx, argv[0])) {
+		return JS_ThrowTypeError(ctx, "comments expects ([[addr, text], ...])");
+	}
+	return js_metadata_apply(ctx, argv[0], metadata_comment);
+}
+
+static JSValue js_codelines(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 1 || !JS_IsArray(ctx, argv[0])) {
+		return JS_ThrowTypeError(ctx, "codelines expects ([[addr, text], ...])");
+	}
+	return js_metadata_apply(ctx, argv[0], metadata_codeline);
+}
+
+static void config_saved_free(ConfigSaved *saved) {
+	if (!saved) {
+		return;
+	}
+	free(saved->name);
+	free(saved->value);
+	free(saved);
+}
+
+/**
+ * Restores the values of the last pushed config frame.
+ */
+static bool config_pop(ExecContext *ectx) {
+	RList *frame = (RList *)r_list_pop(ectx->config_stack);
+	if (!frame) {
+		return false;
+	}
+	RListIter *it;
+	ConfigSaved *saved;
+	r_list_foreach (frame, it, saved) {
+		r_config_set(ectx->core->config, saved->name, saved->value);
+	}
+	r_list_free(frame);
+	return true;
+}
+
+/**
+ * radare2.config.get(name) returns the value as string.
+ * radare2.config.get([name, ...]) returns an object with all the values.
+ * unknown variables are returned as empty strings.
+ */
+static JSValue js_config_get(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 1) {
+		return JS_EXCEPTION;
+	}
+
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	RConfig *cfg = ectx->core->config;
+	if (JS_IsString(argv[0])) {
+		const char *name = JS_ToCString(ctx, argv[0]);
+		if (!name) {
+			return JS_EXCEPTION;
+		}
+		core_enter(ectx);
+		const char *value = r_config_get(cfg, name);
+		JSValue result = JS_NewString(ctx, value ? value : "");
+		trace_string(ectx, TRACE_CONFIG, name, value);
+		core_leave(ectx);
+		JS_FreeCString(ctx, name);
+		return result;
+	} else if (!JS_IsArray(ctx, argv[0])) {
+		return JS_EXCEPTION;
+	}
+
+	JSValue jslen = JS_GetPropertyStr(ctx, argv[0], "length");
+	uint32_t length = 0;
+	if (JS_ToUint32(ctx, &length, jslen)) {
+		JS_FreeValue(ctx, jslen);
+		return JS_EXCEPTION;
+	}
+	JS_FreeValue(ctx, jslen);
+
+	JSValue result = JS_NewObject(ctx);
+	for (uint32_t i = 0; i < length; ++i) {
+		JSValue jsname = JS_GetPropertyUint32(ctx, argv[0], i);
+		const char *name = JS_ToCString(ctx, jsname);
+		JS_FreeValue(ctx, jsname);
+		if (!name) {
+			JS_FreeValue(ctx, result);
+			return JS_EXCEPTION;
+		}
+		core_enter(ectx);
+		const char *value = r_config_get(cfg, name);
+		JS_SetPropertyStr(ctx, result, name, JS_NewString(ctx, value ? value : ""));
+		trace_string(ectx, TRACE_CONFIG, name, value);
+		core_leave(ectx);
+		JS_FreeCString(ctx, name);
+	}
+	return result;
+}
+
+/**
+ * radare2.config.push([[name, value], ...]) saves the current values
+ * and applies the overrides; radare2.config.pop() restores them.
+ */
+static JSValue js_config_push(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 1 || !JS_IsArray(ctx, argv[0])) {
+		return JS_EXCEPTION;
+	}
+
+	JSValue jslen = JS_GetPropertyStr(ctx, argv[0], "length");
+	uint32_t length = 0;
+	if (JS_ToUint32(ctx, &length, jslen)) {
+		JS_FreeValue(ctx, jslen);
+		return JS_EXCEPTION;
+	}
+	JS_FreeValue(ctx, jslen);
+
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	RConfig *cfg = ectx->core->config;
+	RList *frame = r_list_newf((RListFree)config_saved_free);
+	if (!frame || !r_list_append(ectx->config_stack, frame)) {
+		r_list_free(frame);
+		return JS_ThrowInternalError(ctx, "Cannot allocate config frame");
+	}
+
+	JSValue result = JS_UNDEFINED;
+	core_enter(ectx);
+	for (uint32_t i = 0; i < length; ++i) {
+		JSValue pair = JS_GetPropertyUint32(ctx, argv[0], i);
+		JSValue jsname = JS_GetPropertyUint32(ctx, pair, 0);
+		JSValue jsvalue = JS_GetPropertyUint32(ctx, pair, 1);
+		const char *name = JS_ToCString(ctx, jsname);
+		const char *value = JS_ToCString(ctx, jsvalue);
+		const char *old = name ? r_config_get(cfg, name) : NULL;
+		if (old && value) {
+			ConfigSaved *saved = R_NEW0(ConfigSaved);
+			if (saved) {
+				saved->name = strdup(name);
+				saved->value = strdup(old);
+				r_list_append(frame, saved);
+				r_config_set(cfg, name, value);
+			}
+		}
+		JS_FreeCString(ctx, name);
+		JS_FreeCString(ctx, value);
+		JS_FreeValue(ctx, jsvalue);
+		JS_FreeValue(ctx, jsname);
+		JS_FreeValue(ctx, pair);
+		if (!name || !value) {
+			result = JS_EXCEPTION;
+			break;
+		}
+	}
+	core_leave(ectx);
 	return result;
 }
 
+static JSValue js_config_pop(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	core_enter(ectx);
+	bool popped = config_pop(ectx);
+	core_leave(ectx);
+	return JS_NewBool(ctx, popped);
+}
+
+typedef struct graph_ref_t {
+	ut64 addr;
+	const char *type;
+} GraphRef;
+
+typedef struct graph_op_t {
+	ut64 addr;
+	ut64 jump;
+	ut64 fail;
+	ut64 ptr;
+	int size;
+	const char *type;
+	char *opcode;
+	char *disasm;
+	char *comment;
+	GraphRef *refs;
+	ut32 n_refs;
+	GraphRef *xrefs;
+	ut32 n_xrefs;
+} GraphOp;
+
+typedef struct graph_block_t {
+	ut64 addr;
+	ut64 size;
+	ut64 jump;
+	ut64 fail;
+	GraphOp *ops;
+	ut32 n_ops;
+} GraphBlock;
+
+typedef struct function_graph_t {
+	char *name;
+	ut64 addr;
+	ut64 size;
+	ut32 ninstr;
+	GraphBlock *blocks;
+	ut32 n_blocks;
+} FunctionGraph;
+
+static void graph_free(FunctionGraph *graph) {
+	if (!graph) {
+		return;
+	}
+	for (ut32 i = 0; i < graph->n_blocks; ++i) {
+		GraphBlock *block = &graph->blocks[i];
+		for (ut32 j = 0; j < block->n_ops; ++j) {
+			GraphOp *op = &block->ops[j];
+			free(op->opcode);
+			free(op->disasm);
+			free(op->comment);
+			free(op->refs);
+			free(op->xrefs);
+		}
+		free(block->ops);
+	}
+	free(graph->blocks);
+	free(graph->name);
+	free(graph);
+}
+
+static int graph_block_cmp(const void *a, const void *b) {
+	const RAnalBlock *ba = *(const RAnalBlock **)a;
+	const RAnalBlock *bb = *(const RAnalBlock **)b;
+	return ba->addr < bb->addr ? -1 : (ba->addr > bb->addr ? 1 : 0);
+}
+
+static GraphRef *graph_refs(RVecAnalRef *vec, bool is_xref, ut32 *count) {
+	*count = 0;
+	if (!vec || RVecAnalRef_length(vec) < 1) {
+		RVecAnalRef_free(vec);
+		return NULL;
+	}
+	GraphRef *refs = R_NEWS0(GraphRef, RVecAnalRef_length(vec));
+	if (refs) {
+		RAnalRef *ref;
+		R_VEC_FOREACH (vec, ref) {
+			refs[*count].addr = is_xref ? ref->at : ref->addr;
+			refs[*count].type = r_anal_ref_type_tostring(ref->type);
+			*count += 1;
+		}
+	}
+	RVecAnalRef_free(vec);
+	return refs;
+}
+
+static bool graph_collect_block(RCore *core, RAnalBlock *bb, GraphBlock *block) {
+	block->addr = bb->addr;
+	block->size = bb->size;
+	block->jump = bb->jump;
+	block->fail = bb->fail;
+	if (bb->size < 1) {
+		return true;
+	}
+
+	ut8 *bytes = malloc(bb->size);
+	// worst case is one op per byte.
+	block->ops = R_NEWS0(GraphOp, bb->size);
+	if (!bytes || !block->ops) {
+		free(bytes);
+		return false;
+	}
+	r_io_read_at(core->io, bb->addr, bytes, (int)bb->size);
+
+	RAnalOp aop;
+	for (ut64 offset = 0; offset < bb->size;) {
+		GraphOp *op = &block->ops[block->n_ops++];
+		ut64 addr = bb->addr + offset;
+		r_anal_op_init(&aop);
+		int size = r_anal_op(core->anal, &aop, addr, bytes + offset, (int)(bb->size - offset), R_ARCH_OP_MASK_BASIC | R_ARCH_OP_MASK_DISASM);
+		op->addr = addr;
+		op->size = size > 0 ? aop.size : 1;
+		op->jump = aop.jump;
+		op->fail = aop.fail;
+		op->ptr = (ut64)aop.ptr;
+		op->type = r_anal_optype_tostring(aop.type);
+		op->opcode = strdup(size > 0 && aop.mnemonic ? aop.mnemonic : "invalid");
+		r_anal_op_fini(&aop);
+
+		const char *comment = r_meta_get_string(core->anal, R_META_TYPE_COMMENT, addr);
+		if (comment) {
+			op->comment = r_base64_encode_dyn((const ut8 *)comment, (int)strlen(comment));
+		}
+		op->refs = graph_refs(r_anal_refs_get(core->anal, addr), false, &op->n_refs);
+		op->xrefs = graph_refs(r_anal_xrefs_get(core->anal, addr), true, &op->n_xrefs);
+		offset += op->size;
+	}
+	free(bytes);
+
+	// the enriched disassembly (flags, variables, etc..) is only produced
+	// by the disassembler, thus is requested once per basic block.
+	char *disasm = r_core_cmd_strf(core, "pi %u @ 0x%" PFMT64x, block->n_ops, bb->addr);
+	char *line = disasm;
+	for (ut32 i = 0; line && i < block->n_ops; ++i) {
+		char *end = strchr(line, '\n');
+		if (end) {
+			*end = 0;
+		}
+		block->ops[i].disasm = strdup(line);
+		line = end ? end + 1 : NULL;
+	}
+	free(disasm);
+	return true;
+}
+
+/**
+ * Collects the function graph (same data as agj) directly from RAnal.
+ */
+static FunctionGraph *graph_collect(RCore *core, ut64 addr) {
+	RAnalFunction *fcn = r_anal_get_fcn_in(core->anal, addr, 0);
+	if (!fcn) {
+		return NULL;
+	}
+
+	FunctionGraph *graph = R_NEW0(FunctionGraph);
+	int n_blocks = r_list_length(fcn->bbs);
+	RAnalBlock **sorted = n_blocks > 0 ? R_NEWS0(RAnalBlock *, n_blocks) : NULL;
+	if (!graph || (n_blocks > 0 && !sorted)) {
+		free(graph);
+		free(sorted);
+		return NULL;
+	}
+
+	RListIter *it;
+	RAnalBlock *bb;
+	int i = 0;
+	r_list_foreach (fcn->bbs, it, bb) {
+		sorted[i++] = bb;
+	}
+	if (n_blocks > 0) {
+		qsort(sorted, n_blocks, sizeof(RAnalBlock *), graph_block_cmp);
+	}
+
+	graph->name = strdup(fcn->name);
+	graph->addr = fcn->addr;
+	graph->size = r_anal_function_linear_size(fcn);
+	graph->blocks = n_blocks > 0 ? R_NEWS0(GraphBlock, n_blocks) : NULL;
+	for (i = 0; graph->blocks && i < n_blocks; ++i) {
+		if (!graph_collect_block(core, sorted[i], &graph->blocks[i])) {
+			break;
+		}
+		graph->ninstr += graph->blocks[i].n_ops;
+		graph->n_blocks++;
+	}
+	free(sorted);
+	return graph;
+}
+
+#define PREFETCH_DEPTH 4
+
+/* data of a function fetched ahead by the prefetch thread */
+typedef struct prefetch_entry_t {
+	ut32 index; // position in the addresses list
+	ut64 addr;
+	FunctionGraph *graph;
+	char *vars; // afvj
+} PrefetchEntry;
+
+/**
+ * pddf pipeline: while javascript decompiles a function, this thread
+ * collects the graph and variables of the next ones (up to PREFETCH_DEPTH).
+ */
+typedef struct prefetcher_t {
+	ExecContext *ectx;
+	RThread *thread;
+	RThreadLock *lock;
+	RThreadCond *cond;
+	ut64 *addrs;
+	ut32 n_addrs;
+	ut32 fetched; // next index to fetch
+	ut32 taken; // next index expected by javascript
+	PrefetchEntry ring[PREFETCH_DEPTH];
+	ut32 head;
+	ut32 count;
+	bool stop;
+} Prefetcher;
+
+static void prefetch_entry_fini(PrefetchEntry *entry) {
+	graph_free(entry->graph);
+	free(entry->vars);
+	memset(entry, 0, sizeof(PrefetchEntry));
+}
+
+static RThreadFunctionRet prefetch_thread(RThread *th) {
+	Prefetcher *pf = (Prefetcher *)th->user;
+	ExecContext *ectx = pf->ectx;
+	r_th_lock_enter(pf->lock);
+	for (;;) {
+		while (!pf->stop && pf->fetched < pf->n_addrs && pf->count >= PREFETCH_DEPTH) {
+			r_th_cond_wait(pf->cond, pf->lock);
+		}
+		if (pf->stop || pf->fetched >= pf->n_addrs) {
+			break;
+		}
+		ut32 index = pf->fetched;
+		ut64 addr = pf->addrs[index];
+		r_th_lock_leave(pf->lock);
+
+		RCore *core = core_enter(ectx);
+		FunctionGraph *graph = graph_collect(core, addr);
+		char *vars = r_core_cmd_strf(core, "afvj @ 0x%" PFMT64x, addr);
+		core_leave(ectx);
+
+		r_th_lock_enter(pf->lock);
+		PrefetchEntry *entry = &pf->ring[(pf->head + pf->count) % PREFETCH_DEPTH];
+		entry->index = index;
+		entry->addr = addr;
+		entry->graph = graph;
+		entry->vars = vars;
+		pf->count++;
+		pf->fetched++;
+		r_th_cond_signal_all(pf->cond);
+	}
+	pf->stop = true;
+	r_th_cond_signal_all(pf->cond);
+	r_th_lock_leave(pf->lock);
+	return R_TH_STOP;
+}
+
+static void prefetch_stop(ExecContext *ectx) {
+	Prefetcher *pf = ectx->prefetcher;
+	if (!pf) {
+		return;
+	}
+	ectx->prefetcher = NULL;
+	r_th_lock_enter(pf->lock);
+	pf->stop = true;
+	r_th_cond_signal_all(pf->cond);
+	r_th_lock_leave(pf->lock);
+	r_th_wait(pf->thread);
+	r_th_free(pf->thread);
+	for (ut32 i = 0; i < PREFETCH_DEPTH; ++i) {
+		prefetch_entry_fini(&pf->ring[i]);
+	}
+	r_th_cond_free(pf->cond);
+	r_th_lock_free(pf->lock);
+	free(pf->addrs);
+	free(pf);
+}
+
+static bool prefetch_start(ExecContext *ectx, ut64 *addrs, ut32 n_addrs) {
+	prefetch_stop(ectx);
+	Prefetcher *pf = R_NEW0(Prefetcher);
+	if (!pf) {
+		free(addrs);
+		return false;
+	}
+	pf->ectx = ectx;
+	pf->addrs = addrs;
+	pf->n_addrs = n_addrs;
+	pf->lock = r_th_lock_new(false);
+	pf->cond = r_th_cond_new();
+	if (pf->lock && pf->cond) {
+		pf->thread = r_th_new(prefetch_thread, pf, 0);
+	}
+	if (!pf->thread || !r_th_start(pf->thread)) {
+		r_th_free(pf->thread);
+		r_th_cond_free(pf->cond);
+		r_th_lock_free(pf->lock);
+		free(pf->addrs);
+		free(pf);
+		return false;
+	}
+	ectx->prefetcher = pf;
+	return true;
+}
+
+/**
+ * Moves the prefetched data of addr (if it is one of the listed functions)
+ * into ectx->graph and ectx->vars; the entries before it are dropped.
+ * Must be called without holding the core lock, since it may wait for the
+ * prefetch thread.
+ */
+static void prefetch_take(ExecContext *ectx, ut64 addr) {
+	Prefetcher *pf = ectx->prefetcher;
+	if (!pf) {
+		return;
+	}
+	r_th_lock_enter(pf->lock);
+	ut32 index = pf->taken;
+	while (index < pf->n_addrs && pf->addrs[index] != addr) {
+		index++;
+	}
+	while (index < pf->n_addrs) {
+		if (pf->count > 0 && pf->ring[pf->head].index <= index) {
+			PrefetchEntry *entry = &pf->ring[pf->head];
+			pf->head = (pf->head + 1) % PREFETCH_DEPTH;
+			pf->count--;
+			r_th_cond_signal_all(pf->cond);
+			if (entry->index < index) {
+				prefetch_entry_fini(entry);
+				continue;
+			}
+			graph_free(ectx->graph);
+			free(ectx->vars);
+			ectx->graph = entry->graph;
+			ectx->graph_at = addr;
+			ectx->vars = entry->vars;
+			ectx->vars_at = addr;
+			entry->graph = NULL;
+			entry->vars = NULL;
+			pf->taken = index + 1;
+			break;
+		} else if (pf->stop) {
+			break;
+		}
+		r_th_cond_wait(pf->cond, pf->lock);
+	}
+	r_th_lock_leave(pf->lock);
+}
+
+/**
+ * Returns the graph of the function at addr; it is collected once per run
+ * since both radare2.fingerprint and radare2.functionGraph need it.
+ */
+static FunctionGraph *graph_fetch(ExecContext *ectx, ut64 addr) {
+	if (ectx->graph && ectx->graph_at == addr) {
+		return ectx->graph;
+	}
+	prefetch_take(ectx, addr);
+	if (ectx->graph && ectx->graph_at == addr) {
+		return ectx->graph;
+	}
+	graph_free(ectx->graph);
+	RCore *core = core_enter(ectx);
+	ectx->graph = graph_collect(core, addr);
+	ectx->graph_at = addr;
+	core_leave(ectx);
+	return ectx->graph;
+}
+
+/**
+ * Reads the optional hex address argument, defaulting to the current seek.
+ */
+static bool js_address_arg(JSContext *ctx, ExecContext *ectx, int argc, JSValueConst *argv, ut64 *addr) {
+	if (argc > 0 && JS_IsString(argv[0])) {
+		const char *saddr = JS_ToCString(ctx, argv[0]);
+		if (!saddr) {
+			return false;
+		}
+		*addr = strtoull(saddr, NULL, 16);
+		JS_FreeCString(ctx, saddr);
+		return true;
+	}
+	*addr = core_enter(ectx)->addr;
+	core_leave(ectx);
+	return true;
+}
+
+#define FNV64_OFFSET 0xcbf29ce484222325ull
+#define FNV64_PRIME  0x100000001b3ull
+
+static ut64 fnv1a(ut64 hash, const void *data, size_t size) {
+	const ut8 *bytes = (const ut8 *)data;
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= FNV64_PRIME;
+	}
+	return hash;
+}
+
+static ut64 fnv1a_str(ut64 hash, const char *str) {
+	// the terminator is hashed too, so "ab","c" differs from "a","bc"
+	return str ? fnv1a(hash, str, strlen(str) + 1) : fnv1a(hash, "", 1);
+}
+
+static ut64 fnv1a_u64(ut64 hash, ut64 value) {
+	return fnv1a(hash, &value, sizeof(value));
+}
+
+static ut64 graph_fingerprint(const FunctionGraph *graph) {
+	ut64 hash = fnv1a_str(FNV64_OFFSET, graph->name);
+	hash = fnv1a_u64(hash, graph->addr);
+	hash = fnv1a_u64(hash, graph->size);
+	for (ut32 i = 0; i < graph->n_blocks; ++i) {
+		const GraphBlock *block = &graph->blocks[i];
+		hash = fnv1a_u64(hash, block->addr);
+		hash = fnv1a_u64(hash, block->size);
+		hash = fnv1a_u64(hash, block->jump);
+		hash = fnv1a_u64(hash, block->fail);
+		for (ut32 j = 0; j < block->n_ops; ++j) {
+			const GraphOp *op = &block->ops[j];
+			hash = fnv1a_u64(hash, op->ptr);
+			hash = fnv1a_str(hash, op->disasm);
+			hash = fnv1a_str(hash, op->comment);
+			for (ut32 k = 0; k < op->n_refs; ++k) {
+				hash = fnv1a_u64(hash, op->refs[k].addr);
+			}
+			for (ut32 k = 0; k < op->n_xrefs; ++k) {
+				hash = fnv1a_u64(hash, op->xrefs[k].addr);
+			}
+		}
+	}
+	return hash;
+}
+
+static void body_rebased(RStrBuf *sb, ut64 value, const FunctionGraph *graph) {
+	// addresses inside the function are written relative to its entry
+	if (value >= graph->addr && value < graph->addr + graph->size) {
+		r_strbuf_appendf(sb, "@%" PFMT64x, value - graph->addr);
+	} else {
+		r_strbuf_appendf(sb, "%" PFMT64x, value);
+	}
+}
+
+static void body_opcode(RStrBuf *sb, const char *opcode, const FunctionGraph *graph) {
+	const char *p = opcode ? opcode : "";
+	const char *hex;
+	while ((hex = strstr(p, "0x"))) {
+		char *end = NULL;
+		ut64 value = strtoull(hex + 2, &end, 16);
+		r_strbuf_append_n(sb, p, hex - p);
+		if (end == hex + 2) {
+			r_strbuf_append_n(sb, hex, 2);
+			p = hex + 2;
+			continue;
+		}
+		r_strbuf_append(sb, "0x");
+		body_rebased(sb, value, graph);
+		p = end;
+	}
+	r_strbuf_append(sb, p);
+}
+
+/**
+ * Text of the instruction stream with the addresses rebased to the entry,
+ * thus identical copies of a function at different addresses are equal;
+ * one line per block and per instruction, the opcode is the last field.
+ * The comments, the variables (afvj) and the signature (afs, without the
+ * function name) are part of it, since a copy prints the ones of the first.
+ */
+static char *graph_body(const FunctionGraph *graph, const char *vars, const char *signature) {
+	RStrBuf *sb = r_strbuf_new(NULL);
+	if (!sb) {
+		return NULL;
+	}
+	r_strbuf_appendf(sb, "%" PFMT64x "\n", graph->size);
+	for (ut32 i = 0; i < graph->n_blocks; ++i) {
+		const GraphBlock *block = &graph->blocks[i];
+		r_strbuf_append(sb, "b ");
+		body_rebased(sb, block->addr, graph);
+		r_strbuf_appendf(sb, " %" PFMT64x " ", block->size);
+		body_rebased(sb, block->jump, graph);
+		r_strbuf_append(sb, " ");
+		body_rebased(sb, block->fail, graph);
+		r_strbuf_append(sb, "\n");
+		for (ut32 j = 0; j < block->n_ops; ++j) {
+			const GraphOp *op = &block->ops[j];
+			body_rebased(sb, op->addr, graph);
+			r_strbuf_appendf(sb, " %d %s ", op->size, op->type ? op->type : "");
+			body_rebased(sb, op->ptr, graph);
+			r_strbuf_append(sb, " ");
+			body_opcode(sb, op->opcode, graph);
+			r_strbuf_append(sb, "\n");
+			if (R_STR_ISNOTEMPTY(op->comment)) {
+				r_strbuf_appendf(sb, "c %s\n", op->comment);
+			}
+		}
+	}
+	r_strbuf_appendf(sb, "v %s\ns %s\n", vars ? vars : "", signature ? signature : "");
+	return r_strbuf_drain(sb);
+}
+
+static JSValue graph_refs_to_js(JSContext *ctx, const GraphRef *refs, ut32 count) {
+	JSValue array = JS_NewArray(ctx);
+	for (ut32 i = 0; i < count; ++i) {
+		JSValue ref = JS_NewObject(ctx);
+		JS_SetPropertyStr(ctx, ref, "addr", JS_NewBigUint64(ctx, refs[i].addr));
+		JS_SetPropertyStr(ctx, ref, "type", JS_NewString(ctx, refs[i].type ? refs[i].type : ""));
+		JS_SetPropertyUint32(ctx, array, i, ref);
+	}
+	return array;
+}
+
+/**
+ * Converts the graph to the same object layout produced by agj;
+ * integers are returned as BigInt.
+ */
+static JSValue graph_to_js(JSContext *ctx, const FunctionGraph *graph) {
+	JSValue array = JS_NewArray(ctx);
+	if (!graph) {
+		return array;
+	}
+
+	JSValue fcn = JS_NewObject(ctx);
+	JS_SetPropertyStr(ctx, fcn, "name", JS_NewString(ctx, graph->name));
+	JS_SetPropertyStr(ctx, fcn, "addr", JS_NewBigUint64(ctx, graph->addr));
+	JS_SetPropertyStr(ctx, fcn, "size", JS_NewBigUint64(ctx, graph->size));
+	JS_SetPropertyStr(ctx, fcn, "ninstr", JS_NewBigUint64(ctx, graph->ninstr));
+
+	JSValue blocks = JS_NewArray(ctx);
+	for (ut32 i = 0; i < graph->n_blocks; ++i) {
+		const GraphBlock *block = &graph->blocks[i];
+		JSValue jsblock = JS_NewObject(ctx);
+		JS_SetPropertyStr(ctx, jsblock, "addr", JS_NewBigUint64(ctx, block->addr));
+		JS_SetPropertyStr(ctx, jsblock, "size", JS_NewBigUint64(ctx, block->size));
+		if (block->jump != UT64_MAX) {
+			JS_SetPropertyStr(ctx, jsblock, "jump", JS_NewBigUint64(ctx, block->jump));
+		}
+		if (block->fail != UT64_MAX) {
+			JS_SetPropertyStr(ctx, jsblock, "fail", JS_NewBigUint64(ctx, block->fail));
+		}
+
+		JSValue ops = JS_NewArray(ctx);
+		for (ut32 j = 0; j < block->n_ops; ++j) {
+			const GraphOp *op = &block->ops[j];
+			JSValue jsop = JS_NewObject(ctx);
+			JS_SetPropertyStr(ctx, jsop, "addr", JS_NewBigUint64(ctx, op->addr));
+			JS_SetPropertyStr(ctx, jsop, "size", JS_NewBigUint64(ctx, op->size));
+			JS_SetPropertyStr(ctx, jsop, "type", JS_NewString(ctx, op->type ? op->type : "null"));
+			JS_SetPropertyStr(ctx, jsop, "opcode", JS_NewString(ctx, op->opcode ? op->opcode : "invalid"));
+			JS_SetPropertyStr(ctx, jsop, "disasm", JS_NewString(ctx, op->disasm ? op->disasm : op->opcode));
+			if (op->jump != UT64_MAX) {
+				JS_SetPropertyStr(ctx, jsop, "jump", JS_NewBigUint64(ctx, op->jump));
+			}
+			if (op->fail != UT64_MAX) {
+				JS_SetPropertyStr(ctx, jsop, "fail", JS_NewBigUint64(ctx, op->fail));
+			}
+			if (op->ptr != UT64_MAX) {
+				JS_SetPropertyStr(ctx, jsop, "ptr", JS_NewBigUint64(ctx, op->ptr));
+			}
+			if (op->comment) {
+				JS_SetPropertyStr(ctx, jsop, "comment", JS_NewString(ctx, op->comment));
+			}
+			if (op->n_refs > 0) {
+				JS_SetPropertyStr(ctx, jsop, "refs", graph_refs_to_js(ctx, op->refs, op->n_refs));
+			}
+			if (op->n_xrefs > 0) {
+				JS_SetPropertyStr(ctx, jsop, "xrefs", graph_refs_to_js(ctx, op->xrefs, op->n_xrefs));
+			}
+			JS_SetPropertyUint32(ctx, ops, j, jsop);
+		}
+		JS_SetPropertyStr(ctx, jsblock, "ops", ops);
+		JS_SetPropertyUint32(ctx, blocks, i, jsblock);
+	}
+	JS_SetPropertyStr(ctx, fcn, "blocks", blocks);
+	JS_SetPropertyUint32(ctx, array, 0, fcn);
+	return array;
+}
+
+static void graph_refs_to_json(PJ *pj, const char *key, const GraphRef *refs, ut32 count) {
+	pj_ka(pj, key);
+	for (ut32 i = 0; i < count; ++i) {
+		pj_o(pj);
+		pj_kn(pj, "addr", refs[i].addr);
+		pj_ks(pj, "type", refs[i].type ? refs[i].type : "");
+		pj_end(pj);
+	}
+	pj_end(pj);
+}
+
+/**
+ * Same layout of graph_to_js, as agj text; used only by pddT.
+ */
+static char *graph_to_json(const FunctionGraph *graph) {
+	PJ *pj = pj_new();
+	if (!pj) {
+		return NULL;
+	}
+	pj_a(pj);
+	if (graph) {
+		pj_o(pj);
+		pj_ks(pj, "name", graph->name);
+		pj_kn(pj, "addr", graph->addr);
+		pj_kn(pj, "size", graph->size);
+		pj_kn(pj, "ninstr", graph->ninstr);
+		pj_ka(pj, "blocks");
+		for (ut32 i = 0; i < graph->n_blocks; ++i) {
+			const GraphBlock *block = &graph->blocks[i];
+			pj_o(pj);
+			pj_kn(pj, "addr", block->addr);
+			pj_kn(pj, "size", block->size);
+			if (block->jump != UT64_MAX) {
+				pj_kn(pj, "jump", block->jump);
+			}
+			if (block->fail != UT64_MAX) {
+				pj_kn(pj, "fail", block->fail);
+			}
+			pj_ka(pj, "ops");
+			for (ut32 j = 0; j < block->n_ops; ++j) {
+				const GraphOp *op = &block->ops[j];
+				pj_o(pj);
+				pj_kn(pj, "addr", op->addr);
+				pj_kn(pj, "size", op->size);
+				pj_ks(pj, "type", op->type ? op->type : "null");
+				pj_ks(pj, "opcode", op->opcode ? op->opcode : "invalid");
+				pj_ks(pj, "disasm", op->disasm ? op->disasm : (op->opcode ? op->opcode : "invalid"));
+				if (op->jump != UT64_MAX) {
+					pj_kn(pj, "jump", op->jump);
+				}
+				if (op->fail != UT64_MAX) {
+					pj_kn(pj, "fail", op->fail);
+				}
+				if (op->ptr != UT64_MAX) {
+					pj_kn(pj, "ptr", op->ptr);
+				}
+				if (op->comment) {
+					pj_ks(pj, "comment", op->comment);
+				}
+				if (op->n_refs > 0) {
+					graph_refs_to_json(pj, "refs", op->refs, op->n_refs);
+				}
+				if (op->n_xrefs > 0) {
+					graph_refs_to_json(pj, "xrefs", op->xrefs, op->n_xrefs);
+				}
+				pj_end(pj);
+			}
+			pj_end(pj);
+			pj_end(pj);
+		}
+		pj_end(pj);
+		pj_end(pj);
+	}
+	pj_end(pj);
+	return pj_drain(pj);
+}
+
+/**
+ * The native getters are recorded as the command used by their javascript
+ * fallback (i.e. agj), since the replay provides only radare2.command.
+ */
+static char *trace_getter(JSContext *ctx, const char *command, int argc, JSValueConst *argv) {
+	if (argc < 1 || !JS_IsString(argv[0])) {
+		return strdup(command);
+	}
+	const char *saddr = JS_ToCString(ctx, argv[0]);
+	char *request = r_str_newf("%s @ %s", command, saddr ? saddr : "");
+	JS_FreeCString(ctx, saddr);
+	return request;
+}
+
+/**
+ * Same of trace_getter for the natives without fallback, which are keyed
+ * only by their optional address.
+ */
+static char *trace_address(JSContext *ctx, int argc, JSValueConst *argv) {
+	if (argc < 1 || !JS_IsString(argv[0])) {
+		return strdup("");
+	}
+	const char *saddr = JS_ToCString(ctx, argv[0]);
+	char *request = strdup(saddr ? saddr : "");
+	JS_FreeCString(ctx, saddr);
+	return request;
+}
+
+/**
+ * radare2.readFile(path) returns the text of a local file (i.e. the list
+ * of pddf --functions) or null when it cannot be read.
+ */
+static JSValue js_read_file(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 1) {
+		return JS_ThrowTypeError(ctx, "readFile expects (path)");
+	}
+	const char *path = JS_ToCString(ctx, argv[0]);
+	if (!path) {
+		return JS_EXCEPTION;
+	}
+	size_t size = 0;
+	char *data = r_file_slurp(path, &size);
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	trace_string(ectx, TRACE_FILE, path, data);
+	JS_FreeCString(ctx, path);
+	JSValue result = data ? JS_NewStringLen(ctx, data, size) : JS_NULL;
+	free(data);
+	return result;
+}
+
+/**
+ * radare2.functionGraph([address]) returns the agj data of the function
+ * at the given hex address (or current seek) without any JSON step.
+ */
+static JSValue js_function_graph(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	ut64 addr = 0;
+	if (!js_address_arg(ctx, ectx, argc, argv, &addr)) {
+		return JS_EXCEPTION;
+	}
+	FunctionGraph *graph = graph_fetch(ectx, addr);
+	if (ectx->trace) {
+		char *request = trace_getter(ctx, "agj", argc, argv);
+		char *json = graph_to_json(graph);
+		trace_string(ectx, TRACE_COMMAND, request, json);
+		free(request);
+		free(json);
+	}
+	return graph_to_js(ctx, graph);
+}
+
+/**
+ * radare2.functionVars([address]) returns the afvj output of the function
+ * at the given hex address (or current seek); prefetched during pddf.
+ */
+static JSValue js_function_vars(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	ut64 addr = 0;
+	if (!js_address_arg(ctx, ectx, argc, argv, &addr)) {
+		return JS_EXCEPTION;
+	}
+	if (!ectx->vars || ectx->vars_at != addr) {
+		prefetch_take(ectx, addr);
+	}
+	char *vars = NULL;
+	if (ectx->vars && ectx->vars_at == addr) {
+		vars = strdup(ectx->vars);
+	} else {
+		RCore *core = core_enter(ectx);
+		vars = r_core_cmd_strf(core, "afvj @ 0x%" PFMT64x, addr);
+		core_leave(ectx);
+	}
+	if (ectx->trace) {
+		char *request = trace_getter(ctx, "afvj", argc, argv);
+		trace_string(ectx, TRACE_COMMAND, request, vars);
+		free(request);
+	}
+	JSValue result = JS_NewString(ctx, vars ? vars : "");
+	free(vars);
+	return result;
+}
+
+/**
+ * radare2.prefetch([address, ...]) starts to fetch in background the data of
+ * the listed functions (hex addresses), in the order they will be decompiled.
+ */
+static JSValue js_prefetch(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 1 || !JS_IsArray(ctx, argv[0])) {
+		return JS_ThrowTypeError(ctx, "prefetch expects ([address, ...])");
+	}
+	JSValue jslen = JS_GetPropertyStr(ctx, argv[0], "length");
+	uint32_t length = 0;
+	if (JS_ToUint32(ctx, &length, jslen)) {
+		JS_FreeValue(ctx, jslen);
+		return JS_EXCEPTION;
+	}
+	JS_FreeValue(ctx, jslen);
+	if (length < 1) {
+		return JS_FALSE;
+	}
+
+	ut64 *addrs = R_NEWS0(ut64, length);
+	if (!addrs) {
+		return JS_ThrowOutOfMemory(ctx);
+	}
+	for (uint32_t i = 0; i < length; ++i) {
+		JSValue jsaddr = JS_GetPropertyUint32(ctx, argv[0], i);
+		const char *saddr = JS_ToCString(ctx, jsaddr);
+		JS_FreeValue(ctx, jsaddr);
+		if (!saddr) {
+			free(addrs);
+			return JS_EXCEPTION;
+		}
+		addrs[i] = strtoull(saddr, NULL, 16);
+		JS_FreeCString(ctx, saddr);
+	}
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	return JS_NewBool(ctx, prefetch_start(ectx, addrs, length));
+}
+
+/**
+ * radare2.fingerprint([address]) returns "0x<fcn addr>:<hash>" where the hash
+ * covers the function graph, variables and signature, or null when there is
+ * no function; used to know if a cached decompilation is still valid.
+ */
+static JSValue js_fingerprint(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	ut64 addr = 0;
+	if (!js_address_arg(ctx, ectx, argc, argv, &addr)) {
+		return JS_EXCEPTION;
+	}
+
+	FunctionGraph *graph = graph_fetch(ectx, addr);
+	char *fingerprint = NULL;
+	if (graph) {
+		ut64 hash = graph_fingerprint(graph);
+		RCore *core = core_enter(ectx);
+		char *vars = r_core_cmd_strf(core, "afvj @ 0x%" PFMT64x, graph->addr);
+		char *signature = r_core_cmd_strf(core, "afs @ 0x%" PFMT64x, graph->addr);
+		core_leave(ectx);
+		hash = fnv1a_str(hash, vars);
+		hash = fnv1a_str(hash, signature);
+		free(vars);
+		free(signature);
+		fingerprint = r_str_newf("0x%" PFMT64x ":%016" PFMT64x, graph->addr, hash);
+	}
+
+	if (ectx->trace) {
+		char *request = trace_address(ctx, argc, argv);
+		trace_string(ectx, TRACE_FINGERPRINT, request, fingerprint);
+		free(request);
+	}
+	JSValue result = fingerprint ? JS_NewString(ctx, fingerprint) : JS_NULL;
+	free(fingerprint);
+	return result;
+}
+
+/**
+ * radare2.bodyHash([address]) returns {hash, size, ninstr, body} of the function
+ * at the given hex address (or current seek), or null when there is no function;
+ * body is the rebased text (see graph_body) to compare the functions with the
+ * same hash.
+ */
+static JSValue js_body_hash(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	ut64 addr = 0;
+	if (!js_address_arg(ctx, ectx, argc, argv, &addr)) {
+		return JS_EXCEPTION;
+	}
+
+	FunctionGraph *graph = graph_fetch(ectx, addr);
+	char *body = NULL;
+	if (graph && graph->ninstr > 0) {
+		RCore *core = core_enter(ectx);
+		char *vars = r_core_cmd_strf(core, "afvj @ 0x%" PFMT64x, graph->addr);
+		char *signature = r_core_cmd_strf(core, "afs @ 0x%" PFMT64x, graph->addr);
+		core_leave(ectx);
+		if (signature && R_STR_ISNOTEMPTY(graph->name)) {
+			signature = r_str_replace(signature, graph->name, "@", 1);
+		}
+		body = graph_body(graph, vars, signature);
+		free(vars);
+		free(signature);
+	}
+	if (!body) {
+		if (ectx->trace) {
+			char *request = trace_address(ctx, argc, argv);
+			trace_string(ectx, TRACE_BODY_HASH, request, NULL);
+			free(request);
+		}
+		return JS_NULL;
+	}
+
+	char hash[32];
+	snprintf(hash, sizeof(hash), "%016" PFMT64x, fnv1a_str(FNV64_OFFSET, body));
+	if (ectx->trace) {
+		char *request = trace_address(ctx, argc, argv);
+		PJ *pj = pj_new();
+		if (pj) {
+			pj_o(pj);
+			pj_ks(pj, "hash", hash);
+			pj_kn(pj, "size", graph->size);
+			pj_kn(pj, "ninstr", graph->ninstr);
+			pj_ks(pj, "body", body);
+			pj_end(pj);
+		}
+		char *json = pj ? pj_drain(pj) : NULL;
+		trace_string(ectx, TRACE_BODY_HASH, request, json);
+		free(request);
+		free(json);
+	}
+	JSValue result = JS_NewObject(ctx);
+	JS_SetPropertyStr(ctx, result, "hash", JS_NewString(ctx, hash));
+	JS_SetPropertyStr(ctx, result, "size", JS_NewInt64(ctx, (int64_t)graph->size));
+	JS_SetPropertyStr(ctx, result, "ninstr", JS_NewUint32(ctx, graph->ninstr));
+	JS_SetPropertyStr(ctx, result, "body", JS_NewString(ctx, body));
+	free(body);
+	return result;
+}
+
+#define EXPORT_INDEX_NAME    "r2dec.idx"
+#define EXPORT_INDEX_MAGIC   "R2DECIDX"
+#define EXPORT_INDEX_VERSION 1
+#define EXPORT_HEADER_SIZE   32
+#define EXPORT_RECORD_SIZE   48
+#define EXPORT_MAX_PENDING   (64 * 1024 * 1024)
+
+/* a file queued for the export writer thread */
+typedef struct export_file_t {
+	char *path;
+	char *file; // relative to the export directory
+	char *name; // function name, NULL when the file is not indexed
+	char *text;
+	size_t size;
+	ut64 addr;
+	ut64 fcn_size;
+	struct export_file_t *next;
+} ExportFile;
+
+/* an entry of the export index */
+typedef struct export_record_t {
+	ut64 addr;
+	ut64 size;
+	ut64 hash; // FNV-1a of the written file
+	char *name;
+	char *file;
+} ExportRecord;
+
+typedef struct export_writer_t {
+	char *dir;
+	RThread *thread;
+	RThreadLock *lock;
+	RThreadCond *cond;
+	ExportFile *head;
+	ExportFile *tail;
+	size_t pending; // bytes queued and not yet written
+	bool closing;
+	ut32 written;
+	ut32 failed;
+	ut64 bytes;
+	RList *records;
+} ExportWriter;
+
+static void export_file_free(ExportFile *ef) {
+	if (!ef) {
+		return;
+	}
+	free(ef->path);
+	free(ef->file);
+	free(ef->name);
+	free(ef->text);
+	free(ef);
+}
+
+static void export_record_free(void *p) {
+	ExportRecord *record = (ExportRecord *)p;
+	if (!record) {
+		return;
+	}
+	free(record->name);
+	free(record->file);
+	free(record);
+}
+
+static int export_record_cmp(const void *a, const void *b) {
+	const ExportRecord *x = (const ExportRecord *)a;
+	const ExportRecord *y = (const ExportRecord *)b;
+	return x->addr < y->addr ? -1 : (x->addr > y->addr);
+}
+
+/**
+ * The writer thread: files are written while the javascript side keeps
+ * decompiling the next functions.
+ */
+static RThreadFunctionRet export_thread(RThread *th) {
+	ExportWriter *ew = (ExportWriter *)th->user;
+	r_th_lock_enter(ew->lock);
+	for (;;) {
+		while (!ew->head && !ew->closing) {
+			r_th_cond_wait(ew->cond, ew->lock);
+		}
+		ExportFile *ef = ew->head;
+		if (!ef) {
+			break;
+		}
+		ew->head = ef->next;
+		if (!ew->head) {
+			ew->tail = NULL;
+		}
+		r_th_lock_leave(ew->lock);
+
+		bool ok = r_file_dump(ef->path, (const ut8 *)ef->text, (int)ef->size, false);
+		ExportRecord *record = NULL;
+		if (ok && ef->name && (record = R_NEW0(ExportRecord))) {
+			record->addr = ef->addr;
+			record->size = ef->fcn_size;
+			record->hash = fnv1a(FNV64_OFFSET, ef->text, ef->size);
+			record->name = ef->name;
+			record->file = ef->file;
+			ef->name = NULL;
+			ef->file = NULL;
+		}
+
+		r_th_lock_enter(ew->lock);
+		if (record) {
+			r_list_append(ew->records, record);
+		}
+		if (ok) {
+			ew->written++;
+			ew->bytes += ef->size;
+		} else {
+			ew->failed++;
+		}
+		ew->pending -= ef->size;
+		r_th_cond_signal_all(ew->cond);
+		export_file_free(ef);
+	}
+	r_th_lock_leave(ew->lock);
+	return R_TH_STOP;
+}
+
+/**
+ * Index layout (little endian), records are sorted by address:
+ *   header: magic[8], ut32 version, ut32 count, ut64 strings offset, ut64 strings size
+ *   record: ut64 address, ut64 size, ut64 hash, ut32 name offset, ut32 name size,
+ *           ut32 file offset, ut32 file size, ut64 reserved
+ * name and file offsets point into the strings table (NUL terminated).
+ */
+static bool export_write_index(ExportWriter *ew) {
+	r_list_sort(ew->records, export_record_cmp);
+	ut32 count = r_list_length(ew->records);
+	ut64 strings_size = 0;
+	RListIter *it;
+	ExportRecord *record;
+	r_list_foreach (ew->records, it, record) {
+		strings_size += strlen(record->name) + 1;
+		strings_size += strlen(record->file) + 1;
+	}
+	if (strings_size > UT32_MAX) {
+		return false;
+	}
+
+	ut64 strings_offset = EXPORT_HEADER_SIZE + (ut64)count * EXPORT_RECORD_SIZE;
+	size_t size = strings_offset + strings_size;
+	ut8 *index = calloc(1, size);
+	if (!index) {
+		return false;
+	}
+	memcpy(index, EXPORT_INDEX_MAGIC, 8);
+	r_write_le32(index + 8, EXPORT_INDEX_VERSION);
+	r_write_le32(index + 12, count);
+	r_write_le64(index + 16, strings_offset);
+	r_write_le64(index + 24, strings_size);
+
+	ut8 *entry = index + EXPORT_HEADER_SIZE;
+	ut32 offset = 0;
+	r_list_foreach (ew->records, it, record) {
+		ut32 name_size = strlen(record->name);
+		ut32 file_size = strlen(record->file);
+		r_write_le64(entry, record->addr);
+		r_write_le64(entry + 8, record->size);
+		r_write_le64(entry + 16, record->hash);
+		r_write_le32(entry + 24, offset);
+		r_write_le32(entry + 28, name_size);
+		memcpy(index + strings_offset + offset, record->name, name_size);
+		offset += name_size + 1;
+		r_write_le32(entry + 32, offset);
+		r_write_le32(entry + 36, file_size);
+		memcpy(index + strings_offset + offset, record->file, file_size);
+		offset += file_size + 1;
+		entry += EXPORT_RECORD_SIZE;
+	}
+
+	char *path = r_file_new(ew->dir, EXPORT_INDEX_NAME, NULL);
+	bool ok = path && r_file_dump(path, index, (int)size, false);
+	free(path);
+	free(index);
+	return ok;
+}
+
+/**
+ * Waits for the pending writes and stops the writer thread.
+ */
+static void export_finish(ExportWriter *ew) {
+	if (!ew->thread) {
+		return;
+	}
+	r_th_lock_enter(ew->lock);
+	ew->closing = true;
+	r_th_cond_signal_all(ew->cond);
+	r_th_lock_leave(ew->lock);
+	r_th_wait(ew->thread);
+	r_th_free(ew->thread);
+	ew->thread = NULL;
+}
+
+/**
+ * Stops the writer and writes the index (unless aborted).
+ */
+static bool export_close(ExecContext *ectx, bool write_index) {
+	ExportWriter *ew = ectx->exporter;
+	if (!ew) {
+		return false;
+	}
+	ectx->exporter = NULL;
+	export_finish(ew);
+
+	bool ok = ew->failed < 1 && (!write_index || export_write_index(ew));
+	r_list_free(ew->records);
+	r_th_cond_free(ew->cond);
+	r_th_lock_free(ew->lock);
+	free(ew->dir);
+	free(ew);
+	return ok;
+}
+
+static bool export_open(ExecContext *ectx, const char *dir) {
+	if (ectx->exporter) {
+		export_close(ectx, false);
+	}
+	if (!r_file_is_directory(dir) && !r_sys_mkdirp(dir)) {
+		return false;
+	}
+	ExportWriter *ew = R_NEW0(ExportWriter);
+	if (!ew) {
+		return false;
+	}
+	ew->dir = strdup(dir);
+	ew->lock = r_th_lock_new(false);
+	ew->cond = r_th_cond_new();
+	ew->records = r_list_newf(export_record_free);
+	if (!ew->dir || !ew->lock || !ew->cond || !ew->records) {
+		goto fail;
+	}
+	ew->thread = r_th_new(export_thread, ew, 0);
+	if (!ew->thread || !r_th_start(ew->thread)) {
+		r_th_free(ew->thread);
+		goto fail;
+	}
+	ectx->exporter = ew;
+	return true;
+
+fail:
+	r_list_free(ew->records);
+	r_th_cond_free(ew->cond);
+	r_th_lock_free(ew->lock);
+	free(ew->dir);
+	free(ew);
+	return false;
+}
+
+static bool export_queue(ExportWriter *ew, ExportFile *ef) {
+	r_th_lock_enter(ew->lock);
+	// backpressure: the decompiler waits when the disk cannot keep up.
+	while (ew->pending > EXPORT_MAX_PENDING) {
+		r_th_cond_wait(ew->cond, ew->lock);
+	}
+	if (ew->tail) {
+		ew->tail->next = ef;
+	} else {
+		ew->head = ef;
+	}
+	ew->tail = ef;
+	ew->pending += ef->size;
+	r_th_cond_signal_all(ew->cond);
+	r_th_lock_leave(ew->lock);
+	return true;
+}
+
+/**
+ * radare2.exportOpen(directory) starts the export writer.
+ */
+static JSValue js_export_open(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 1) {
+		return JS_ThrowTypeError(ctx, "exportOpen expects (directory)");
+	}
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	const char *dir = JS_ToCString(ctx, argv[0]);
+	if (!dir) {
+		return JS_EXCEPTION;
+	}
+	bool ok = export_open(ectx, dir);
+	JS_FreeCString(ctx, dir);
+	return JS_NewBool(ctx, ok);
+}
+
+/**
+ * radare2.exportWrite(file, text[, name, address, size]) queues a file; the
+ * file is added to the index only when the function details are given.
+ * address and size are hex strings.
+ */
+static JSValue js_export_write(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	if (!ectx->exporter) {
+		return JS_ThrowInternalError(ctx, "exportWrite called without exportOpen");
+	} else if (argc != 2 && argc != 5) {
+		return JS_ThrowTypeError(ctx, "exportWrite expects (file, text[, name, address, size])");
+	}
+
+	ExportFile *ef = R_NEW0(ExportFile);
+	if (!ef) {
+		return JS_ThrowOutOfMemory(ctx);
+	}
+	size_t size = 0;
+	const char *file = JS_ToCString(ctx, argv[0]);
+	const char *text = JS_ToCStringLen(ctx, &size, argv[1]);
+	if (file && text) {
+		ef->file = strdup(file);
+		ef->path = r_file_new(ectx->exporter->dir, file, NULL);
+		ef->text = r_mem_dup(text, size);
+		ef->size = size;
+	}
+	JS_FreeCString(ctx, file);
+	JS_FreeCString(ctx, text);
+	if (argc == 5 && ef->text) {
+		const char *name = JS_ToCString(ctx, argv[2]);
+		const char *addr = JS_ToCString(ctx, argv[3]);
+		const char *fcn_size = JS_ToCString(ctx, argv[4]);
+		if (name && addr && fcn_size) {
+			ef->name = strdup(name);
+			ef->addr = strtoull(addr, NULL, 16);
+			ef->fcn_size = strtoull(fcn_size, NULL, 16);
+		}
+		JS_FreeCString(ctx, name);
+		JS_FreeCString(ctx, addr);
+		JS_FreeCString(ctx, fcn_size);
+		if (!ef->name) {
+			export_file_free(ef);
+			return JS_EXCEPTION;
+		}
+	}
+	if (!ef->file || !ef->path || !ef->text) {
+		export_file_free(ef);
+		return JS_EXCEPTION;
+	}
+	return JS_NewBool(ctx, export_queue(ectx->exporter, ef));
+}
+
+/**
+ * radare2.exportClose() waits for the writer, writes the index and returns
+ * {files, bytes, failed} or null when no export was open.
+ */
+static JSValue js_export_close(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	ExportWriter *ew = ectx->exporter;
+	if (!ew) {
+		return JS_NULL;
+	}
+	export_finish(ew);
+
+	ut32 written = ew->written;
+	ut32 failed = ew->failed;
+	ut64 bytes = ew->bytes;
+	if (!export_close(ectx, true)) {
+		failed++;
+	}
+
+	JSValue result = JS_NewObject(ctx);
+	JS_SetPropertyStr(ctx, result, "files", JS_NewUint32(ctx, written));
+	JS_SetPropertyStr(ctx, result, "bytes", JS_NewInt64(ctx, (int64_t)bytes));
+	JS_SetPropertyStr(ctx, result, "failed", JS_NewUint32(ctx, failed));
+	return result;
+}
+
+/**
+ * radare2.issueOpen(file) starts a binary issue (see issue.h).
+ */
+static JSValue js_issue_open(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 1) {
+		return JS_ThrowTypeError(ctx, "issueOpen expects (file)");
+	}
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	const char *file = JS_ToCString(ctx, argv[0]);
+	if (!file) {
+		return JS_EXCEPTION;
+	}
+	issue_close(ectx->issue, NULL);
+	ectx->issue = issue_create(file);
+	JS_FreeCString(ctx, file);
+	return JS_NewBool(ctx, ectx->issue != NULL);
+}
+
+/**
+ * radare2.issueWrite(name, command, mode, fallback) encodes the output of
+ * the command straight into the section, without passing it to javascript;
+ * the fallback is used when the output is empty or the command is null.
+ * mode is 'string', 'json' or 'merge' (one json value per line, like @@i).
+ */
+static JSValue js_issue_write(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	if (!ectx->issue) {
+		return JS_ThrowInternalError(ctx, "issueWrite called without issueOpen");
+	} else if (argc != 4) {
+		return JS_ThrowTypeError(ctx, "issueWrite expects (name, command, mode, fallback)");
+	}
+
+	const char *name = JS_ToCString(ctx, argv[0]);
+	const char *command = JS_IsNull(argv[1]) ? NULL : JS_ToCString(ctx, argv[1]);
+	const char *mode = JS_ToCString(ctx, argv[2]);
+	const char *fallback = JS_ToCString(ctx, argv[3]);
+	if (!name || (!command && !JS_IsNull(argv[1])) || !mode || !fallback) {
+		JS_FreeCString(ctx, name);
+		JS_FreeCString(ctx, command);
+		JS_FreeCString(ctx, mode);
+		JS_FreeCString(ctx, fallback);
+		return JS_EXCEPTION;
+	}
+
+	char *output = NULL;
+	if (command) {
+		RCore *core = core_enter(ectx);
+		output = r_core_cmd_str(core, command);
+		core_leave(ectx);
+	}
+	if (output) {
+		r_str_trim(output);
+	}
+	const char *text = output ? output : "";
+	size_t size = strlen(text);
+	if (!size) {
+		text = fallback;
+		size = strlen(fallback);
+	}
+
+	bool ok = false;
+	if (!strcmp(mode, "string")) {
+		ok = issue_string(ectx->issue, name, text, size);
+	} else {
+		bool merge = !strcmp(mode, "merge");
+		// invalid json (i.e. an error message of the command) becomes the fallback.
+		ok = issue_json(ectx->issue, name, text, size, merge) ||
+			issue_json(ectx->issue, name, fallback, strlen(fallback), merge);
+	}
+	free(output);
+	JS_FreeCString(ctx, name);
+	JS_FreeCString(ctx, command);
+	JS_FreeCString(ctx, mode);
+	JS_FreeCString(ctx, fallback);
+	return JS_NewBool(ctx, ok);
+}
+
+/**
+ * radare2.issueClose() writes the string pool and returns the file size,
+ * or null when no issue was open or any write failed.
+ */
+static JSValue js_issue_close(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	if (!ectx->issue) {
+		return JS_NULL;
+	}
+	ut64 bytes = 0;
+	bool ok = issue_close(ectx->issue, &bytes);
+	ectx->issue = NULL;
+	return ok ? JS_NewInt64(ctx, (int64_t)bytes) : JS_NULL;
+}
+
+#define CONSOLE_CHUNK_SIZE (1024 * 1024)
+
+static void console_print(ExecContext *ectx, RStrBuf *sb) {
+	RCore *core = core_enter(ectx);
+	r_cons_write(core->cons, r_strbuf_get(sb), r_strbuf_length(sb));
+	core_leave(ectx);
+	r_strbuf_fini(sb);
+}
+
 static JSValue js_console_log(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
 	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
-	RCore *core = ectx->core;
+	RStrBuf sb;
+	r_strbuf_init(&sb);
 	for (int i = 0; i < argc; ++i) {
+		size_t length = 0;
+		const char *str = JS_ToCStringLen(ctx, &length, argv[i]);
+		if (!str) {
+			r_strbuf_fini(&sb);
+			return JS_EXCEPTION;
+		}
 		if (i != 0) {
-			r_cons_print(core->cons, " ");
+			r_strbuf_append_n(&sb, " ", 1);
 		}
-		const char *str = JS_ToCString(ctx, argv[i]);
+		r_strbuf_append_n(&sb, str, length);
+		JS_FreeCString(ctx, str);
+	}
+	r_strbuf_append_n(&sb, "\n", 1);
+	console_print(ectx, &sb);
+	return JS_UNDEFINED;
+}
+
+/**
+ * console.write(lines) prints a string or an array of strings, each one
+ * followed by a newline, with one console write every CONSOLE_CHUNK_SIZE bytes.
+ */
+static JSValue js_console_write(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
+	if (argc < 1) {
+		return JS_UNDEFINED;
+	}
+	uint32_t count = 1;
+	bool array = JS_IsArray(ctx, argv[0]);
+	if (array) {
+		JSValue jslen = JS_GetPropertyStr(ctx, argv[0], "length");
+		if (JS_ToUint32(ctx, &count, jslen)) {
+			JS_FreeValue(ctx, jslen);
+			return JS_EXCEPTION;
+		}
+		JS_FreeValue(ctx, jslen);
+	}
+
+	RStrBuf sb;
+	r_strbuf_init(&sb);
+	for (uint32_t i = 0; i < count; ++i) {
+		JSValue item = array ? JS_GetPropertyUint32(ctx, argv[0], i) : JS_DupValue(ctx, argv[0]);
+		size_t length = 0;
+		const char *str = JS_ToCStringLen(ctx, &length, item);
+		JS_FreeValue(ctx, item);
 		if (!str) {
+			console_print(ectx, &sb);
 			return JS_EXCEPTION;
 		}
-		r_cons_print(core->cons, str);
+		r_strbuf_append_n(&sb, str, length);
+		r_strbuf_append_n(&sb, "\n", 1);
 		JS_FreeCString(ctx, str);
+		if (r_strbuf_length(&sb) >= CONSOLE_CHUNK_SIZE) {
+			console_print(ectx, &sb);
+		}
+	}
+	if (r_strbuf_length(&sb) > 0) {
+		console_print(ectx, &sb);
 	}
-	r_cons_newline(core->cons);
 	return JS_UNDEFINED;
 }
 
+/**
+ * Global() is called once by libdec/shared.js, it is kept for compatibility.
+ */
 static JSValue js_get_global(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
 	ExecContext *ectx = (ExecContext *)JS_GetContextOpaque(ctx);
 	return JS_GetPropertyStr(ctx, ectx->shared, "Shared");
 }
 
-static r2dec_t *r2dec_create(ExecContext *ec, const char *arg) {
-	r2dec_t *dec = r2dec_new();
+static r2dec_t *r2dec_create(ExecContext *ec, ut32 flags) {
+	r2dec_t *dec = r2dec_new(flags);
 	if (!dec) {
 		return NULL;
 	}
 
 	JSContext *ctx = r2dec_context(dec);
 	JS_SetContextOpaque(ctx, ec);
+	ec->config_stack = r_list_newf((RListFree)r_list_free);
 	ec->shared = JS_NewObject(ctx);
 	JS_SetPropertyStr(ctx, ec->shared, "Shared", JS_NewObject(ctx));
 
@@ -85,50 +1821,144 @@ static r2dec_t *r2dec_create(ExecContext *ec, const char *arg) {
 	JSValue console = JS_NewObject(ctx);
 	JS_SetPropertyStr(ctx, global, "console", console);
 	JS_SetPropertyStr(ctx, console, "log", JS_NewCFunction(ctx, js_console_log, "log", 1));
+	JS_SetPropertyStr(ctx, console, "write", JS_NewCFunction(ctx, js_console_write, "write", 1));
 
 	JSValue radare2 = JS_NewObject(ctx);
 	JS_SetPropertyStr(ctx, global, "radare2", radare2);
 	JS_SetPropertyStr(ctx, radare2, "command", JS_NewCFunction(ctx, js_command, "command", 1));
+	JS_SetPropertyStr(ctx, radare2, "comments", JS_NewCFunction(ctx, js_comments, "comments", 1));
+	JS_SetPropertyStr(ctx, radare2, "codelines", JS_NewCFunction(ctx, js_codelines, "codelines", 1));
+	JS_SetPropertyStr(ctx, radare2, "read", JS_NewCFunction(ctx, js_read, "read", 2));
+	JS_SetPropertyStr(ctx, radare2, "readFile", JS_NewCFunction(ctx, js_read_file, "readFile", 1));
+	JS_SetPropertyStr(ctx, radare2, "functionGraph", JS_NewCFunction(ctx, js_function_graph, "functionGraph", 1));
+	JS_SetPropertyStr(ctx, radare2, "functionVars", JS_NewCFunction(ctx, js_function_vars, "functionVars", 1));
+	JS_SetPropertyStr(ctx, radare2, "prefetch", JS_NewCFunction(ctx, js_prefetch, "prefetch", 1));
+	JS_SetPropertyStr(ctx, radare2, "bodyHash", JS_NewCFunction(ctx, js_body_hash, "bodyHash", 1));
+	JS_SetPropertyStr(ctx, radare2, "exportOpen", JS_NewCFunction(ctx, js_export_open, "exportOpen", 1));
+	JS_SetPropertyStr(ctx, radare2, "exportWrite", JS_NewCFunction(ctx, js_export_write, "exportWrite", 5));
+	JS_SetPropertyStr(ctx, radare2, "exportClose", JS_NewCFunction(ctx, js_export_close, "exportClose", 0));
+	JS_SetPropertyStr(ctx, radare2, "fingerprint", JS_NewCFunction(ctx, js_fingerprint, "fingerprint", 1));
+	JS_SetPropertyStr(ctx, radare2, "issueOpen", JS_NewCFunction(ctx, js_issue_open, "issueOpen", 1));
+	JS_SetPropertyStr(ctx, radare2, "issueWrite", JS_NewCFunction(ctx, js_issue_write, "issueWrite", 4));
+	JS_SetPropertyStr(ctx, radare2, "issueClose", JS_NewCFunction(ctx, js_issue_close, "issueClose", 0));
 	JS_SetPropertyStr(ctx, radare2, "version", JS_NewString(ctx, R2_VERSION));
 
+	JSValue config = JS_NewObject(ctx);
+	JS_SetPropertyStr(ctx, radare2, "config", config);
+	JS_SetPropertyStr(ctx, config, "get", JS_NewCFunction(ctx, js_config_get, "get", 1));
+	JS_SetPropertyStr(ctx, config, "push", JS_NewCFunction(ctx, js_config_push, "push", 1));
+	JS_SetPropertyStr(ctx, config, "pop", JS_NewCFunction(ctx, js_config_pop, "pop", 0));
+
 	JSValue process = JS_NewObject(ctx);
 	JS_SetPropertyStr(ctx, global, "process", process);
+	JS_SetPropertyStr(ctx, process, "args", JS_NewArray(ctx));
+
+	JS_FreeValue(ctx, global);
+	return dec;
+}
+
+/**
+ * Sets process.args; arg is split like a shell command line (i.e.
+ * "--window 50 100" or "--export 'my dir'"), quotes keep paths in one token,
+ * and ec->arg_file is appended without any parsing. pddT records the
+ * arguments separated by NUL.
+ */
+static void r2dec_set_args(ExecContext *ec, const char *arg) {
+	JSContext *ctx = r2dec_context(ec->dec);
+	JSValue global = JS_GetGlobalObject(ctx);
+	JSValue process = JS_GetPropertyStr(ctx, global, "process");
 	JSValue args = JS_NewArray(ctx);
-	if (!R_STR_ISEMPTY(arg)) {
-		JS_SetPropertyInt64(ctx, args, 0, JS_NewString(ctx, arg));
+	RStrBuf request;
+	r_strbuf_init(&request);
+	int argc = 0;
+	char **argv = R_STR_ISEMPTY(arg) ? NULL : r_str_argv(arg, &argc);
+	uint32_t n_args = 0;
+	for (int i = 0; argv && i < argc; i++) {
+		JS_SetPropertyUint32(ctx, args, n_args++, JS_NewString(ctx, argv[i]));
+		r_strbuf_append_n(&request, argv[i], strlen(argv[i]) + 1);
+	}
+	if (ec->arg_file) {
+		JS_SetPropertyUint32(ctx, args, n_args++, JS_NewString(ctx, ec->arg_file));
+		r_strbuf_append_n(&request, ec->arg_file, strlen(ec->arg_file) + 1);
 	}
+	r_str_argv_free(argv);
 	JS_SetPropertyStr(ctx, process, "args", args);
-
+	JS_FreeValue(ctx, process);
 	JS_FreeValue(ctx, global);
-	return dec;
+	if (ec->trace) {
+		trace_write(ec->trace, TRACE_ARGS, r_strbuf_get(&request), r_strbuf_length(&request), R2_VERSION, strlen(R2_VERSION));
+	}
+	r_strbuf_fini(&request);
 }
 
-static void r2dec_destroy(r2dec_t *dec, ExecContext *ec) {
-	JSContext *ctx = r2dec_context(dec);
+static void r2dec_destroy(ExecContext *ec) {
+	if (!ec->dec) {
+		return;
+	}
+	JSContext *ctx = r2dec_context(ec->dec);
+	// always restore any override left behind (i.e. on exceptions)
+	while (config_pop(ec)) {
+	}
+	r_list_free(ec->config_stack);
+	ec->config_stack = NULL;
 	JS_FreeValue(ctx, ec->shared);
-	r2dec_free(dec);
+	r2dec_free(ec->dec);
+	ec->dec = NULL;
 }
 
-static bool r2dec_main(RCore *core, const char *arg) {
-	ExecContext ectx;
-	ectx.core = core;
-
-	r2dec_t *dec = r2dec_create(&ectx, arg);
-	if (!dec) {
+/**
+ * The runtime is created on the first pdd and then reused, so the
+ * decompiled sessions cached by the javascript side survive between runs.
+ * Toggling r2dec.arena or r2dec.profile recreates it, since the allocator
+ * is fixed at creation.
+ */
+static bool r2dec_main(ExecContext *ectx, const char *arg) {
+	RCore *core = ectx->core;
+	ut32 flags = 0;
+	if (r_config_get_b(core->config, "r2dec.arena")) {
+		flags |= R2DEC_ARENA;
+	}
+	if (r_config_get_b(core->config, "r2dec.profile")) {
+		flags |= R2DEC_PROFILE;
+	}
+	if (ectx->dec && r2dec_flags(ectx->dec) != flags) {
+		r2dec_destroy(ectx);
+	}
+	if (!ectx->dec && !(ectx->dec = r2dec_create(ectx, flags))) {
 		return false;
 	}
+	if (ectx->sample_file && !r2dec_sample_file(ectx->dec, NULL, NULL)) {
+		r2dec_sample_start(ectx->dec, ectx->sample_file, ectx->sample_hz);
+	}
+	r2dec_set_args(ectx, arg);
 
-	ectx.bed = r_cons_sleep_begin(core->cons);
-	bool ret = r2dec_run(dec);
-	r_cons_sleep_end(core->cons, ectx.bed);
+	ectx->bed = r_cons_sleep_begin(core->cons);
+	bool ret = r2dec_run(ectx->dec);
+	// the prefetch thread can still be inside core_enter/core_leave.
+	prefetch_stop(ectx);
+	r_cons_sleep_end(core->cons, ectx->bed);
+	trace_flush(ectx->trace);
 
-	r2dec_destroy(dec, &ectx);
+	while (config_pop(ectx)) {
+	}
+	graph_free(ectx->graph);
+	ectx->graph = NULL;
+	R_FREE(ectx->vars);
+	// an export left open by an exception is flushed without index.
+	export_close(ectx, false);
+	// an issue left open by an exception is incomplete.
+	issue_close(ectx->issue, NULL);
+	ectx->issue = NULL;
+	if (!ret) {
+		// an uncaught exception may leave the runtime in a bad state.
+		r2dec_destroy(ectx);
+	}
 	return ret;
 }
 
 static void usage(const RCore* const core) {
 	const char* help[] = {
-		"Usage: pdd[*tcabojAfi]", "", "# Core plugin for r2dec",
+		"Usage: pdd[*tcabojAfiwPT]", "", "# Core plugin for r2dec",
 		"pdd",  "",                   "decompile current function",
 		"pddt", "",                   "lists the supported architectures",
 		"pdd*", "",                   "decompiled code is returned to r2 as comment (via CCu)",
@@ -138,61 +1968,175 @@ static void usage(const RCore* const core) {
 		"pddo", "",                   "decompile current function side by side with offsets",
 		"pddj", "",                   "decompile current function as json",
 		"pddA", "",                   "decompile current function with annotation output",
-		"pddf", "",                   "decompile all functions",
-		"pddi", "",                   "generate issue data",
+		"pddf", " [--shard i/n]",     "decompile all functions (or one shard, see --range, --functions and r2dec-standalone --merge)",
+		"pddf", " --export <dir>",    "write each function into <dir> with an index (r2dec.idx), see --export-annotation",
+		"pddi", " [<file>]",          "generate issue data (as json or into <file> as binary, see r2dec-standalone)",
+		"pddP", " [<file> [hz]]",     "sample the javascript stacks of the next runs into <file> (folded, for flamegraph.pl)",
+		"pddP-", "",                  "stop sampling",
+		"pddT", " [<file>]",          "record the radare2 traffic of the next runs into <file> (see r2dec-standalone --replay)",
+		"pddT-", "",                  "stop recording",
+		"pddw", " [lines] [first]",   "show only a window of lines (default: screen height, centered on the current offset)",
+		"pddwj", " [lines] [first]",  "same as pddw but as json, with the line offsets of the whole function",
 		NULL
 	};
 
 	r_cons_cmd_help(core->cons, help, core->print->flags & R_PRINT_FLAGS_COLOR);
 }
 
-static void _cmd_pdd(RCore *core, const char *input) {
+static void r2dec_window(ExecContext *ectx, const char *input) {
+	const char *json = "";
+	if (*input == 'j') {
+		json = "--as-json ";
+		input++;
+	}
+	input = r_str_trim_head_ro(input);
+
+	char *arg = NULL;
+	if (R_STR_ISEMPTY(input)) {
+		int rows = 0;
+		r_cons_get_size(ectx->core->cons, &rows);
+		arg = r_str_newf("%s--window %d", json, rows > 0 ? rows : 50);
+	} else {
+		arg = r_str_newf("%s--window %s", json, input);
+	}
+	r2dec_main(ectx, arg);
+	free(arg);
+}
+
+/**
+ * pddP <file> [hz] starts the stack sampler, pddP- stops it and
+ * pddP shows its state; the file is rewritten at the end of each run.
+ */
+static void r2dec_sample(ExecContext *ectx, const char *input) {
+	RCore *core = ectx->core;
+	input = r_str_trim_head_ro(input);
+	if (*input == '-') {
+		R_FREE(ectx->sample_file);
+		if (ectx->dec) {
+			r2dec_sample_stop(ectx->dec);
+		}
+		return;
+	} else if (R_STR_ISEMPTY(input)) {
+		ut32 hz = 0;
+		ut64 samples = 0;
+		const char *file = ectx->dec ? r2dec_sample_file(ectx->dec, &hz, &samples) : NULL;
+		if (file) {
+			r_cons_printf(core->cons, "sampling into %s at %uHz (%" PFMT64u " samples)\n", file, hz, samples);
+		} else if (ectx->sample_file) {
+			r_cons_printf(core->cons, "sampling into %s from the next run\n", ectx->sample_file);
+		} else {
+			r_cons_printf(core->cons, "not sampling\n");
+		}
+		return;
+	}
+
+	const char *space = strchr(input, ' ');
+	free(ectx->sample_file);
+	ectx->sample_file = space ? r_str_ndup(input, space - input) : strdup(input);
+	ectx->sample_hz = space ? (ut32)r_num_get(NULL, space + 1) : R2DEC_SAMPLE_HZ;
+	if (ectx->dec) {
+		r2dec_sample_start(ectx->dec, ectx->sample_file, ectx->sample_hz);
+	}
+}
+
+/**
+ * pddT <file> records the bridge traffic of the next runs, pddT- stops
+ * and pddT shows the state; the file is flushed at the end of each run.
+ */
+static void r2dec_trace(ExecContext *ectx, const char *input) {
+	RCore *core = ectx->core;
+	input = r_str_trim_head_ro(input);
+	if (*input == '-') {
+		trace_close(ectx->trace);
+		ectx->trace = NULL;
+		return;
+	} else if (R_STR_ISEMPTY(input)) {
+		ut64 records = 0, bytes = 0;
+		const char *file = trace_file(ectx->trace, &records, &bytes);
+		if (file) {
+			r_cons_printf(core->cons, "recording into %s (%" PFMT64u " records, %" PFMT64u " bytes)\n", file, records, bytes);
+		} else {
+			r_cons_printf(core->cons, "not recording\n");
+		}
+		return;
+	}
+
+	trace_close(ectx->trace);
+	if (!(ectx->trace = trace_create(input))) {
+		r_cons_printf(core->cons, "cannot create %s\n", input);
+	}
+}
+
+static void _cmd_pdd(ExecContext *ectx, const char *input) {
 	switch (*input) {
 	case '\0':
-		r2dec_main (core, NULL);
+		r2dec_main (ectx, NULL);
 		break;
 	case 't':
 		// --architectures
-		r2dec_main (core, "--architectures");
+		r2dec_main (ectx, "--architectures");
 		break;
-	case 'i':
-		// --issue
-		r2dec_main (core, "--issue");
+	case 'i': {
+		// --issue or --issue-binary <file>
+		const char *file = r_str_trim_head_ro(input + 1);
+		if (R_STR_ISEMPTY(file)) {
+			r2dec_main (ectx, "--issue");
+			break;
+		}
+		// the whole input is the file, passed as it is.
+		ectx->arg_file = file;
+		r2dec_main (ectx, "--issue-binary");
+		ectx->arg_file = NULL;
 		break;
+	}
 	case 'a':
 		// --assembly
-		r2dec_main (core, "--assembly");
+		r2dec_main (ectx, "--assembly");
 		break;
 	case 'o':
 		// --offsets
-		r2dec_main (core, "--offsets");
+		r2dec_main (ectx, "--offsets");
 		break;
 	case 'b':
 		// --blocks
-		r2dec_main (core, "--blocks");
+		r2dec_main (ectx, "--blocks");
 		break;
 	case 'c':
 		// --as-code-line
-		r2dec_main (core, "--as-code-line");
+		r2dec_main (ectx, "--as-code-line");
+		break;
+	case 'f': {
+		// --all-functions [--shard i/n | --range from to | --functions file]
+		char *arg = r_str_newf("--all-functions %s", r_str_trim_head_ro(input + 1));
+		r2dec_main (ectx, arg);
+		free(arg);
 		break;
-	case 'f':
-		r2dec_main (core, "--all-functions");
+	}
+	case 'w':
+		// --window [lines] [first line]
+		r2dec_window(ectx, input + 1);
 		break;
 	case '*':
 		// --as-comment
-		r2dec_main (core, "--as-comment");
+		r2dec_main (ectx, "--as-comment");
 		break;
 	case 'j':
 		// --as-json
-		r2dec_main (core, "--as-json");
+		r2dec_main (ectx, "--as-json");
 		break;
 	case 'A':
 		// --annotation
-		r2dec_main (core, "--annotation");
+		r2dec_main (ectx, "--annotation");
+		break;
+	case 'P':
+		r2dec_sample(ectx, input + 1);
+		break;
+	case 'T':
+		r2dec_trace(ectx, input + 1);
 		break;
 	case '?':
 	default:
-		usage(core);
+		usage(ectx->core);
 		break;
 	}
 }
@@ -200,8 +2144,9 @@ static void _cmd_pdd(RCore *core, const char *input) {
 static bool r_cmd_pdd(RCorePluginSession *cps, const char *input) {
 	if (r_str_startswith (input, "pdd")) {
 		RCore *core = cps->core;
+		ExecContext *ectx = (ExecContext *)cps->data;
 		const ut64 addr = core->addr;
-		_cmd_pdd (core, input + 3);
+		_cmd_pdd (ectx, input + 3);
 		r_core_seek (core, addr, true);
 		return true;
 	}
@@ -211,13 +2156,19 @@ static bool r_cmd_pdd(RCorePluginSession *cps, const char *input) {
 static bool r_cmd_pdd_init(RCorePluginSession *cps) {
 	RConfig *cfg = cps->core->config;
 	r_config_lock (cfg, false);
+	SETPREF("r2dec.arena", "false", "if true, the javascript heap uses a page arena recycled between runs.");
 	SETPREF("r2dec.asm", "false", "if true, shows pseudo next to the assembly.");
 	SETPREF("r2dec.blocks", "false", "if true, shows only scopes blocks.");
+	SETPREF("r2dec.cache", "true", "if true, reuses the decompiled code of the recently viewed functions.");
 	SETPREF("r2dec.casts", "false", "if false, hides all casts in the pseudo code.");
 	SETPREF("r2dec.debug", "false", "do not catch exceptions in r2dec.");
+	SETPREF("r2dec.dedup", "false", "if true, pddf decompiles identical functions (code, comments, variables and signature) only once.");
+	SETPREF("r2dec.dedup.compact", "false", "if true, pddf shows identical functions as a reference to the first copy.");
 	SETPREF("r2dec.highlight", "default", "highlights the current address.");
 	SETPREF("r2dec.paddr", "false", "if true, all xrefs uses physical addresses compare.");
+	SETPREF("r2dec.profile", "false", "if true, reports the javascript heap traffic of each phase as JSON.");
 	SETPREF("r2dec.slow", "false", "load all the data before to avoid multirequests to r2.");
+	SETPREF("r2dec.timing", "false", "if true, shows the time spent in each decompilation phase.");
 	SETPREF("r2dec.vars", "true", "if true, shows local variable definitions.");
 	SETPREF("r2dec.xrefs", "false", "if true, shows all xrefs in the pseudo code.");
 	r_config_lock (cfg, true);
@@ -225,12 +2176,36 @@ static bool r_cmd_pdd_init(RCorePluginSession *cps) {
 	const char *commands[] = {
 		"pdd", "pdd?", "pdd*", "pdda", "pddb",
 		"pddc", "pddf", "pddi", "pdds", "pddu",
+		"pddw", "pddwj", "pddP", "pddT",
 		NULL
 	};
 	RCoreAutocomplete *a = cps->core->autocomplete;
 	for (const char **cmd = commands; *cmd; cmd++) {
 		r_core_autocomplete_add(a, *cmd, R_CORE_AUTOCMPLT_DFLT, true);
 	}
+
+	ExecContext *ectx = R_NEW0(ExecContext);
+	if (!ectx) {
+		return false;
+	} else if (!(ectx->core_lock = r_th_lock_new(true))) {
+		free(ectx);
+		return false;
+	}
+	ectx->core = cps->core;
+	cps->data = ectx;
+	return true;
+}
+
+static bool r_cmd_pdd_fini(RCorePluginSession *cps) {
+	ExecContext *ectx = (ExecContext *)cps->data;
+	if (ectx) {
+		r2dec_destroy(ectx);
+		r_th_lock_free(ectx->core_lock);
+		free(ectx->sample_file);
+		trace_close(ectx->trace);
+		free(ectx);
+		cps->data = NULL;
+	}
 	return true;
 }
 
@@ -241,7 +2216,8 @@ RCorePlugin core_plugin_r2dec = {
 		.license = "BSD-3",
 	},
 	.call = r_cmd_pdd,
-	.init = r_cmd_pdd_init
+	.init = r_cmd_pdd_init,
+	.fini = r_cmd_pdd_fini
 };
 
 #ifdef _MSC_VER
@@ -4,14 +4,44 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <pthread.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "r2dec.h"
+#include "issue.h"
+#include "trace.h"
 #define errorf(...) fprintf(stderr, __VA_ARGS__)
 
-static JSValue shared;
+#define SERVER_READ_SIZE   (64 * 1024)
+#define SERVER_POLL_MSECS  200
+#define SERVER_MAX_CLIENTS 64
+#define STDOUT_FLUSH_SIZE  (256 * 1024)
+
+typedef struct buffer_s {
+	char *data;
+	size_t size;
+	size_t capacity;
+} buffer_t;
+
+typedef struct replay_s replay_t;
+
+/* per runtime data, set as context opaque */
+typedef struct standalone_s {
+	r2dec_t *dec;
+	JSValue shared;
+	buffer_t *output; // when NULL, console.log writes to stdout
+	buffer_t sink; // pending stdout data, flushed at STDOUT_FLUSH_SIZE and at the end of the run
+	replay_t *replay; // --replay, serves the radare2 object
+	issue_t *issue; // binary issue, mapped until the runtime is freed
+} standalone_t;
 
 int is_regular_file(const char *path) {
 	if (!path || !*path) {
@@ -68,32 +98,205 @@ fail:
 	return NULL;
 }
 
+static int buffer_append(buffer_t *buf, const char *data, size_t size) {
+	if (buf->size + size + 1 > buf->capacity) {
+		size_t capacity = buf->capacity ? buf->capacity : 4096;
+		while (buf->size + size + 1 > capacity) {
+			capacity *= 2;
+		}
+		char *tmp = realloc(buf->data, capacity);
+		if (!tmp) {
+			return 0;
+		}
+		buf->data = tmp;
+		buf->capacity = capacity;
+	}
+	memcpy(buf->data + buf->size, data, size);
+	buf->size += size;
+	buf->data[buf->size] = 0;
+	return 1;
+}
+
+static void buffer_consume(buffer_t *buf, size_t size) {
+	if (size >= buf->size) {
+		buf->size = 0;
+		return;
+	}
+	memmove(buf->data, buf->data + size, buf->size - size);
+	buf->size -= size;
+}
+
+static void output_flush(standalone_t *sa) {
+	if (sa->sink.size > 0) {
+		fwrite(sa->sink.data, 1, sa->sink.size, stdout);
+		sa->sink.size = 0;
+	}
+	fflush(stdout);
+}
+
+static void output_write(standalone_t *sa, const char *data, size_t size) {
+	if (sa->output) {
+		buffer_append(sa->output, data, size);
+		return;
+	} else if (!buffer_append(&sa->sink, data, size)) {
+		// out of memory; write what is pending and the data directly.
+		output_flush(sa);
+		fwrite(data, 1, size, stdout);
+		return;
+	}
+	if (sa->sink.size >= STDOUT_FLUSH_SIZE) {
+		output_flush(sa);
+	}
+}
+
 static JSValue js_console_log(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	standalone_t *sa = (standalone_t *)JS_GetContextOpaque(ctx);
 	for (int i = 0; i < argc; ++i) {
+		size_t length = 0;
+		const char *str = JS_ToCStringLen(ctx, &length, argv[i]);
+		if (!str) {
+			return JS_EXCEPTION;
+		}
 		if (i != 0) {
-			fputc(' ', stdout);
+			output_write(sa, " ", 1);
+		}
+		output_write(sa, str, length);
+		JS_FreeCString(ctx, str);
+	}
+	output_write(sa, "\n", 1);
+	return JS_UNDEFINED;
+}
+
+/**
+ * console.write(lines) writes a string or an array of strings,
+ * each one followed by a newline, in a single call.
+ */
+static JSValue js_console_write(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	standalone_t *sa = (standalone_t *)JS_GetContextOpaque(ctx);
+	if (argc < 1) {
+		return JS_UNDEFINED;
+	}
+	uint32_t count = 1;
+	int array = JS_IsArray(ctx, argv[0]);
+	if (array) {
+		JSValue jslen = JS_GetPropertyStr(ctx, argv[0], "length");
+		if (JS_ToUint32(ctx, &count, jslen)) {
+			JS_FreeValue(ctx, jslen);
+			return JS_EXCEPTION;
 		}
-		const char *str = JS_ToCString(ctx, argv[i]);
+		JS_FreeValue(ctx, jslen);
+	}
+	for (uint32_t i = 0; i < count; ++i) {
+		JSValue item = array ? JS_GetPropertyUint32(ctx, argv[0], i) : JS_DupValue(ctx, argv[0]);
+		size_t length = 0;
+		const char *str = JS_ToCStringLen(ctx, &length, item);
+		JS_FreeValue(ctx, item);
 		if (!str) {
 			return JS_EXCEPTION;
 		}
-		fputs(str, stdout);
+		output_write(sa, str, length);
+		output_write(sa, "\n", 1);
 		JS_FreeCString(ctx, str);
 	}
-	fputc('\n', stdout);
-	fflush(stdout);
 	return JS_UNDEFINED;
 }
 
+/**
+ * Global() is called once by libdec/shared.js, it is kept for compatibility.
+ */
 static JSValue js_get_global(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
-	return JS_GetPropertyStr(ctx, shared, "Shared");
+	standalone_t *sa = (standalone_t *)JS_GetContextOpaque(ctx);
+	return JS_GetPropertyStr(ctx, sa->shared, "Shared");
 }
 
-static int init_testsuite(r2dec_t *dec, const char *file, const char *raw) {
-	JSContext *ctx = r2dec_context(dec);
+/**
+ * Replaces the unit global with the new request; the shared data object
+ * is kept, since libdec/shared.js binds it once, and it is reset by the
+ * testsuite main.
+ */
+static void set_testsuite_unit(standalone_t *sa, const char *file, const char *raw, size_t size) {
+	JSContext *ctx = r2dec_context(sa->dec);
+	JSValue global = JS_GetGlobalObject(ctx);
+	if (raw) {
+		JSValue unit = JS_NewObject(ctx);
+		JS_SetPropertyStr(ctx, unit, "file", JS_NewString(ctx, file));
+		JS_SetPropertyStr(ctx, unit, "raw", JS_NewStringLen(ctx, raw, size));
+		JS_SetPropertyStr(ctx, global, "unit", unit);
+	} else {
+		JS_SetPropertyStr(ctx, global, "unit", JS_NULL);
+	}
+	JS_FreeValue(ctx, global);
+}
 
-	shared = JS_NewObject(ctx);
-	JS_SetPropertyStr(ctx, shared, "Shared", JS_NewObject(ctx));
+/**
+ * unit.strings() returns the string pool of the binary issue.
+ */
+static JSValue js_issue_strings(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	standalone_t *sa = (standalone_t *)JS_GetContextOpaque(ctx);
+	const issue_section_t *pool = sa->issue->strings;
+	const uint8_t *p = pool->data;
+	const uint8_t *end = pool->data + pool->size;
+	uint64_t count = 0;
+	p = issue_varint(p, end, &count);
+
+	JSValue strings = JS_NewArray(ctx);
+	for (uint32_t i = 0; i < sa->issue->n_strings; ++i) {
+		uint64_t size = 0;
+		if (!(p = issue_varint(p, end, &size)) || size > (uint64_t)(end - p)) {
+			JS_FreeValue(ctx, strings);
+			return JS_ThrowSyntaxError(ctx, "truncated string pool");
+		}
+		JS_SetPropertyUint32(ctx, strings, i, JS_NewStringLen(ctx, (const char *)p, size));
+		p += size;
+	}
+	return strings;
+}
+
+static void issue_buffer_free(JSRuntime *rt, void *opaque, void *ptr) {
+	// the sections point into the mapped issue, released by fini_testsuite.
+}
+
+/**
+ * Sets the unit of a binary issue: each section is an ArrayBuffer over the
+ * mapped file, decoded by libdec/issuebin.js only when it is used.
+ */
+static void set_testsuite_issue(standalone_t *sa, const char *file, issue_t *issue) {
+	JSContext *ctx = r2dec_context(sa->dec);
+	JSValue global = JS_GetGlobalObject(ctx);
+	JSValue unit = JS_NewObject(ctx);
+	JSValue sections = JS_NewObject(ctx);
+	sa->issue = issue;
+	for (uint32_t i = 0; i < issue->n_sections; ++i) {
+		const issue_section_t *section = &issue->sections[i];
+		if (section == issue->strings) {
+			continue;
+		}
+		JSAtom name = JS_NewAtomLen(ctx, section->name, section->name_size);
+		JS_SetProperty(ctx, sections, name, JS_NewArrayBuffer(ctx, section->data, section->size, issue_buffer_free, NULL, false));
+		JS_FreeAtom(ctx, name);
+	}
+	JS_SetPropertyStr(ctx, unit, "file", JS_NewString(ctx, file));
+	JS_SetPropertyStr(ctx, unit, "sections", sections);
+	JS_SetPropertyStr(ctx, unit, "strings", JS_NewCFunction(ctx, js_issue_strings, "strings", 0));
+	JS_SetPropertyStr(ctx, global, "unit", unit);
+	JS_FreeValue(ctx, global);
+}
+
+static standalone_t *init_testsuite(const char *file, const char *raw, uint32_t flags) {
+	standalone_t *sa = calloc(1, sizeof(standalone_t));
+	if (!sa) {
+		errorf("Error: failed to allocate standalone_t\n");
+		return NULL;
+	} else if (!(sa->dec = r2dec_new(flags))) {
+		free(sa);
+		return NULL;
+	}
+
+	JSContext *ctx = r2dec_context(sa->dec);
+	JS_SetContextOpaque(ctx, sa);
+
+	sa->shared = JS_NewObject(ctx);
+	JS_SetPropertyStr(ctx, sa->shared, "Shared", JS_NewObject(ctx));
 
 	JSValue global = JS_GetGlobalObject(ctx);
 	JS_SetPropertyStr(ctx, global, "Global", JS_NewCFunction(ctx, js_get_global, "Global", 1));
@@ -102,44 +305,1113 @@ static int init_testsuite(r2dec_t *dec, const char *file, const char *raw) {
 	JSValue console = JS_NewObject(ctx);
 	JS_SetPropertyStr(ctx, global, "console", console);
 	JS_SetPropertyStr(ctx, console, "log", JS_NewCFunction(ctx, js_console_log, "log", 1));
+	JS_SetPropertyStr(ctx, console, "write", JS_NewCFunction(ctx, js_console_write, "write", 1));
+	JS_FreeValue(ctx, global);
 
-	JSValue unit = JS_NewObject(ctx);
-	JS_SetPropertyStr(ctx, global, "unit", unit);
-	JS_SetPropertyStr(ctx, unit, "file", JS_NewString(ctx, file));
-	JS_SetPropertyStr(ctx, unit, "raw", JS_NewString(ctx, raw));
+	set_testsuite_unit(sa, file, raw, raw ? strlen(raw) : 0);
+	return sa;
+}
+
+static void fini_testsuite(standalone_t *sa) {
+	if (!sa) {
+		return;
+	}
+	output_flush(sa);
+	JSContext *ctx = r2dec_context(sa->dec);
+	JS_FreeValue(ctx, sa->shared);
+	r2dec_free(sa->dec);
+	issue_unmap(sa->issue);
+	free(sa->sink.data);
+	free(sa);
+}
+
+/*
+ * Server mode.
+ *
+ * Each request is an issue JSON, either on a single line (newline-delimited)
+ * or preceded by a line containing only its length in bytes (length-prefixed).
+ * Each result is written back as "<id> <ok|error|timeout> <length>\n<output>",
+ * where id is the position of the request (starting from 0) on its stream.
+ */
+
+typedef struct client_s {
+	int fd_in;
+	int fd_out;
+	int eof;
+	int refs;
+	unsigned long next_id;
+	buffer_t input;
+	pthread_mutex_t lock;
+} client_t;
+
+typedef struct job_s {
+	struct job_s *next;
+	client_t *client;
+	unsigned long id;
+	char *payload;
+	size_t size;
+} job_t;
+
+typedef struct server_s {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	job_t *head;
+	job_t *tail;
+	int closed;
+	uint32_t flags; // r2dec_new flags of the workers
+	uint32_t timeout;
+} server_t;
+
+static volatile sig_atomic_t server_stop = 0;
+
+static void server_signal(int sig) {
+	server_stop = 1;
+}
+
+static int write_all(int fd, const char *data, size_t size) {
+	while (size > 0) {
+		ssize_t n = write(fd, data, size);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		} else if (n <= 0) {
+			return 0;
+		}
+		data += n;
+		size -= n;
+	}
+	return 1;
+}
+
+static client_t *client_new(int fd_in, int fd_out) {
+	client_t *client = calloc(1, sizeof(client_t));
+	if (!client) {
+		return NULL;
+	}
+	client->fd_in = fd_in;
+	client->fd_out = fd_out;
+	client->refs = 1;
+	pthread_mutex_init(&client->lock, NULL);
+	return client;
+}
+
+static void client_unref(client_t *client) {
+	pthread_mutex_lock(&client->lock);
+	int refs = --client->refs;
+	pthread_mutex_unlock(&client->lock);
+	if (refs > 0) {
+		return;
+	}
+	if (client->fd_in > STDERR_FILENO) {
+		close(client->fd_in);
+	}
+	if (client->fd_out > STDERR_FILENO && client->fd_out != client->fd_in) {
+		close(client->fd_out);
+	}
+	pthread_mutex_destroy(&client->lock);
+	free(client->input.data);
+	free(client);
+}
+
+static void client_reply(client_t *client, unsigned long id, const char *status, const char *data, size_t size) {
+	char header[128];
+	int hsize = snprintf(header, sizeof(header), "%lu %s %zu\n", id, status, size);
+	pthread_mutex_lock(&client->lock);
+	if (write_all(client->fd_out, header, hsize)) {
+		write_all(client->fd_out, data, size);
+	}
+	pthread_mutex_unlock(&client->lock);
+}
+
+static void server_push(server_t *server, client_t *client, char *payload, size_t size) {
+	job_t *job = calloc(1, sizeof(job_t));
+	if (!job) {
+		errorf("Error: failed to allocate job_t\n");
+		free(payload);
+		return;
+	}
+	pthread_mutex_lock(&client->lock);
+	client->refs++;
+	job->id = client->next_id++;
+	pthread_mutex_unlock(&client->lock);
+	job->client = client;
+	job->payload = payload;
+	job->size = size;
+
+	pthread_mutex_lock(&server->lock);
+	if (server->tail) {
+		server->tail->next = job;
+	} else {
+		server->head = job;
+	}
+	server->tail = job;
+	pthread_cond_signal(&server->cond);
+	pthread_mutex_unlock(&server->lock);
+}
+
+static job_t *server_pop(server_t *server) {
+	pthread_mutex_lock(&server->lock);
+	while (!server->head && !server->closed) {
+		pthread_cond_wait(&server->cond, &server->lock);
+	}
+	job_t *job = server->head;
+	if (job) {
+		server->head = job->next;
+		if (!server->head) {
+			server->tail = NULL;
+		}
+	}
+	pthread_mutex_unlock(&server->lock);
+	return job;
+}
+
+static void server_close(server_t *server) {
+	pthread_mutex_lock(&server->lock);
+	server->closed = 1;
+	pthread_cond_broadcast(&server->cond);
+	pthread_mutex_unlock(&server->lock);
+}
+
+static void *server_worker(void *user) {
+	server_t *server = (server_t *)user;
+	buffer_t output = { 0 };
+	standalone_t *sa = NULL;
+	char file[64];
+	job_t *job;
+
+	while ((job = server_pop(server))) {
+		if (!sa) {
+			// the runtime is created once and kept between requests.
+			if (!(sa = init_testsuite("server", NULL, server->flags))) {
+				client_reply(job->client, job->id, "error", "", 0);
+				goto next;
+			}
+			r2dec_set_timeout(sa->dec, server->timeout);
+			sa->output = &output;
+		}
+
+		output.size = 0;
+		snprintf(file, sizeof(file), "request-%lu.json", job->id);
+		set_testsuite_unit(sa, file, job->payload, job->size);
+		free(job->payload);
+		job->payload = NULL;
+
+		int ok = r2dec_run(sa->dec);
+		if (r2dec_timed_out(sa->dec)) {
+			client_reply(job->client, job->id, "timeout", output.data, output.size);
+			// an interrupted runtime is not reused.
+			fini_testsuite(sa);
+			sa = NULL;
+		} else {
+			client_reply(job->client, job->id, ok ? "ok" : "error", output.data, output.size);
+			set_testsuite_unit(sa, "server", NULL, 0);
+		}
+
+	next:
+		client_unref(job->client);
+		free(job->payload);
+		free(job);
+	}
+
+	fini_testsuite(sa);
+	free(output.data);
+	return NULL;
+}
+
+/**
+ * Extracts all the complete requests from the client input buffer.
+ */
+static void server_parse(server_t *server, client_t *client) {
+	buffer_t *in = &client->input;
+	while (in->size > 0) {
+		char *nl = memchr(in->data, '\n', in->size);
+		if (!nl && !client->eof) {
+			return;
+		}
+
+		size_t line = nl ? (size_t)(nl - in->data) : in->size;
+		size_t consumed = nl ? line + 1 : line;
+		size_t digits = 0;
+		while (digits < line && in->data[digits] >= '0' && in->data[digits] <= '9') {
+			digits++;
+		}
+
+		char *payload = NULL;
+		size_t size = 0;
+		if (digits > 0 && digits == line) {
+			// length-prefixed request
+			size = strtoul(in->data, NULL, 10);
+			if (in->size - consumed < size) {
+				if (client->eof) {
+					errorf("Error: truncated request (%zu/%zu bytes)\n", in->size - consumed, size);
+					in->size = 0;
+				}
+				return;
+			}
+			payload = malloc(size + 1);
+			if (payload) {
+				memcpy(payload, in->data + consumed, size);
+				payload[size] = 0;
+			}
+			consumed += size;
+		} else {
+			// newline-delimited request; blank lines are ignored.
+			size_t start = 0;
+			while (start < line && (in->data[start] == ' ' || in->data[start] == '\r' || in->data[start] == '\t')) {
+				start++;
+			}
+			if (start < line) {
+				size = line - start;
+				payload = malloc(size + 1);
+				if (payload) {
+					memcpy(payload, in->data + start, size);
+					payload[size] = 0;
+				}
+			}
+		}
+
+		buffer_consume(in, consumed);
+		if (payload) {
+			server_push(server, client, payload, size);
+		}
+	}
+}
+
+static int server_listen(const char *path) {
+	struct sockaddr_un addr;
+	if (strlen(path) >= sizeof(addr.sun_path)) {
+		errorf("Error: socket path '%s' is too long\n", path);
+		return -1;
+	}
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) {
+		errorf("Error: failed to create socket: %s\n", strerror(errno));
+		return -1;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	strcpy(addr.sun_path, path);
+	unlink(path);
+	if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, SERVER_MAX_CLIENTS) < 0) {
+		errorf("Error: failed to listen on '%s': %s\n", path, strerror(errno));
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+static int server_main(const char *socket_path, int n_workers, uint32_t timeout, uint32_t flags) {
+	server_t server = { 0 };
+	client_t *clients[SERVER_MAX_CLIENTS] = { 0 };
+	struct pollfd fds[SERVER_MAX_CLIENTS + 1];
+	int n_clients = 0, listener = -1;
+	pthread_t *workers = NULL;
+	char *chunk = NULL;
+	int ret = 1;
+
+	struct sigaction sa = { 0 };
+	sa.sa_handler = server_signal;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	pthread_mutex_init(&server.lock, NULL);
+	pthread_cond_init(&server.cond, NULL);
+	server.timeout = timeout;
+	server.flags = flags;
+
+	if (socket_path) {
+		if ((listener = server_listen(socket_path)) < 0) {
+			goto end;
+		}
+	} else if (!(clients[n_clients++] = client_new(STDIN_FILENO, STDOUT_FILENO))) {
+		goto end;
+	}
+
+	if (!(chunk = malloc(SERVER_READ_SIZE)) || !(workers = calloc(n_workers, sizeof(pthread_t)))) {
+		errorf("Error: failed to allocate server buffers\n");
+		goto end;
+	}
+
+	int n_started = 0;
+	for (; n_started < n_workers; ++n_started) {
+		if (pthread_create(&workers[n_started], NULL, server_worker, &server)) {
+			errorf("Error: failed to start worker %d\n", n_started);
+			break;
+		}
+	}
+
+	// stdin mode ends on EOF, socket mode ends on SIGINT/SIGTERM
+	while (!server_stop && (listener >= 0 || n_clients > 0)) {
+		int n_fds = 0;
+		if (listener >= 0) {
+			fds[n_fds].fd = listener;
+			fds[n_fds++].events = POLLIN;
+		}
+		for (int i = 0; i < n_clients; ++i) {
+			fds[n_fds].fd = clients[i]->fd_in;
+			fds[n_fds++].events = POLLIN;
+		}
+
+		if (poll(fds, n_fds, SERVER_POLL_MSECS) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			errorf("Error: poll failed: %s\n", strerror(errno));
+			break;
+		}
+
+		int base = 0;
+		if (listener >= 0) {
+			base = 1;
+			if (fds[0].revents & POLLIN) {
+				int fd = accept(listener, NULL, NULL);
+				if (fd >= 0 && n_clients < SERVER_MAX_CLIENTS && (clients[n_clients] = client_new(fd, fd))) {
+					n_clients++;
+				} else if (fd >= 0) {
+					close(fd);
+				}
+			}
+		}
+
+		for (int i = n_clients - 1; i >= 0; --i) {
+			client_t *client = clients[i];
+			short revents = fds[base + i].revents;
+			if (!(revents & (POLLIN | POLLHUP | POLLERR))) {
+				continue;
+			}
+			ssize_t n = read(client->fd_in, chunk, SERVER_READ_SIZE);
+			if (n < 0 && errno == EINTR) {
+				continue;
+			} else if (n > 0) {
+				buffer_append(&client->input, chunk, n);
+			} else {
+				client->eof = 1;
+			}
+			server_parse(&server, client);
+			if (client->eof) {
+				clients[i] = clients[--n_clients];
+				client_unref(client);
+			}
+		}
+	}
+
+	// graceful shutdown: queued requests are still processed.
+	server_close(&server);
+	for (int i = 0; i < n_started; ++i) {
+		pthread_join(workers[i], NULL);
+	}
+	ret = 0;
+
+end:
+	for (int i = 0; i < n_clients; ++i) {
+		client_unref(clients[i]);
+	}
+	if (listener >= 0) {
+		close(listener);
+		unlink(socket_path);
+	}
+	free(workers);
+	free(chunk);
+	pthread_cond_destroy(&server.cond);
+	pthread_mutex_destroy(&server.lock);
+	return ret;
+}
+
+/*
+ * Replay mode.
+ *
+ * Runs the plugin javascript on a trace recorded with pddT: each recorded
+ * run is replayed with the same arguments and radare2 is served from the
+ * trace, then the bridge traffic is summarized on stderr.
+ */
+
+typedef struct replay_stat_s {
+	char name[32];
+	uint64_t count;
+	uint64_t bytes;
+	uint64_t misses;
+} replay_stat_t;
+
+struct replay_s {
+	trace_t *trace;
+	uint32_t first; // records of the current run
+	uint32_t end;
+	uint32_t cursor;
+	replay_stat_t *stats;
+	uint32_t n_stats;
+};
+
+static void replay_free(replay_t *replay) {
+	if (!replay) {
+		return;
+	}
+	trace_free(replay->trace);
+	free(replay->stats);
+	free(replay);
+}
+
+static replay_t *replay_new(const char *file) {
+	replay_t *replay = calloc(1, sizeof(replay_t));
+	if (!replay) {
+		errorf("Error: failed to allocate replay_t\n");
+		return NULL;
+	} else if (!(replay->trace = trace_load(file))) {
+		errorf("Error: '%s' is not a r2dec trace (see pddT)\n", file);
+		free(replay);
+		return NULL;
+	}
+	return replay;
+}
+
+/**
+ * Requests are grouped by kind and, for the commands, by the first word
+ * (i.e. "is.j @ 0x1000" and "is.j @ 0x2000" are both "is.j").
+ */
+static void replay_account(replay_t *replay, uint8_t kind, const char *request, size_t size, uint32_t bytes, int miss) {
+	char name[32];
+	const char *native = NULL;
+	switch (kind) {
+	case TRACE_CONFIG:
+		native = "config.get";
+		break;
+	case TRACE_READ:
+		native = "read";
+		break;
+	case TRACE_FINGERPRINT:
+		native = "fingerprint";
+		break;
+	case TRACE_BODY_HASH:
+		native = "bodyHash";
+		break;
+	case TRACE_FILE:
+		native = "readFile";
+		break;
+	default:
+		break;
+	}
+	size_t length = 0;
+	if (native) {
+		length = strlen(native);
+		request = native;
+	} else {
+		while (length < size && length < sizeof(name) - 1 && request[length] != ' ') {
+			length++;
+		}
+	}
+	memcpy(name, request, length);
+	name[length] = 0;
+
+	replay_stat_t *stat = NULL;
+	for (uint32_t i = 0; i < replay->n_stats && !stat; ++i) {
+		if (!strcmp(replay->stats[i].name, name)) {
+			stat = &replay->stats[i];
+		}
+	}
+	if (!stat) {
+		replay_stat_t *stats = realloc(replay->stats, (replay->n_stats + 1) * sizeof(replay_stat_t));
+		if (!stats) {
+			return;
+		}
+		replay->stats = stats;
+		stat = &stats[replay->n_stats++];
+		memset(stat, 0, sizeof(replay_stat_t));
+		strcpy(stat->name, name);
+	}
+	stat->count++;
+	stat->bytes += bytes;
+	stat->misses += miss;
+}
+
+/**
+ * Returns the recorded response; the run is expected to issue the requests
+ * in the recorded order, thus the search starts after the last match and
+ * wraps to the start of the run for the repeated ones.
+ */
+static const trace_record_t *replay_find(replay_t *replay, uint8_t kind, const char *request, size_t size) {
+	const trace_record_t *records = replay->trace->records;
+	const trace_record_t *found = NULL;
+	for (uint32_t pass = 0; pass < 2 && !found; ++pass) {
+		uint32_t from = pass ? replay->first : replay->cursor;
+		uint32_t to = pass ? replay->cursor : replay->end;
+		for (uint32_t i = from; i < to; ++i) {
+			if (records[i].kind == kind && records[i].request_size == size && !memcmp(records[i].request, request, size)) {
+				found = &records[i];
+				replay->cursor = i + 1;
+				break;
+			}
+		}
+	}
+	replay_account(replay, kind, request, size, found ? found->response_size : 0, !found);
+	return found;
+}
+
+/**
+ * Empty responses of the nullable kinds are recorded null values.
+ */
+static JSValue replay_string(JSContext *ctx, uint8_t kind, const char *request, size_t size, int nullable) {
+	standalone_t *sa = (standalone_t *)JS_GetContextOpaque(ctx);
+	const trace_record_t *record = replay_find(sa->replay, kind, request, size);
+	if (!record || !record->response_size) {
+		return nullable ? JS_NULL : JS_NewString(ctx, "");
+	}
+	return JS_NewStringLen(ctx, record->response, record->response_size);
+}
+
+static JSValue replay_value(JSContext *ctx, uint8_t kind, JSValueConst request, int nullable) {
+	size_t size = 0;
+	const char *str = JS_ToCStringLen(ctx, &size, request);
+	if (!str) {
+		return JS_EXCEPTION;
+	}
+	JSValue result = replay_string(ctx, kind, str, size, nullable);
+	JS_FreeCString(ctx, str);
+	return result;
+}
+
+/**
+ * Natives keyed by their optional address (see trace_address in the plugin).
+ */
+static JSValue replay_address(JSContext *ctx, uint8_t kind, int argc, JSValueConst *argv) {
+	if (argc > 0 && JS_IsString(argv[0])) {
+		return replay_value(ctx, kind, argv[0], 1);
+	}
+	return replay_string(ctx, kind, "", 0, 1);
+}
 
+static JSValue js_replay_command(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 1) {
+		return JS_EXCEPTION;
+	}
+	return replay_value(ctx, TRACE_COMMAND, argv[0], 0);
+}
+
+static JSValue js_replay_read_file(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 1) {
+		return JS_ThrowTypeError(ctx, "readFile expects (path)");
+	}
+	return replay_value(ctx, TRACE_FILE, argv[0], 1);
+}
+
+static JSValue js_replay_config_get(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 1) {
+		return JS_EXCEPTION;
+	} else if (!JS_IsArray(ctx, argv[0])) {
+		return replay_value(ctx, TRACE_CONFIG, argv[0], 0);
+	}
+
+	JSValue jslen = JS_GetPropertyStr(ctx, argv[0], "length");
+	uint32_t length = 0;
+	if (JS_ToUint32(ctx, &length, jslen)) {
+		JS_FreeValue(ctx, jslen);
+		return JS_EXCEPTION;
+	}
+	JS_FreeValue(ctx, jslen);
+
+	JSValue result = JS_NewObject(ctx);
+	for (uint32_t i = 0; i < length; ++i) {
+		JSValue jsname = JS_GetPropertyUint32(ctx, argv[0], i);
+		size_t size = 0;
+		const char *name = JS_ToCStringLen(ctx, &size, jsname);
+		JS_FreeValue(ctx, jsname);
+		if (!name) {
+			JS_FreeValue(ctx, result);
+			return JS_EXCEPTION;
+		}
+		JS_SetPropertyStr(ctx, result, name, replay_string(ctx, TRACE_CONFIG, name, size, 0));
+		JS_FreeCString(ctx, name);
+	}
+	return result;
+}
+
+/**
+ * What the plugin changes in radare2 (config overrides, comments and code
+ * lines) has no effect on the recorded responses, thus it is ignored.
+ */
+static JSValue js_replay_nop(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	return JS_UNDEFINED;
+}
+
+static JSValue js_replay_read(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	if (argc != 2) {
+		return JS_ThrowTypeError(ctx, "read expects (address, length)");
+	}
+	uint64_t addr = 0;
+	if (JS_IsString(argv[0])) {
+		const char *saddr = JS_ToCString(ctx, argv[0]);
+		if (!saddr) {
+			return JS_EXCEPTION;
+		}
+		addr = strtoull(saddr, NULL, 16);
+		JS_FreeCString(ctx, saddr);
+	} else if (JS_ToBigInt64(ctx, (int64_t *)&addr, argv[0])) {
+		return JS_EXCEPTION;
+	}
+	uint32_t length = 0;
+	if (JS_ToUint32(ctx, &length, argv[1])) {
+		return JS_EXCEPTION;
+	}
+
+	// same request format of the plugin js_read.
+	standalone_t *sa = (standalone_t *)JS_GetContextOpaque(ctx);
+	char request[64];
+	int size = snprintf(request, sizeof(request), "0x%llx %u", (unsigned long long)addr, length);
+	const trace_record_t *record = replay_find(sa->replay, TRACE_READ, request, size);
+	if (!record || !record->response_size) {
+		return JS_NULL;
+	}
+	return JS_NewArrayBufferCopy(ctx, (const uint8_t *)record->response, record->response_size);
+}
+
+static JSValue js_replay_fingerprint(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	return replay_address(ctx, TRACE_FINGERPRINT, argc, argv);
+}
+
+static JSValue js_replay_body_hash(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	JSValue json = replay_address(ctx, TRACE_BODY_HASH, argc, argv);
+	if (!JS_IsString(json)) {
+		return json;
+	}
+	size_t size = 0;
+	const char *str = JS_ToCStringLen(ctx, &size, json);
+	JS_FreeValue(ctx, json);
+	if (!str) {
+		return JS_EXCEPTION;
+	}
+	JSValue result = JS_ParseJSON(ctx, str, size, "bodyHash");
+	JS_FreeCString(ctx, str);
+	return result;
+}
+
+/**
+ * Replaces the null radare2 object of the testsuite; the testsuite main
+ * runs the plugin main when radare2 is set.
+ */
+static void replay_install(standalone_t *sa, replay_t *replay) {
+	JSContext *ctx = r2dec_context(sa->dec);
+	sa->replay = replay;
+
+	JSValue global = JS_GetGlobalObject(ctx);
+	JSValue radare2 = JS_NewObject(ctx);
+	JS_SetPropertyStr(ctx, global, "radare2", radare2);
+	JS_SetPropertyStr(ctx, radare2, "command", JS_NewCFunction(ctx, js_replay_command, "command", 1));
+	JS_SetPropertyStr(ctx, radare2, "comments", JS_NewCFunction(ctx, js_replay_nop, "comments", 1));
+	JS_SetPropertyStr(ctx, radare2, "codelines", JS_NewCFunction(ctx, js_replay_nop, "codelines", 1));
+	JS_SetPropertyStr(ctx, radare2, "read", JS_NewCFunction(ctx, js_replay_read, "read", 2));
+	JS_SetPropertyStr(ctx, radare2, "readFile", JS_NewCFunction(ctx, js_replay_read_file, "readFile", 1));
+	JS_SetPropertyStr(ctx, radare2, "fingerprint", JS_NewCFunction(ctx, js_replay_fingerprint, "fingerprint", 1));
+	JS_SetPropertyStr(ctx, radare2, "bodyHash", JS_NewCFunction(ctx, js_replay_body_hash, "bodyHash", 1));
+
+	JSValue config = JS_NewObject(ctx);
+	JS_SetPropertyStr(ctx, radare2, "config", config);
+	JS_SetPropertyStr(ctx, config, "get", JS_NewCFunction(ctx, js_replay_config_get, "get", 1));
+	JS_SetPropertyStr(ctx, config, "push", JS_NewCFunction(ctx, js_replay_nop, "push", 1));
+	JS_SetPropertyStr(ctx, config, "pop", JS_NewCFunction(ctx, js_replay_nop, "pop", 0));
+
+	JS_SetPropertyStr(ctx, global, "process", JS_NewObject(ctx));
 	JS_FreeValue(ctx, global);
+}
+
+/**
+ * Sets process.args like the plugin does (the arguments are split on spaces)
+ * and the recorded radare2.version.
+ */
+static void replay_set_args(standalone_t *sa, const trace_record_t *record) {
+	JSContext *ctx = r2dec_context(sa->dec);
+	JSValue global = JS_GetGlobalObject(ctx);
+	JSValue radare2 = JS_GetPropertyStr(ctx, global, "radare2");
+	JS_SetPropertyStr(ctx, radare2, "version", JS_NewStringLen(ctx, record->response, record->response_size));
+	JS_FreeValue(ctx, radare2);
+	JSValue process = JS_GetPropertyStr(ctx, global, "process");
+	JSValue args = JS_NewArray(ctx);
+	uint32_t n_args = 0;
+	const char *arg = record->request;
+	const char *end = record->request + record->request_size;
+	// the arguments are already split by the plugin, each ended by NUL.
+	while (arg < end) {
+		const char *nul = memchr(arg, 0, end - arg);
+		size_t length = nul ? (size_t)(nul - arg) : (size_t)(end - arg);
+		JS_SetPropertyUint32(ctx, args, n_args++, JS_NewStringLen(ctx, arg, length));
+		arg += length + 1;
+	}
+	JS_SetPropertyStr(ctx, process, "args", args);
+	JS_FreeValue(ctx, process);
+	JS_FreeValue(ctx, global);
+}
+
+static double replay_msecs(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static int replay_stat_compare(const void *a, const void *b) {
+	const replay_stat_t *x = (const replay_stat_t *)a;
+	const replay_stat_t *y = (const replay_stat_t *)b;
+	if (x->bytes != y->bytes) {
+		return x->bytes > y->bytes ? -1 : 1;
+	}
+	return x->count > y->count ? -1 : (x->count < y->count);
+}
+
+static void replay_report(replay_t *replay, uint32_t n_runs, double msecs) {
+	uint64_t count = 0, bytes = 0, misses = 0;
+	if (replay->n_stats > 0) {
+		qsort(replay->stats, replay->n_stats, sizeof(replay_stat_t), replay_stat_compare);
+	}
+	errorf("replay: %u runs in %.3f ms\n", n_runs, msecs);
+	errorf("%-16s %10s %14s %8s\n", "request", "count", "bytes", "misses");
+	for (uint32_t i = 0; i < replay->n_stats; ++i) {
+		const replay_stat_t *stat = &replay->stats[i];
+		errorf("%-16s %10llu %14llu %8llu\n", stat->name, (unsigned long long)stat->count, (unsigned long long)stat->bytes, (unsigned long long)stat->misses);
+		count += stat->count;
+		bytes += stat->bytes;
+		misses += stat->misses;
+	}
+	errorf("%-16s %10llu %14llu %8llu\n", "total", (unsigned long long)count, (unsigned long long)bytes, (unsigned long long)misses);
+}
+
+/**
+ * Replays all the runs of the trace on the same runtime, like the plugin
+ * keeps it between the pdd commands of a session.
+ */
+static int replay_run(standalone_t *sa, replay_t *replay) {
+	const trace_t *trace = replay->trace;
+	uint32_t n_runs = 0;
+	int ok = 1;
+	replay_install(sa, replay);
+
+	double start = replay_msecs();
+	for (uint32_t i = 0; i < trace->n_records; i = replay->end) {
+		if (trace->records[i].kind != TRACE_ARGS) {
+			// records before the first run (i.e. pddT started in the middle of one).
+			replay->end = i + 1;
+			continue;
+		}
+		replay->first = replay->cursor = i + 1;
+		replay->end = replay->first;
+		while (replay->end < trace->n_records && trace->records[replay->end].kind != TRACE_ARGS) {
+			replay->end++;
+		}
+		replay_set_args(sa, &trace->records[i]);
+		if (!r2dec_run(sa->dec)) {
+			ok = 0;
+		}
+		output_flush(sa);
+		n_runs++;
+	}
+	replay_report(replay, n_runs, replay_msecs() - start);
+	return ok;
+}
+
+#define MERGE_SHARD    "/* r2dec:shard "
+#define MERGE_HEADER   "/* r2dec:header */"
+#define MERGE_FUNCTION "/* r2dec:function "
+#define MERGE_END      "/* r2dec:end */"
+
+/* a function section or a header block of a pddf shard (points into the shard buffer) */
+typedef struct merge_function_s {
+	unsigned long long addr;
+	const char *text;
+	size_t size;
+} merge_function_t;
+
+static int merge_compare(const void *a, const void *b) {
+	const merge_function_t *x = (const merge_function_t *)a;
+	const merge_function_t *y = (const merge_function_t *)b;
+	if (x->addr != y->addr) {
+		return x->addr < y->addr ? -1 : 1;
+	}
+	// keeps the first shard when the same function is in many.
+	return x->text < y->text ? -1 : (x->text > y->text);
+}
+
+/**
+ * Adds a header block (a comment, a macro or a dependency) unless an equal
+ * block has already been added by a previous shard.
+ */
+static int merge_add_block(buffer_t *header, const char *text, size_t size) {
+	const merge_function_t *blocks = (const merge_function_t *)header->data;
+	size_t n_blocks = header->size / sizeof(merge_function_t);
+	if (!size) {
+		return 1;
+	}
+	for (size_t i = 0; i < n_blocks; ++i) {
+		if (blocks[i].size == size && !memcmp(blocks[i].text, text, size)) {
+			return 1;
+		}
+	}
+	merge_function_t block = { 0, text, size };
+	return buffer_append(header, (const char *)&block, sizeof(block));
+}
+
+/**
+ * Parses the header and function sections of a shard; the header is made
+ * of blocks ended by an empty line, the merged header is the union of the
+ * blocks of all the shards.
+ */
+static int merge_parse(const char *file, const char *raw, buffer_t *header, buffer_t *functions) {
+	merge_function_t current = { 0 };
+	int in_header = 0, in_function = 0, is_shard = 0;
+	const char *block = NULL;
+	const char *p = raw;
+	while (p && *p) {
+		const char *eol = strchr(p, '\n');
+		size_t length = eol ? (size_t)(eol - p) : strlen(p);
+		const char *next = eol ? eol + 1 : NULL;
+		if (!strncmp(p, MERGE_SHARD, strlen(MERGE_SHARD))) {
+			is_shard = 1;
+		} else if (length == strlen(MERGE_HEADER) && !strncmp(p, MERGE_HEADER, length)) {
+			in_header = 1;
+			block = next;
+		} else if (!strncmp(p, MERGE_FUNCTION, strlen(MERGE_FUNCTION))) {
+			current.addr = strtoull(p + strlen(MERGE_FUNCTION), NULL, 16);
+			current.text = next ? next : p + length;
+			in_function = 1;
+		} else if (length == strlen(MERGE_END) && !strncmp(p, MERGE_END, length)) {
+			if (in_header && block && !merge_add_block(header, block, p - block)) {
+				errorf("Error: ENOMEM while merging '%s'\n", file);
+				return 0;
+			}
+			if (in_function) {
+				current.size = p - current.text;
+				if (!buffer_append(functions, (const char *)&current, sizeof(current))) {
+					errorf("Error: ENOMEM while merging '%s'\n", file);
+					return 0;
+				}
+			}
+			in_header = in_function = 0;
+		} else if (in_header) {
+			int blank = 1;
+			for (size_t i = 0; i < length && blank; ++i) {
+				blank = p[i] == ' ' || p[i] == '\t' || p[i] == '\r';
+			}
+			if (blank) {
+				if (!merge_add_block(header, block, p - block)) {
+					errorf("Error: ENOMEM while merging '%s'\n", file);
+					return 0;
+				}
+				block = next;
+			}
+		}
+		p = next;
+	}
+	if (!is_shard) {
+		errorf("Error: '%s' is not a pddf shard (see pddf --shard)\n", file);
+		return 0;
+	}
 	return 1;
 }
 
-static void fini_testsuite(r2dec_t *dec) {
-	JSContext *ctx = r2dec_context(dec);
-	JS_FreeValue(ctx, shared);
-	r2dec_free(dec);
+/**
+ * r2dec-standalone --merge: combines the outputs of pddf --shard/--range/--functions
+ * with a single header block and the functions in address order.
+ */
+static int merge_main(const char *output, int n_files, char const *files[]) {
+	buffer_t header = { 0 }, functions = { 0 };
+	char **raws = calloc(n_files, sizeof(char *));
+	FILE *out = stdout;
+	int ret = 1;
+	if (!raws) {
+		errorf("Error: ENOMEM while merging\n");
+		return 1;
+	}
+
+	for (int i = 0; i < n_files; ++i) {
+		if (!(raws[i] = read_file(files[i])) || !merge_parse(files[i], raws[i], &header, &functions)) {
+			goto end;
+		}
+	}
+
+	if (output && !(out = fopen(output, "wb"))) {
+		errorf("Error: failed opening file '%s'\n", output);
+		out = NULL;
+		goto end;
+	}
+
+	merge_function_t *fcns = (merge_function_t *)functions.data;
+	size_t n_fcns = functions.size / sizeof(merge_function_t);
+	if (n_fcns > 0) {
+		qsort(fcns, n_fcns, sizeof(merge_function_t), merge_compare);
+	}
+	// one-line blocks (comments and macros) are kept together.
+	merge_function_t *blocks = (merge_function_t *)header.data;
+	size_t n_blocks = header.size / sizeof(merge_function_t);
+	int separated = 1;
+	for (size_t i = 0; i < n_blocks; ++i) {
+		int multiline = memchr(blocks[i].text, '\n', blocks[i].size) != blocks[i].text + blocks[i].size - 1;
+		if (multiline && !separated) {
+			fputs(" \n", out);
+		}
+		fwrite(blocks[i].text, 1, blocks[i].size, out);
+		separated = multiline || i + 1 == n_blocks;
+		if (separated) {
+			fputs(" \n", out);
+		}
+	}
+	for (size_t i = 0; i < n_fcns; ++i) {
+		if (i > 0 && fcns[i].addr == fcns[i - 1].addr) {
+			continue;
+		}
+		fwrite(fcns[i].text, 1, fcns[i].size, out);
+	}
+	ret = 0;
+
+end:
+	if (out && out != stdout) {
+		fclose(out);
+	}
+	for (int i = 0; i < n_files; ++i) {
+		free(raws[i]);
+	}
+	free(raws);
+	free(header.data);
+	free(functions.data);
+	return ret;
+}
+
+/**
+ * r2dec-standalone --pack: converts an issue json into the binary issue (see c/issue.h).
+ */
+static int pack_main(const char *input, const char *output) {
+	char *raw = read_file(input);
+	if (!raw) {
+		return 1;
+	}
+	issue_writer_t *writer = issue_create(output);
+	if (!writer) {
+		errorf("Error: failed opening file '%s'\n", output);
+		free(raw);
+		return 1;
+	}
+	uint64_t bytes = 0;
+	int ok = issue_pack(writer, raw, strlen(raw));
+	if (!issue_close(writer, &bytes) || !ok) {
+		errorf("Error: failed to convert '%s'\n", input);
+		free(raw);
+		unlink(output);
+		return 1;
+	}
+	errorf("%s: %zu -> %llu bytes\n", output, strlen(raw), (unsigned long long)bytes);
+	free(raw);
+	return 0;
+}
+
+static void usage(const char *name) {
+	errorf("usage: %s [--arena] [--profile] [--sample <out.folded> [--sample-hz <hz>]] <issue.json>\n", name);
+	errorf("       %s [--arena] [--profile] [--sample <out.folded> [--sample-hz <hz>]] --replay <trace>\n", name);
+	errorf("       %s --server [-a] [-p] [-j <workers>] [-t <timeout ms>] [-s <unix socket>]\n", name);
+	errorf("       %s --merge [-o <output>] <shard> [<shard> ...]\n", name);
+	errorf("       %s --pack <issue.json> <issue.bin>\n", name);
 }
 
 int main(int argc, char const *argv[]) {
-	if (argc != 2 || !strcmp(argv[1], "-h")) {
-		errorf("usage: %s <issue.json>\n", argv[0]);
+	if (argc < 2 || !strcmp(argv[1], "-h")) {
+		usage(argv[0]);
 		return 1;
 	}
 
-	r2dec_t *dec = NULL;
-	char *raw = read_file(argv[1]);
-	if (!raw) {
+	if (!strcmp(argv[1], "--server")) {
+		const char *socket_path = NULL;
+		int n_workers = 1;
+		uint32_t timeout = 0;
+		uint32_t flags = 0;
+		for (int i = 2; i < argc; ++i) {
+			if (!strcmp(argv[i], "-a")) {
+				flags |= R2DEC_ARENA;
+			} else if (!strcmp(argv[i], "-p")) {
+				flags |= R2DEC_PROFILE;
+			} else if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+				n_workers = atoi(argv[++i]);
+			} else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+				timeout = strtoul(argv[++i], NULL, 10);
+			} else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+				socket_path = argv[++i];
+			} else {
+				usage(argv[0]);
+				return 1;
+			}
+		}
+		if (n_workers < 1) {
+			n_workers = 1;
+		}
+		return server_main(socket_path, n_workers, timeout, flags);
+	} else if (!strcmp(argv[1], "--merge")) {
+		const char *output = NULL;
+		int first = 2;
+		if (argc > 3 && !strcmp(argv[2], "-o")) {
+			output = argv[3];
+			first = 4;
+		}
+		if (first >= argc) {
+			usage(argv[0]);
+			return 1;
+		}
+		return merge_main(output, argc - first, argv + first);
+	} else if (!strcmp(argv[1], "--pack")) {
+		if (argc != 4) {
+			usage(argv[0]);
+			return 1;
+		}
+		return pack_main(argv[2], argv[3]);
+	}
+
+	uint32_t flags = 0;
+	const char *samples = NULL;
+	uint32_t sample_hz = R2DEC_SAMPLE_HZ;
+	int replay_mode = 0;
+	int first = 1;
+	for (; first < argc - 1; ++first) {
+		if (!strcmp(argv[first], "--arena")) {
+			flags |= R2DEC_ARENA;
+		} else if (!strcmp(argv[first], "--profile")) {
+			flags |= R2DEC_PROFILE;
+		} else if (!strcmp(argv[first], "--sample") && first + 2 < argc) {
+			samples = argv[++first];
+		} else if (!strcmp(argv[first], "--sample-hz") && first + 2 < argc) {
+			sample_hz = strtoul(argv[++first], NULL, 10);
+		} else if (!strcmp(argv[first], "--replay")) {
+			replay_mode = 1;
+		} else {
+			break;
+		}
+	}
+	if (first != argc - 1) {
+		usage(argv[0]);
 		return 1;
 	}
 
-	if (!(dec = r2dec_new())) {
-		free(raw);
+	const char *file = argv[first];
+	replay_t *replay = NULL;
+	issue_t *issue = NULL;
+	char *raw = NULL;
+	if (replay_mode) {
+		if (!(replay = replay_new(file))) {
+			return 1;
+		}
+	} else if (!(issue = issue_map(file)) && !(raw = read_file(file))) {
 		return 1;
 	}
 
-	init_testsuite(dec, argv[1], raw);
+	standalone_t *sa = init_testsuite(file, raw, flags);
 	free(raw);
+	if (!sa) {
+		replay_free(replay);
+		issue_unmap(issue);
+		return 1;
+	} else if (issue) {
+		set_testsuite_issue(sa, file, issue);
+	}
 
-	int ret = !r2dec_run(dec);
+	int ret = 1;
+	if (samples && !r2dec_sample_start(sa->dec, samples, sample_hz)) {
+		goto end;
+	}
+	ret = replay ? !replay_run(sa, replay) : !r2dec_run(sa->dec);
 
-	fini_testsuite(dec);
+end:
+	fini_testsuite(sa);
+	replay_free(replay);
 	return ret;
 }
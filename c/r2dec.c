@@ -4,14 +4,25 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 
+#include "arena.h"
 #include "base64.h"
+#include "db.h"
 #include "r2dec.h"
 #include "js/bytecode.h"
 
 struct r2dec_s {
 	JSRuntime *runtime;
 	JSContext *context;
+	arena_t *arena; // NULL when the runtime uses the system malloc
+	struct profile_s *profile; // NULL when the heap traffic is not counted
+	struct sampler_s *sampler; // NULL when the stacks are not sampled
+	uint32_t flags;
+	int loaded;
+	uint32_t timeout;
+	double deadline;
+	int timed_out;
 };
 
 #define macro_str(s) #s
@@ -111,13 +122,295 @@ static int js_load_module(JSContext *ctx, const uint8_t *bytes, const uint32_t s
 
 #include "js/bytecode_mod.h"
 
+static double now_msecs(void) {
+	struct timespec ts;
+	timespec_get(&ts, TIME_UTC);
+	return (ts.tv_sec * 1000.0) + (ts.tv_nsec / 1000000.0);
+}
+
+/*
+ * Sampling profiler.
+ *
+ * quickjs calls the interrupt handler every few thousand opcodes; at most
+ * once per period it takes the javascript stack and counts it. The stack
+ * comes from the backtrace of an error that is thrown and caught on the
+ * spot. The counted stacks are written in the folded format
+ * ("root;...;leaf count") read by flamegraph.pl and similar tools, where
+ * each frame is "function (file:line)".
+ */
+
+#define SAMPLER_MAX_DEPTH 128
+#define SAMPLER_FRAME_MAX 256
+
+typedef struct sample_s {
+	char *stack;
+	uint64_t hash;
+	uint32_t count;
+} sample_t;
+
+typedef struct sampler_s {
+	char *file;
+	uint32_t hz;
+	double period;
+	double next;
+	sample_t *table; // open addressing, size is a power of two
+	uint32_t size;
+	uint32_t used;
+	uint64_t total;
+	int busy;
+	JSValue error; // the Error constructor
+} sampler_t;
+
+static uint64_t sample_hash(const char *stack) {
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (; *stack; stack++) {
+		hash = (hash ^ (uint8_t)*stack) * 0x100000001b3ull;
+	}
+	return hash;
+}
+
+static int sampler_grow(sampler_t *sampler) {
+	uint32_t size = sampler->size ? sampler->size * 2 : 1024;
+	sample_t *table = calloc(size, sizeof(sample_t));
+	if (!table) {
+		return 0;
+	}
+	for (uint32_t i = 0; i < sampler->size; ++i) {
+		sample_t *sample = &sampler->table[i];
+		if (!sample->stack) {
+			continue;
+		}
+		uint32_t j = sample->hash & (size - 1);
+		while (table[j].stack) {
+			j = (j + 1) & (size - 1);
+		}
+		table[j] = *sample;
+	}
+	free(sampler->table);
+	sampler->table = table;
+	sampler->size = size;
+	return 1;
+}
+
+static void sampler_count(sampler_t *sampler, char *stack) {
+	if (sampler->used * 4 >= sampler->size * 3 && !sampler_grow(sampler)) {
+		free(stack);
+		return;
+	}
+	uint64_t hash = sample_hash(stack);
+	uint32_t i = hash & (sampler->size - 1);
+	while (sampler->table[i].stack) {
+		sample_t *sample = &sampler->table[i];
+		if (sample->hash == hash && !strcmp(sample->stack, stack)) {
+			sample->count++;
+			sampler->total++;
+			free(stack);
+			return;
+		}
+		i = (i + 1) & (sampler->size - 1);
+	}
+	sampler->table[i].stack = stack;
+	sampler->table[i].hash = hash;
+	sampler->table[i].count = 1;
+	sampler->used++;
+	sampler->total++;
+}
+
+/**
+ * Converts a backtrace ("    at name (file:line:column)", leaf first)
+ * into a folded stack (root first, frames separated by ';').
+ */
+static char *sampler_fold(const char *backtrace) {
+	const char *frames[SAMPLER_MAX_DEPTH];
+	size_t lengths[SAMPLER_MAX_DEPTH];
+	int depth = 0;
+	size_t total = 0;
+	const char *line = backtrace;
+	while (line && *line && depth < SAMPLER_MAX_DEPTH) {
+		const char *end = strchr(line, '\n');
+		size_t length = end ? (size_t)(end - line) : strlen(line);
+		const char *at = strstr(line, "at ");
+		if (at && at < line + length) {
+			frames[depth] = at + 3;
+			lengths[depth] = length - (size_t)(at + 3 - line);
+			total += lengths[depth] + 1;
+			depth++;
+		}
+		line = end ? end + 1 : NULL;
+	}
+	if (depth < 1) {
+		return NULL;
+	}
+
+	char *stack = malloc(total + 1);
+	if (!stack) {
+		return NULL;
+	}
+	char *p = stack;
+	for (int i = depth - 1; i >= 0; --i) {
+		char frame[SAMPLER_FRAME_MAX];
+		size_t length = lengths[i] < sizeof(frame) - 1 ? lengths[i] : sizeof(frame) - 1;
+		memcpy(frame, frames[i], length);
+		frame[length] = 0;
+		// drops the column; "(file:line:column)" becomes "(file:line)".
+		char *close = strrchr(frame, ')');
+		char *column = close ? close - 1 : NULL;
+		while (column && column > frame && *column >= '0' && *column <= '9') {
+			column--;
+		}
+		if (column && *column == ':' && strchr(frame, ':') != column) {
+			memmove(column, close, strlen(close) + 1);
+		}
+		for (char *c = frame; *c; c++) {
+			if (*c == ';') {
+				*c = ':';
+			}
+		}
+		length = strlen(frame);
+		memcpy(p, frame, length);
+		p += length;
+		*p++ = i ? ';' : 0;
+	}
+	return stack;
+}
+
+/**
+ * The stack is the one of a new Error, built without throwing it; a pending
+ * exception is never touched and Error.stackTraceLimit (the default limit of
+ * 10 frames would cut the stacks) is raised only while the Error is built.
+ */
+static void sampler_take(r2dec_t *dec) {
+	sampler_t *sampler = dec->sampler;
+	JSContext *ctx = dec->context;
+	if (JS_HasException(ctx)) {
+		return;
+	}
+	sampler->busy = 1;
+	JSValue limit = JS_GetPropertyStr(ctx, sampler->error, "stackTraceLimit");
+	JS_SetPropertyStr(ctx, sampler->error, "stackTraceLimit", JS_NewInt32(ctx, SAMPLER_MAX_DEPTH));
+	JSValue error = JS_CallConstructor(ctx, sampler->error, 0, NULL);
+	JS_SetPropertyStr(ctx, sampler->error, "stackTraceLimit", limit);
+	if (JS_IsException(error)) {
+		// only the exception of the constructor can be pending here.
+		JS_FreeValue(ctx, JS_GetException(ctx));
+		sampler->busy = 0;
+		return;
+	}
+	JSValue backtrace = JS_GetPropertyStr(ctx, error, "stack");
+	const char *text = JS_IsString(backtrace) ? JS_ToCString(ctx, backtrace) : NULL;
+	if (text) {
+		char *stack = sampler_fold(text);
+		if (stack) {
+			sampler_count(sampler, stack);
+		}
+		JS_FreeCString(ctx, text);
+	}
+	JS_FreeValue(ctx, backtrace);
+	JS_FreeValue(ctx, error);
+	sampler->busy = 0;
+}
+
+static int sampler_write(const sampler_t *sampler) {
+	FILE *fp = fopen(sampler->file, "w");
+	if (!fp) {
+		errorf("Error: cannot write samples to %s\n", sampler->file);
+		return 0;
+	}
+	for (uint32_t i = 0; i < sampler->size; ++i) {
+		const sample_t *sample = &sampler->table[i];
+		if (sample->stack) {
+			fprintf(fp, "%s %u\n", sample->stack, sample->count);
+		}
+	}
+	fclose(fp);
+	return 1;
+}
+
+static void sampler_free(JSContext *ctx, sampler_t *sampler) {
+	if (!sampler) {
+		return;
+	}
+	for (uint32_t i = 0; i < sampler->size; ++i) {
+		free(sampler->table[i].stack);
+	}
+	JS_FreeValue(ctx, sampler->error);
+	free(sampler->table);
+	free(sampler->file);
+	free(sampler);
+}
+
+/**
+ * Samples the javascript stack hz times per second (while it runs) and
+ * rewrites file with the folded stacks at the end of every run.
+ */
+int r2dec_sample_start(r2dec_t *dec, const char *file, uint32_t hz) {
+	r2dec_sample_stop(dec);
+	sampler_t *sampler = calloc(1, sizeof(sampler_t));
+	if (!sampler || !(sampler->file = strdup(file))) {
+		errorf("Error: failed to allocate the sampler\n");
+		free(sampler);
+		return 0;
+	}
+	sampler->hz = hz > 0 ? hz : R2DEC_SAMPLE_HZ;
+	sampler->period = 1000.0 / sampler->hz;
+
+	JSValue global = JS_GetGlobalObject(dec->context);
+	sampler->error = JS_GetPropertyStr(dec->context, global, "Error");
+	JS_FreeValue(dec->context, global);
+
+	dec->sampler = sampler;
+	return 1;
+}
+
+void r2dec_sample_stop(r2dec_t *dec) {
+	sampler_t *sampler = dec->sampler;
+	if (!sampler) {
+		return;
+	}
+	sampler_free(dec->context, sampler);
+	dec->sampler = NULL;
+}
+
+const char *r2dec_sample_file(const r2dec_t *dec, uint32_t *hz, uint64_t *samples) {
+	if (!dec->sampler) {
+		return NULL;
+	}
+	if (hz) {
+		*hz = dec->sampler->hz;
+	}
+	if (samples) {
+		*samples = dec->sampler->total;
+	}
+	return dec->sampler->file;
+}
+
+static int js_interrupt_handler(JSRuntime *rt, void *opaque) {
+	r2dec_t *dec = (r2dec_t *)opaque;
+	sampler_t *sampler = dec->sampler;
+	if (sampler && !sampler->busy) {
+		double now = now_msecs();
+		if (now >= sampler->next) {
+			sampler->next = now + sampler->period;
+			sampler_take(dec);
+		}
+	}
+	if (dec->deadline > 0 && now_msecs() >= dec->deadline) {
+		dec->timed_out = 1;
+		return 1;
+	}
+	return 0;
+}
+
 void r2dec_free(r2dec_t *dec) {
 	if (!dec) {
 		return;
 	}
 
+	sampler_free(dec->context, dec->sampler);
 	JS_FreeContext(dec->context);
 	JS_FreeRuntime(dec->runtime);
+	arena_free(dec->arena);
+	free(dec->profile);
 	free(dec);
 }
 
@@ -174,10 +467,270 @@ static JSValue js_btoa(JSContext *ctx, JSValueConst jsThis, int argc, JSValueCon
 	return result;
 }
 
-r2dec_t *r2dec_new() {
-	JSRuntime *rt = JS_NewRuntime();
+static void *js_arena_calloc(void *opaque, size_t count, size_t size) {
+	return arena_calloc((arena_t *)opaque, count, size);
+}
+
+static void *js_arena_malloc(void *opaque, size_t size) {
+	return arena_alloc((arena_t *)opaque, size);
+}
+
+static void js_arena_free(void *opaque, void *ptr) {
+	arena_release((arena_t *)opaque, ptr);
+}
+
+static void *js_arena_realloc(void *opaque, void *ptr, size_t size) {
+	return arena_realloc((arena_t *)opaque, ptr, size);
+}
+
+static const JSMallocFunctions js_arena_functions = {
+	.js_calloc = js_arena_calloc,
+	.js_malloc = js_arena_malloc,
+	.js_free = js_arena_free,
+	.js_realloc = js_arena_realloc,
+	.js_malloc_usable_size = arena_usable_size,
+};
+
+/*
+ * Allocation profiler (R2DEC_PROFILE).
+ *
+ * Every block is prefixed by its requested size, and the traffic is
+ * counted in the phase set by r2dec.phase(name). The blocks come from
+ * the arena when R2DEC_ARENA is also set. Without R2DEC_PROFILE the runtime
+ * uses the allocator directly, so it costs nothing.
+ */
+
+#define PROFILE_MAX_PHASES 32
+#define PROFILE_NAME_SIZE  32
+#define PROFILE_HEADER     16
+
+typedef struct profile_phase_s {
+	char name[PROFILE_NAME_SIZE];
+	uint64_t allocs;
+	uint64_t frees;
+	uint64_t bytes; // allocated
+	uint64_t freed;
+	uint64_t peak; // highest live bytes while the phase was active
+} profile_phase_t;
+
+typedef struct profile_s {
+	arena_t *arena;
+	profile_phase_t phases[PROFILE_MAX_PHASES];
+	uint32_t n_phases;
+	uint32_t current;
+	uint64_t live;
+	uint64_t peak; // highest live bytes since the last reset
+} profile_t;
+
+static profile_t *profile_new(arena_t *arena) {
+	profile_t *profile = calloc(1, sizeof(profile_t));
+	if (profile) {
+		profile->arena = arena;
+		profile->n_phases = 1;
+		strcpy(profile->phases[0].name, "none");
+	}
+	return profile;
+}
+
+static inline void profile_count_alloc(profile_t *profile, size_t size) {
+	profile_phase_t *phase = &profile->phases[profile->current];
+	phase->allocs++;
+	phase->bytes += size;
+	profile->live += size;
+	if (profile->live > phase->peak) {
+		phase->peak = profile->live;
+	}
+	if (profile->live > profile->peak) {
+		profile->peak = profile->live;
+	}
+}
+
+static inline void profile_count_free(profile_t *profile, size_t size) {
+	profile_phase_t *phase = &profile->phases[profile->current];
+	phase->frees++;
+	phase->freed += size;
+	profile->live -= size;
+}
+
+static void *js_profile_malloc(void *opaque, size_t size) {
+	profile_t *profile = (profile_t *)opaque;
+	size_t total = PROFILE_HEADER + size;
+	size_t *block = profile->arena ? arena_alloc(profile->arena, total) : malloc(total);
+	if (!block) {
+		return NULL;
+	}
+	*block = size;
+	profile_count_alloc(profile, size);
+	return (uint8_t *)block + PROFILE_HEADER;
+}
+
+static void *js_profile_calloc(void *opaque, size_t count, size_t size) {
+	if (size && count > SIZE_MAX / size) {
+		return NULL;
+	}
+	void *ptr = js_profile_malloc(opaque, count * size);
+	if (ptr) {
+		memset(ptr, 0, count * size);
+	}
+	return ptr;
+}
+
+static void js_profile_free(void *opaque, void *ptr) {
+	if (!ptr) {
+		return;
+	}
+	profile_t *profile = (profile_t *)opaque;
+	size_t *block = (size_t *)((uint8_t *)ptr - PROFILE_HEADER);
+	profile_count_free(profile, *block);
+	if (profile->arena) {
+		arena_release(profile->arena, block);
+	} else {
+		free(block);
+	}
+}
+
+static void *js_profile_realloc(void *opaque, void *ptr, size_t size) {
+	if (!ptr) {
+		return js_profile_malloc(opaque, size);
+	} else if (!size) {
+		js_profile_free(opaque, ptr);
+		return NULL;
+	}
+	profile_t *profile = (profile_t *)opaque;
+	size_t *block = (size_t *)((uint8_t *)ptr - PROFILE_HEADER);
+	size_t old = *block;
+	size_t total = PROFILE_HEADER + size;
+	block = profile->arena ? arena_realloc(profile->arena, block, total) : realloc(block, total);
+	if (!block) {
+		return NULL;
+	}
+	*block = size;
+	profile_count_free(profile, old);
+	profile_count_alloc(profile, size);
+	return (uint8_t *)block + PROFILE_HEADER;
+}
+
+static size_t js_profile_usable_size(const void *ptr) {
+	return ptr ? *(const size_t *)((const uint8_t *)ptr - PROFILE_HEADER) : 0;
+}
+
+static const JSMallocFunctions js_profile_functions = {
+	.js_calloc = js_profile_calloc,
+	.js_malloc = js_profile_malloc,
+	.js_free = js_profile_free,
+	.js_realloc = js_profile_realloc,
+	.js_malloc_usable_size = js_profile_usable_size,
+};
+
+/**
+ * r2dec.phase(name): the following allocations are counted in the named phase.
+ */
+static JSValue js_profile_phase(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	r2dec_t *dec = (r2dec_t *)JS_GetRuntimeOpaque(JS_GetRuntime(ctx));
+	profile_t *profile = dec->profile;
+	const char *name = argc > 0 ? JS_ToCString(ctx, argv[0]) : NULL;
+	if (!name) {
+		return JS_EXCEPTION;
+	}
+
+	uint32_t i;
+	for (i = 0; i < profile->n_phases; ++i) {
+		if (!strncmp(profile->phases[i].name, name, PROFILE_NAME_SIZE - 1)) {
+			break;
+		}
+	}
+	if (i == profile->n_phases && i < PROFILE_MAX_PHASES) {
+		snprintf(profile->phases[i].name, PROFILE_NAME_SIZE, "%s", name);
+		profile->n_phases++;
+	} else if (i == profile->n_phases) {
+		// too many phases; they are counted as the first one.
+		i = 0;
+	}
+	JS_FreeCString(ctx, name);
+
+	profile->current = i;
+	if (profile->live > profile->phases[i].peak) {
+		profile->phases[i].peak = profile->live;
+	}
+	return JS_UNDEFINED;
+}
+
+/**
+ * r2dec.profile(reset): returns the counters as
+ * { live, peak, phases: { name: { allocs, frees, bytes, freed, peak } } },
+ * with only the phases seen since the last reset.
+ */
+static JSValue js_profile_report(JSContext *ctx, JSValueConst jsThis, int argc, JSValueConst *argv) {
+	r2dec_t *dec = (r2dec_t *)JS_GetRuntimeOpaque(JS_GetRuntime(ctx));
+	profile_t *profile = dec->profile;
+	int reset = argc > 0 && JS_ToBool(ctx, argv[0]) > 0;
+
+	// the counters are taken before building the report.
+	profile_phase_t phases[PROFILE_MAX_PHASES];
+	uint32_t n_phases = profile->n_phases;
+	uint64_t live = profile->live, peak = profile->peak;
+	memcpy(phases, profile->phases, sizeof(profile_phase_t) * n_phases);
+
+	JSValue report = JS_NewObject(ctx);
+	JSValue list = JS_NewObject(ctx);
+	JS_SetPropertyStr(ctx, report, "live", JS_NewInt64(ctx, live));
+	JS_SetPropertyStr(ctx, report, "peak", JS_NewInt64(ctx, peak));
+	JS_SetPropertyStr(ctx, report, "phases", list);
+	for (uint32_t i = 0; i < n_phases; ++i) {
+		profile_phase_t *phase = &phases[i];
+		if (!phase->allocs && !phase->frees) {
+			continue;
+		}
+		JSValue counters = JS_NewObject(ctx);
+		JS_SetPropertyStr(ctx, counters, "allocs", JS_NewInt64(ctx, phase->allocs));
+		JS_SetPropertyStr(ctx, counters, "frees", JS_NewInt64(ctx, phase->frees));
+		JS_SetPropertyStr(ctx, counters, "bytes", JS_NewInt64(ctx, phase->bytes));
+		JS_SetPropertyStr(ctx, counters, "freed", JS_NewInt64(ctx, phase->freed));
+		JS_SetPropertyStr(ctx, counters, "peak", JS_NewInt64(ctx, phase->peak));
+		JS_SetPropertyStr(ctx, list, phase->name, counters);
+	}
+
+	if (reset) {
+		for (uint32_t i = 0; i < profile->n_phases; ++i) {
+			profile_phase_t *phase = &profile->phases[i];
+			phase->allocs = phase->frees = phase->bytes = phase->freed = 0;
+			phase->peak = 0;
+		}
+		profile->phases[profile->current].peak = profile->live;
+		profile->peak = profile->live;
+	}
+	return report;
+}
+
+/**
+ * flags selects the runtime heap: R2DEC_ARENA serves it from c/arena.c,
+ * where the pages freed by a run are reused by the next one; R2DEC_PROFILE
+ * counts its traffic per phase (r2dec.phase and r2dec.profile).
+ */
+r2dec_t *r2dec_new(uint32_t flags) {
+	arena_t *arena = NULL;
+	profile_t *profile = NULL;
+	if ((flags & R2DEC_ARENA) && !(arena = arena_new())) {
+		errorf("Error: failed to allocate the qjs arena\n");
+		return NULL;
+	} else if ((flags & R2DEC_PROFILE) && !(profile = profile_new(arena))) {
+		errorf("Error: failed to allocate the qjs profiler\n");
+		arena_free(arena);
+		return NULL;
+	}
+
+	JSRuntime *rt = NULL;
+	if (profile) {
+		rt = JS_NewRuntime2(&js_profile_functions, profile);
+	} else if (arena) {
+		rt = JS_NewRuntime2(&js_arena_functions, arena);
+	} else {
+		rt = JS_NewRuntime();
+	}
 	if (!rt) {
 		errorf("Error: failed to create qjs runtime\n");
+		arena_free(arena);
+		free(profile);
 		return NULL;
 	}
 
@@ -185,6 +738,8 @@ r2dec_t *r2dec_new() {
 	if (!ctx) {
 		errorf("Error: failed to create qjs context\n");
 		JS_FreeRuntime(rt);
+		arena_free(arena);
+		free(profile);
 		return NULL;
 	}
 
@@ -205,6 +760,15 @@ r2dec_t *r2dec_new() {
 	JS_SetPropertyStr(ctx, global, "atob", JS_NewCFunction(ctx, js_atob, "atob", 1));
 	JS_SetPropertyStr(ctx, global, "btoa", JS_NewCFunction(ctx, js_btoa, "btoa", 1));
 
+	// r2dec.main is set by the main module and called by r2dec_run
+	JSValue r2dec = JS_NewObject(ctx);
+	JS_SetPropertyStr(ctx, global, "r2dec", r2dec);
+	db_install(ctx, r2dec);
+	if (profile) {
+		JS_SetPropertyStr(ctx, r2dec, "phase", JS_NewCFunction(ctx, js_profile_phase, "phase", 1));
+		JS_SetPropertyStr(ctx, r2dec, "profile", JS_NewCFunction(ctx, js_profile_report, "profile", 1));
+	}
+
 	JSValue limits = JS_NewObject(ctx);
 	JS_SetPropertyStr(ctx, global, "Limits", limits);
 	JS_SetPropertyStr(ctx, limits, "UT16_MAX", JS_NewBigUint64(ctx, 0xFFFFu));
@@ -218,19 +782,28 @@ r2dec_t *r2dec_new() {
 	if (!js_load_all_modules(ctx)) {
 		JS_FreeContext(ctx);
 		JS_FreeRuntime(rt);
+		arena_free(arena);
+		free(profile);
 		return NULL;
 	}
 
-	r2dec_t *dec = malloc(sizeof(r2dec_t));
+	r2dec_t *dec = calloc(1, sizeof(r2dec_t));
 	if (!dec) {
 		errorf("Error: failed to allocate r2dec_t\n");
 		JS_FreeContext(ctx);
 		JS_FreeRuntime(rt);
+		arena_free(arena);
+		free(profile);
 		return NULL;
 	}
 
 	dec->context = ctx;
 	dec->runtime = rt;
+	dec->arena = arena;
+	dec->profile = profile;
+	dec->flags = flags;
+	JS_SetRuntimeOpaque(rt, dec);
+	JS_SetInterruptHandler(rt, js_interrupt_handler, dec);
 	return dec;
 }
 
@@ -238,6 +811,59 @@ JSContext *r2dec_context(const r2dec_t *dec) {
 	return dec->context;
 }
 
-int r2dec_run(const r2dec_t *dec) {
-	return js_load_module(dec->context, main_bytecode, main_bytecode_size);
+void r2dec_set_timeout(r2dec_t *dec, uint32_t msecs) {
+	dec->timeout = msecs;
+}
+
+int r2dec_timed_out(const r2dec_t *dec) {
+	return dec->timed_out;
+}
+
+uint32_t r2dec_flags(const r2dec_t *dec) {
+	return dec->flags;
+}
+
+int r2dec_run(r2dec_t *dec) {
+	JSContext *ctx = dec->context;
+	// the main module is loaded only once, then r2dec.main is called per run.
+	if (!dec->loaded) {
+		if (!js_load_module(ctx, main_bytecode, main_bytecode_size)) {
+			return 0;
+		}
+		dec->loaded = 1;
+	}
+
+	JSValue global = JS_GetGlobalObject(ctx);
+	JSValue r2dec = JS_GetPropertyStr(ctx, global, "r2dec");
+	JSValue main = JS_GetPropertyStr(ctx, r2dec, "main");
+	JS_FreeValue(ctx, global);
+	if (!JS_IsFunction(ctx, main)) {
+		errorf("Error: r2dec.main is not a function\n");
+		JS_FreeValue(ctx, main);
+		JS_FreeValue(ctx, r2dec);
+		return 0;
+	}
+
+	dec->timed_out = 0;
+	dec->deadline = dec->timeout > 0 ? now_msecs() + dec->timeout : 0;
+	JSValue val = JS_Call(ctx, main, r2dec, 0, NULL);
+	dec->deadline = 0;
+
+	int ret = 1;
+	if (JS_IsException(val)) {
+		r2dec_handle_exception(ctx);
+		ret = 0;
+	}
+	JS_FreeValue(ctx, val);
+	JS_FreeValue(ctx, main);
+	JS_FreeValue(ctx, r2dec);
+	if (dec->sampler) {
+		sampler_write(dec->sampler);
+	}
+	if (dec->arena) {
+		// collects the cycles left by this run, so their pages can be reused.
+		JS_RunGC(dec->runtime);
+		arena_recycle(dec->arena);
+	}
+	return ret;
 }
@@ -8,10 +8,20 @@
 
 typedef struct r2dec_s r2dec_t;
 
+#define R2DEC_ARENA   (1u << 0) // the runtime heap is served by c/arena.c
+#define R2DEC_PROFILE (1u << 1) // counts the heap traffic per phase (r2dec.phase)
+#define R2DEC_SAMPLE_HZ 1000 // default rate of the stack sampler
+
 void r2dec_free(r2dec_t *dec);
-r2dec_t *r2dec_new();
+r2dec_t *r2dec_new(uint32_t flags);
 JSContext *r2dec_context(const r2dec_t *dec);
-int r2dec_run(const r2dec_t *dec);
+int r2dec_run(r2dec_t *dec);
+void r2dec_set_timeout(r2dec_t *dec, uint32_t msecs);
+int r2dec_timed_out(const r2dec_t *dec);
+uint32_t r2dec_flags(const r2dec_t *dec);
+int r2dec_sample_start(r2dec_t *dec, const char *file, uint32_t hz);
+void r2dec_sample_stop(r2dec_t *dec);
+const char *r2dec_sample_file(const r2dec_t *dec, uint32_t *hz, uint64_t *samples);
 void r2dec_handle_exception(JSContext *ctx);
 
 #endif /* R2DEC_H */
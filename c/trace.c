@@ -0,0 +1,179 @@
+// SPDX-FileCopyrightText: 2026 Giovanni Dante Grazioli <deroad@kumo.xn--q9jyb4c>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "trace.h"
+
+#define TRACE_HEADER_SIZE 12
+#define TRACE_RECORD_SIZE 9
+
+struct trace_writer_s {
+	FILE *fp;
+	char *file;
+	uint64_t records;
+	uint64_t bytes;
+	int failed;
+};
+
+static void write_le32(uint8_t *p, uint32_t value) {
+	p[0] = value & 0xff;
+	p[1] = (value >> 8) & 0xff;
+	p[2] = (value >> 16) & 0xff;
+	p[3] = (value >> 24) & 0xff;
+}
+
+static uint32_t read_le32(const uint8_t *p) {
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+trace_writer_t *trace_create(const char *file) {
+	trace_writer_t *writer = calloc(1, sizeof(trace_writer_t));
+	if (!writer || !(writer->file = strdup(file))) {
+		free(writer);
+		return NULL;
+	} else if (!(writer->fp = fopen(file, "wb"))) {
+		free(writer->file);
+		free(writer);
+		return NULL;
+	}
+
+	uint8_t header[TRACE_HEADER_SIZE];
+	memcpy(header, TRACE_MAGIC, 8);
+	write_le32(header + 8, TRACE_VERSION);
+	if (fwrite(header, 1, sizeof(header), writer->fp) != sizeof(header)) {
+		trace_close(writer);
+		return NULL;
+	}
+	writer->bytes = sizeof(header);
+	return writer;
+}
+
+int trace_write(trace_writer_t *writer, uint8_t kind, const char *request, size_t request_size, const char *response, size_t response_size) {
+	if (!writer || writer->failed) {
+		return 0;
+	} else if (request_size > UINT32_MAX || response_size > UINT32_MAX) {
+		return 0;
+	}
+
+	uint8_t header[TRACE_RECORD_SIZE];
+	header[0] = kind;
+	write_le32(header + 1, (uint32_t)request_size);
+	write_le32(header + 5, (uint32_t)response_size);
+	if (fwrite(header, 1, sizeof(header), writer->fp) != sizeof(header) ||
+		fwrite(request, 1, request_size, writer->fp) != request_size ||
+		fwrite(response, 1, response_size, writer->fp) != response_size) {
+		// a truncated record makes the rest of the file unreadable.
+		writer->failed = 1;
+		return 0;
+	}
+	writer->records++;
+	writer->bytes += sizeof(header) + request_size + response_size;
+	return 1;
+}
+
+void trace_flush(trace_writer_t *writer) {
+	if (writer) {
+		fflush(writer->fp);
+	}
+}
+
+void trace_close(trace_writer_t *writer) {
+	if (!writer) {
+		return;
+	}
+	fclose(writer->fp);
+	free(writer->file);
+	free(writer);
+}
+
+const char *trace_file(const trace_writer_t *writer, uint64_t *records, uint64_t *bytes) {
+	if (!writer) {
+		return NULL;
+	}
+	if (records) {
+		*records = writer->records;
+	}
+	if (bytes) {
+		*bytes = writer->bytes;
+	}
+	return writer->file;
+}
+
+static uint8_t *trace_read(const char *file, size_t *size) {
+	FILE *fp = fopen(file, "rb");
+	if (!fp) {
+		return NULL;
+	}
+	uint8_t *data = NULL;
+	long length = 0;
+	if (fseek(fp, 0, SEEK_END) || (length = ftell(fp)) < TRACE_HEADER_SIZE) {
+		goto end;
+	}
+	rewind(fp);
+	if ((data = malloc(length)) && fread(data, 1, length, fp) != (size_t)length) {
+		free(data);
+		data = NULL;
+	}
+	*size = length;
+
+end:
+	fclose(fp);
+	return data;
+}
+
+/**
+ * Loads the whole trace; a truncated last record (i.e. the plugin was
+ * killed while recording) is ignored.
+ */
+trace_t *trace_load(const char *file) {
+	trace_t *trace = calloc(1, sizeof(trace_t));
+	if (!trace) {
+		return NULL;
+	} else if (!(trace->data = trace_read(file, &trace->size)) ||
+		memcmp(trace->data, TRACE_MAGIC, 8) ||
+		read_le32(trace->data + 8) != TRACE_VERSION) {
+		trace_free(trace);
+		return NULL;
+	}
+
+	uint32_t capacity = 0;
+	size_t offset = TRACE_HEADER_SIZE;
+	while (offset + TRACE_RECORD_SIZE <= trace->size) {
+		const uint8_t *p = trace->data + offset;
+		uint32_t request_size = read_le32(p + 1);
+		uint32_t response_size = read_le32(p + 5);
+		size_t end = offset + TRACE_RECORD_SIZE + (size_t)request_size + response_size;
+		if (end > trace->size) {
+			break;
+		}
+		if (trace->n_records >= capacity) {
+			capacity = capacity ? capacity * 2 : 1024;
+			trace_record_t *records = realloc(trace->records, capacity * sizeof(trace_record_t));
+			if (!records) {
+				trace_free(trace);
+				return NULL;
+			}
+			trace->records = records;
+		}
+		trace_record_t *record = &trace->records[trace->n_records++];
+		record->kind = p[0];
+		record->request_size = request_size;
+		record->response_size = response_size;
+		record->request = (const char *)p + TRACE_RECORD_SIZE;
+		record->response = record->request + request_size;
+		offset = end;
+	}
+	return trace;
+}
+
+void trace_free(trace_t *trace) {
+	if (!trace) {
+		return;
+	}
+	free(trace->records);
+	free(trace->data);
+	free(trace);
+}
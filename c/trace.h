@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: 2026 Giovanni Dante Grazioli <deroad@kumo.xn--q9jyb4c>
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef R2DEC_TRACE_H
+#define R2DEC_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Record of the radare2 bridge traffic of the plugin (pddT), replayed by
+ * r2dec-standalone --replay without radare2.
+ * The file starts with the magic and the version (le32), followed by the
+ * records: kind (u8), request size (le32), response size (le32), request
+ * and response bytes. Each run starts with a TRACE_ARGS record.
+ */
+#define TRACE_MAGIC   "R2DECTRC"
+#define TRACE_VERSION 2
+
+#define TRACE_ARGS        'a' // pdd arguments (each ended by NUL) and radare2 version, starts a run
+#define TRACE_COMMAND     'c' // radare2.command (also agj/afvj of the native getters)
+#define TRACE_CONFIG      'e' // radare2.config.get, one record per variable
+#define TRACE_READ        'r' // radare2.read, "0x<address> <length>"
+#define TRACE_FINGERPRINT 'f' // radare2.fingerprint, empty when null
+#define TRACE_BODY_HASH   'h' // radare2.bodyHash as json, empty when null
+#define TRACE_FILE        'l' // radare2.readFile, empty when null
+
+typedef struct trace_writer_s trace_writer_t;
+
+typedef struct trace_record_s {
+	uint8_t kind;
+	uint32_t request_size;
+	uint32_t response_size;
+	const char *request; // points into the trace data
+	const char *response;
+} trace_record_t;
+
+typedef struct trace_s {
+	uint8_t *data;
+	size_t size;
+	trace_record_t *records;
+	uint32_t n_records;
+} trace_t;
+
+trace_writer_t *trace_create(const char *file);
+int trace_write(trace_writer_t *writer, uint8_t kind, const char *request, size_t request_size, const char *response, size_t response_size);
+void trace_flush(trace_writer_t *writer);
+void trace_close(trace_writer_t *writer);
+const char *trace_file(const trace_writer_t *writer, uint64_t *records, uint64_t *bytes);
+
+trace_t *trace_load(const char *file);
+void trace_free(trace_t *trace);
+
+#endif /* R2DEC_TRACE_H */
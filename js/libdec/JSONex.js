@@ -263,7 +263,9 @@ var json_parse = function(options) {
 };
 
 function _iterate_value(variable, pad, depth, used) {
-	if (used.indexOf(variable) >= 0) {
+	if (variable === null) {
+		return "null";
+	} else if (used.indexOf(variable) >= 0) {
 		return null;
 	}
 	var spad = pad.repeat(depth);
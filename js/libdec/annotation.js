@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: 2020-2023 Giovanni Dante Grazioli <deroad@libero.it>
 // SPDX-License-Identifier: BSD-3-Clause
 
+import Shared from './shared.js';
+
 const _re = {
     controlflow: /\bif\b|\belse\b|\bwhile\b|\bfor\b|\bdo\b|\breturn\b|\bthrow\b/g,
     definebits: /[ui]+nt[123468]+_t|\bvoid\b|\bconst\b|\bsizeof\b|\bfloat\b|\bdouble\b|\bchar\b|\bwchar_t\b|\bextern\b|\bstruct\b|\bsize_t\b|\btime_t\b|\bboolean\b/g,
@@ -21,7 +23,7 @@ function _auto_annotation(regex, input, type, offset) {
     var p = input.match(regex);
     var s = [];
     if (!p) {
-        return input;
+        return [input];
     }
     var i = 0;
     for (i = 0; i < p.length; i++) {
@@ -44,7 +46,7 @@ function _auto_annotation(regex, input, type, offset) {
  */
 function Annotation(value, location, type) {
     this.value = value || "";
-    this.location = location || Global().evars.extra.offset;
+    this.location = location || Shared.evars.extra.offset;
     this.type = this.value.length > 0 ? type : 'offset';
     this._annotation_ = true;
     this.define = function(current) {
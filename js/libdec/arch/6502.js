@@ -3,6 +3,7 @@
 
 import Base from '../core/base.js';
 import Variable from '../core/variable.js';
+import Shared from '../shared.js';
 
 const _REG = {
 	X: 'x',
@@ -137,7 +138,7 @@ export default {
 			return Base.nop();
 		},
 		brk: function(instr, context) {
-			Global().context.addMacro('#define INTERRUPT() __asm(brk)');
+			Shared.context.addMacro('#define INTERRUPT() __asm(brk)');
 			return Base.call(Variable.macro('INTERRUPT'), []);
 		},
 		bvc: function(instr, context) {
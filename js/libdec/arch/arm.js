@@ -6,6 +6,8 @@ import Variable from '../core/variable.js';
 import ObjC from '../core/objc.js';
 import Extra from '../core/extra.js';
 import Long from '../long.js';
+import r2pipe from '../r2pipe.js';
+import Shared from '../shared.js';
 
 const _zero_regs = ['wzr', 'xzr'];
 
@@ -152,9 +154,9 @@ var _conditional = function(instr, context, type) {
     return instr.conditional(context.cond.a, context.cond.b, type);
 };
 
-var _conditional_inline = function(instr, context, instructions, type) {
+var _conditional_inline = function(instr, context, instructions, pos, type) {
     instr.conditional(context.cond.a, context.cond.b, type);
-    var next = instructions[instructions.indexOf(instr) + 1];
+    var next = instructions[pos + 1];
     if (next) {
         instr.jump = next.location;
     } else {
@@ -206,12 +208,13 @@ var _get_var_offset = function(name, context) {
 
 /**
  * Return a list of the cdecl function call arguments.
- * @param {Array<Object>} instrs Array of instructions preceding the function call
+ * @param {Array<Object>} instrs Array of function's instructions
+ * @param {number} start Position of the function call
  * @param {number} nargs Number of arguments expected for this function call
  * @param {Object} context Context object
  * @returns {Array<Variable>} An array of arguments instances, ordered as declared in callee
  */
-var _populate_cdecl_call_args = function(instrs, nargs, context) {
+var _populate_cdecl_call_args = function(instrs, start, nargs, context) {
     var _regs64 = ['x0', 'x1', 'x2', 'x3', 'x4', 'x5', 'x6'];
     var _regs32 = ['r0', 'r1', 'r2', 'r3', 'r4', 'r5', 'r6'];
     var args = [];
@@ -219,7 +222,7 @@ var _populate_cdecl_call_args = function(instrs, nargs, context) {
     var arg, i;
     var arm64 = false;
 
-    for (i = (instrs.length - 1); i >= 0 && nargs > 0; i--) {
+    for (i = (start - 1); i >= 0 && nargs > 0; i--) {
         var mnem = instrs[i].parsed.mnem;
         var opd1 = instrs[i].parsed.opd[0];
         var opd2 = instrs[i].parsed.opd[1];
@@ -254,7 +257,7 @@ var _populate_cdecl_call_args = function(instrs, nargs, context) {
             arg = instrs[i].string ? Variable.string(instrs[i].string) : Variable.local(opd2, _register_size(opd2));
 
             instrs[i].valid = false;
-            args[offset / (Global().evars.archbits / 8)] = arg;
+            args[offset / (Shared.evars.archbits / 8)] = arg;
             nargs--;
         }
 
@@ -299,12 +302,13 @@ var _is_stack_based_local_var = function(name, context) {
 
 /**
  * Return a list of the amd64 systemv function call arguments.
- * @param {Array<Object>} instrs Array of instructions preceding the function call
+ * @param {Array<Object>} instrs Array of function's instructions
+ * @param {number} start Position of the function call
  * @param {number} nargs Number of arguments expected for this function call
  * @param {Object} context Context object (not used)
  * @returns {Array<Variable>} An array of arguments instances, ordered as declared in callee
  */
-var _populate_arm64_call_args = function(instrs, nargs, context, varargs) {
+var _populate_arm64_call_args = function(instrs, start, nargs, context, varargs) {
     var _regs64 = ['x0', 'x1', 'x2', 'x3', 'x4', 'x5', 'x6'];
     var _regs32 = ['w0', 'w1', 'w2', 'w3', 'w4', 'w5', 'w6'];
 
@@ -313,7 +317,7 @@ var _populate_arm64_call_args = function(instrs, nargs, context, varargs) {
     var args = _regs64.slice(0, nargs);
 
     // scan the preceding instructions to find where args registers are used, to take their values
-    for (i = (instrs.length - 1); i >= 0 && (nargs > 0 || varargs); i--) {
+    for (i = (start - 1); i >= 0 && (nargs > 0 || varargs); i--) {
         var op = instrs[i].parsed.mnem;
         var opd1 = instrs[i].parsed.opd[0];
         var opd2 = instrs[i].parsed.opd[1];
@@ -354,18 +358,19 @@ var _populate_arm64_call_args = function(instrs, nargs, context, varargs) {
 
 /**
  * Return a list of the amd64 systemv function call arguments.
- * @param {Array<Object>} instrs Array of instructions preceding the function call
+ * @param {Array<Object>} instrs Array of function's instructions
+ * @param {number} start Position of the function call
  * @param {number} nargs Number of arguments expected for this function call
  * @param {Object} context Context object (not used)
  * @returns {Array<Variable>} An array of arguments instances, ordered as declared in callee
  */
-var _populate_arm_call_args = function(instrs, nargs, context, varargs) {
+var _populate_arm_call_args = function(instrs, start, nargs, context, varargs) {
     var armregs = ['r0', 'r1', 'r2', 'r3', 'r4', 'r5', 'r6'];
     var i;
     var args = armregs.slice(0, nargs);
 
     // scan the preceding instructions to find where args registers are used, to take their values
-    for (i = (instrs.length - 1); i >= 0 && (nargs > 0 || varargs); i--) {
+    for (i = (start - 1); i >= 0 && (nargs > 0 || varargs); i--) {
         var op = instrs[i].parsed.mnem;
         if (!instrs[i].parsed.opd) {
             continue;
@@ -410,15 +415,16 @@ var _populate_arm_call_args = function(instrs, nargs, context, varargs) {
 /**
  * Try to guess the number of arguments passed to a specific cdecl function call, when
  * number of arguments is either unknown or may vary (i.e. like in variadic functions).
- * @param {Array<Object>} instrs Array of instructions preceding the function call
+ * @param {Array<Object>} instrs Array of function's instructions
+ * @param {number} start Position of the function call
  * @param {Object} context Context object
  * @returns {number} Number of guessed arguments passed in this cdecl function call
  */
-var _guess_cdecl_nargs = function(instrs, context) {
+var _guess_cdecl_nargs = function(instrs, start, context) {
     var nargs = 0;
 
     // scan preceding instructions backwards, in order to find evidece for passed args
-    for (var i = (instrs.length - 1); i >= 0; i--) {
+    for (var i = (start - 1); i >= 0; i--) {
         var mnem = instrs[i].parsed.mnem;
         var opd1 = instrs[i].parsed.opd[0];
 
@@ -435,8 +441,7 @@ var _guess_cdecl_nargs = function(instrs, context) {
     return nargs;
 };
 
-function _get_return_value_register(instr, instructions, args) {
-    var start = instructions.indexOf(instr);
+function _get_return_value_register(instr, instructions, start, args) {
     var nextinstr = instructions[start + 1];
     if (nextinstr && ['mov r7, r7', 'mov x29, x29'].indexOf(nextinstr.assembly) >= 0) {
         // ObjC marker. two instructions to skip
@@ -471,22 +476,21 @@ function _get_return_value_register(instr, instructions, args) {
         } else if (nextinstr.parsed.opd[2] == 'x0') {
             return 'x0';
         } else if (nextinstr.parsed.mnem.startsWith('bl') && args.length > 0) {
-            return Global().evars.archbits > 32 ? 'x0' : 'r0';
+            return Shared.evars.archbits > 32 ? 'x0' : 'r0';
         }
     }
 }
 
-var _call = function(instr, context, instructions) {
+var _call = function(instr, context, instructions, current) {
     instr.setBadJump();
     var callname = Extra.replace.call(instr.parsed.opd[0]);
     var returnval = null;
     var args = [];
-    var current = instructions.indexOf(instr);
     var regnum = 3;
     var varargs, i;
     var callee = instr.callee;
 
-    if (Global().evars.archbits == 16 && callee && callee.calltype == 'arm64') {
+    if (Shared.evars.archbits == 16 && callee && callee.calltype == 'arm64') {
         callee = null;
     }
 
@@ -507,7 +511,7 @@ var _call = function(instr, context, instructions) {
                 var marker = context.markers[instr.marker];
                 if (marker && marker[reg]) {
                     marker[reg].instr.valid = false;
-                    bits = Global().evars.archbits > 32 ? 64 : 32;
+                    bits = Shared.evars.archbits > 32 ? 64 : 32;
                     vtype = marker[reg].instr.parsed.mnem.startsWith('ld') ? 'pointer' : 'local';
                     ret = marker[reg].instr.string || marker[reg].instr.klass;
                     if (!ret) {
@@ -526,7 +530,7 @@ var _call = function(instr, context, instructions) {
                         subslice[i].valid = false;
                         opd2 = subslice[i].parsed.opd[1];
                         if ((opd2.startsWith('str.') || opd2.startsWith('str_')) && !subslice[i].string) {
-                            return Global().xrefs.find_string(opd2.replace(/^str_/, 'str.')) || opd2.substr(4);
+                            return Shared.xrefs.find_string(opd2.replace(/^str_/, 'str.')) || opd2.substr(4);
                         }
                         if (subslice[i].symbol) {
                             return subslice[i].symbol;
@@ -537,7 +541,7 @@ var _call = function(instr, context, instructions) {
                         }
                         if (marker && marker[opd2]) {
                             marker[opd2].instr.valid = false;
-                            //bits = Global().evars.archbits > 32 ? 64 : 32;
+                            //bits = Shared.evars.archbits > 32 ? 64 : 32;
                             //vtype = marker[opd2].instr.parsed.mnem.startsWith('ld') ? 'pointer' : 'local';
                             ret = marker[opd2].instr.string || marker[opd2].instr.klass;
                             if (ret) {
@@ -610,11 +614,11 @@ var _call = function(instr, context, instructions) {
         // if number of arguments is unknown (either an unrecognized or a variadic function),
         // try to guess the number of arguments
         if (nargs == (-1) && callee.calltype == 'cdecl') {
-            nargs = _guess_cdecl_nargs(instructions.slice(0, current), context);
+            nargs = _guess_cdecl_nargs(instructions, current, context);
         } else if (nargs == (-1)) {
             nargs = 0;
         }
-        args = populate_call_args(instructions.slice(0, current), nargs, context, varargs);
+        args = populate_call_args(instructions, current, nargs, context, varargs);
 
         if (nargs > 0 && !varargs) {
             args = args.slice(0, nargs);
@@ -680,7 +684,7 @@ var _call = function(instr, context, instructions) {
         }
     }
 
-    returnval = _get_return_value_register(instr, instructions, args);
+    returnval = _get_return_value_register(instr, instructions, current, args);
 
     if (callname.match(/^[rwx]\d+$/) || callname.match(/^0x[a-fA-F\d]+$/)) {
         callname = Variable.functionPointer(callname, _reg_bits[callname[0]] || 0, args);
@@ -694,9 +698,9 @@ var _call = function(instr, context, instructions) {
 
 var _arm_conditional_execution = function(condition, p) {
     var f = (function(){
-        var that = function(instr, context, instructions) {
-            _conditional_inline(instr, context, instructions, that.condition);
-            return that.instruction(instr, context, instructions);
+        var that = function(instr, context, instructions, pos) {
+            _conditional_inline(instr, context, instructions, pos, that.condition);
+            return that.instruction(instr, context, instructions, pos);
         };
         return that;
     })();
@@ -707,9 +711,9 @@ var _arm_conditional_execution = function(condition, p) {
 
 var _arm_conditional_bit = function(p) {
     var f = (function(){
-        var that = function(instr, context, instructions) {
+        var that = function(instr, context, instructions, pos) {
             _compare(instr, context);
-            return that.instruction(instr, context, instructions);
+            return that.instruction(instr, context, instructions, pos);
         };
         return that;
     })();
@@ -721,8 +725,7 @@ var _it_to_boolean_array = function(value) {
     return value == 't' ? true : false;
 };
 
-var _arm_ret = function(instr, context, instructions) {
-    var start = instructions.indexOf(instr);
+var _arm_ret = function(instr, context, instructions, start) {
     var returnval = null;
     if (['r0', 'w0', 'x0'].indexOf(instructions[start - 1].parsed.opd[0]) >= 0) {
         returnval = instructions[start - 1].parsed.opd[0];
@@ -819,10 +822,9 @@ var _arm = {
         braa: _branch_reg,
         braaz: _branch_reg,
         brabz: _branch_reg,
-        bx: function(instr, context, instructions) {
+        bx: function(instr, context, instructions, start) {
             var callname = instr.parsed.opd[0];
             if (callname == 'lr') {
-                var start = instructions.indexOf(instr);
                 var returnval = null;
                 if (instructions[start - 1] && (instructions[start - 1].parsed.opd[0] == 'r0' ||
                         instructions[start - 1].parsed.opd[0] == 'w0' ||
@@ -937,7 +939,7 @@ var _arm = {
         ldr: function(instr, context) {
             var opd2 = instr.parsed.opd[1];
             if (typeof opd2 == 'string' && opd2.startsWith('str_')) {
-                instr.string = Global().xrefs.find_string(opd2.replace(/^str_/, 'str.')) || opd2.replace('str_', '');
+                instr.string = Shared.xrefs.find_string(opd2.replace(/^str_/, 'str.')) || opd2.replace('str_', '');
                 return Base.assign(instr.parsed.opd[0], Variable.string(instr.string));
             }
             var marker = _apply_marker_math(instr, context);
@@ -1030,12 +1032,11 @@ var _arm = {
             }
             return Base.assign(dst, src);
         },
-        movt: function(instr, context, instructions) {
+        movt: function(instr, context, instructions, pos) {
             var marker = _apply_marker_math(instr, context);
             if (marker) {
                 return marker;
             }
-            var pos = instructions.indexOf(instr);
             var dst = instr.parsed.opd[0];
             var src = parseInt(instr.parsed.opd[1]);
             if (dst == 'ip' || dst == 'sp' || dst == 'fp') {
@@ -1266,19 +1267,19 @@ var _arm = {
             }
             return null;
         },
-        popeq: function(instr, context, instructions) {
+        popeq: function(instr, context, instructions, pos) {
             for (var i = 1; i < instr.parsed.length; i++) {
                 if (instr.parsed.opd[i] == 'pc') {
-                    _conditional_inline(instr, context, instructions, 'EQ');
+                    _conditional_inline(instr, context, instructions, pos, 'EQ');
                     return Base.return();
                 }
             }
             return null;
         },
-        popne: function(instr, context, instructions) {
+        popne: function(instr, context, instructions, pos) {
             for (var i = 1; i < instr.parsed.length; i++) {
                 if (instr.parsed.opd[i] == 'pc') {
-                    _conditional_inline(instr, context, instructions, 'NE');
+                    _conditional_inline(instr, context, instructions, pos, 'NE');
                     return Base.return();
                 }
             }
@@ -1653,10 +1654,10 @@ var _arm = {
                 Base.cast(opds[0], opds[0], Extra.to.type(bits, true)),
             ]);
         },
-        it: function(instr, context, instructions) {
+        it: function(instr, context, instructions, current) {
             var table = instr.parsed.opd[0].split('').map(_it_to_boolean_array);
             var cond = instr.parsed.opd[1];
-            var pos = instructions.indexOf(instr) + 1;
+            var pos = current + 1;
             var type = _conditional_list.filter(function(x) {
                 if (x.ext == cond.toLowerCase()) {
                     return true;
@@ -1665,7 +1666,7 @@ var _arm = {
             })[0].type;
             var invert = _conditional_list_inv[type];
             for (var i = 0; i < table.length; i++) {
-                _conditional_inline(instructions[pos + i], context, instructions, table[i] ? invert : type);
+                _conditional_inline(instructions[pos + i], context, instructions, pos + i, table[i] ? invert : type);
             }
             return Base.nop();
         },
@@ -1745,6 +1746,7 @@ var _arm = {
             } else if (x.type === 'unsigned int') {
                 x.type = 'uint32_t';
             }
+            Base.invalidate(x);
             return x;
         });
         return {
@@ -1816,16 +1818,7 @@ function _apply_new_assign(register, data) {
 }
 
 var _value_at = function(address) {
-    if (radare2) {
-        //this is truly an hack
-        var bytes = Global().evars.archbits > 32 ? 8 : 4;
-        var p = JSON.parse(radare2.command('pxj ' + bytes + ' @ 0x' + address.toString(16)).trim()).reverse().map(function(x) {
-            x = x.toString(16);
-            return x.length > 1 ? x : '0' + x;
-        }).join('');
-        return Long.from(p, true, 16);
-    }
-    return null;
+    return Shared.evars.archbits > 32 ? r2pipe.u64le(address) : r2pipe.u32le(address);
 };
 
 function _apply_marker_math(instr, context) {
@@ -1878,8 +1871,8 @@ var _apply_math = {
         i.valid = false;
         marker[instr.parsed.opd[0]].instr = instr;
         marker[instr.parsed.opd[0]].value = v.or(s.shl(sh));
-        instr.string = Global().xrefs.find_string(marker[instr.parsed.opd[0]].value);
-        instr.symbol = Global().xrefs.find_symbol(marker[instr.parsed.opd[0]].value);
+        instr.string = Shared.xrefs.find_string(marker[instr.parsed.opd[0]].value);
+        instr.symbol = Shared.xrefs.find_symbol(marker[instr.parsed.opd[0]].value);
     },
     movw: function(marker, instr) {
         var s = parseInt(instr.parsed.opd[1]);
@@ -1902,8 +1895,8 @@ var _apply_math = {
         i.valid = false;
         marker[instr.parsed.opd[0]].instr = instr;
         marker[instr.parsed.opd[0]].value = v.or(Long.from(s.toString(16) + '0000', true, 16));
-        instr.string = Global().xrefs.find_string(marker[instr.parsed.opd[0]].value);
-        instr.symbol = Global().xrefs.find_symbol(marker[instr.parsed.opd[0]].value);
+        instr.string = Shared.xrefs.find_string(marker[instr.parsed.opd[0]].value);
+        instr.symbol = Shared.xrefs.find_symbol(marker[instr.parsed.opd[0]].value);
     },
     orr: function(marker, instr) {
         if (instr.parsed.opd[1] != '0') {
@@ -1934,8 +1927,8 @@ var _apply_math = {
             var value = Long.from(parseInt(instr.parsed.opd[2]).toString(16), true, 16);
             marker[instr.parsed.opd[0]].value = v.add(value);
         }
-        instr.string = Global().xrefs.find_string(marker[instr.parsed.opd[0]].value);
-        instr.symbol = Global().xrefs.find_symbol(marker[instr.parsed.opd[0]].value);
+        instr.string = Shared.xrefs.find_string(marker[instr.parsed.opd[0]].value);
+        instr.symbol = Shared.xrefs.find_symbol(marker[instr.parsed.opd[0]].value);
     },
     ldr: function(marker, instr) {
         var isarr = Extra.is.array(instr.parsed.opd[1]);
@@ -1948,14 +1941,14 @@ var _apply_math = {
         if (instr.parsed.opd[1][0] == 'pc') {
             number = instr.location.add(parseInt(instr.parsed.opd[1][1]) + 4);
             v = _value_at(number);
-            instr.string = Global().xrefs.find_string(v) || Global().xrefs.find_string(number);
-            instr.symbol = Global().xrefs.find_symbol(v) || Global().xrefs.find_symbol(number);
+            instr.string = Shared.xrefs.find_string(v) || Shared.xrefs.find_string(number);
+            instr.symbol = Shared.xrefs.find_symbol(v) || Shared.xrefs.find_symbol(number);
         } else if (!isarr && instr.parsed.opd[1].startsWith('0x')) {
             number = Long.from(parseInt(instr.parsed.opd[1]).toString(16), true, 16);
             v = _value_at(number);
-            instr.string = Global().xrefs.find_string(v) || Global().xrefs.find_string(number);
-            instr.symbol = Global().xrefs.find_symbol(v) || Global().xrefs.find_symbol(number);
-            instr.klass = Global().xrefs.find_class(v) || Global().xrefs.find_class(number);
+            instr.string = Shared.xrefs.find_string(v) || Shared.xrefs.find_string(number);
+            instr.symbol = Shared.xrefs.find_symbol(v) || Shared.xrefs.find_symbol(number);
+            instr.klass = Shared.xrefs.find_class(v) || Shared.xrefs.find_class(number);
         } else {
             var data = marker[instr.parsed.opd[1]] || marker[instr.parsed.opd[1][0]];
             if (instr.parsed.opd[0] == instr.parsed.opd[1] || instr.parsed.opd[0] == instr.parsed.opd[1][0]) {
@@ -1975,9 +1968,9 @@ var _apply_math = {
             }
 
             v = _value_at(number);
-            instr.string = Global().xrefs.find_string(v) || Global().xrefs.find_string(number);
-            instr.symbol = Global().xrefs.find_symbol(v) || Global().xrefs.find_symbol(number);
-            instr.klass = Global().xrefs.find_class(_value_at(v)) || Global().xrefs.find_class(_value_at(_value_at(number.add(4)))) || Global().xrefs.find_class(v) || Global().xrefs.find_class(number);
+            instr.string = Shared.xrefs.find_string(v) || Shared.xrefs.find_string(number);
+            instr.symbol = Shared.xrefs.find_symbol(v) || Shared.xrefs.find_symbol(number);
+            instr.klass = Shared.xrefs.find_class(_value_at(v)) || Shared.xrefs.find_class(_value_at(_value_at(number.add(4)))) || Shared.xrefs.find_class(v) || Shared.xrefs.find_class(number);
         }
         if (instr.string) {
             instr.code = Base.assign(instr.parsed.opd[0], Variable.string(instr.string));
@@ -3,6 +3,7 @@
 
 import Base from '../core/base.js';
 import Variable from '../core/variable.js';
+import Shared from '../shared.js';
 
 const AVR_MEM_BITS = 16;
 const AVR_X_MACRONAME = 'MEM_X';
@@ -31,8 +32,6 @@ const AVR_MEMORY = {
 		low: 'r30'
 	}
 };
-var AVR_CTR = 0;
-
 var _to_16bit = function(high, low) {
 	if ((high == '0x00' || high == '0') && (low == '0x00' || low == '0')) {
 		return '0';
@@ -112,7 +111,7 @@ var _load16 = function(instr, context) {
 			Base.conditional_math(AVR_MEMORY[ptr].high, AVR_MEMORY[ptr].low, v, 'LT', AVR_MEMORY[ptr].high, 1, AVR_MEMORY[ptr].high, '-')
 		];
 		op = Base.composed(m);
-		Global().context.addMacro(AVR_MEMORY[ptr].macro);
+		Shared.context.addMacro(AVR_MEMORY[ptr].macro);
 		return op;
 	} else if (ptr.indexOf('+') >= 0) {
 		ptr = ptr.replace('+', '');
@@ -125,12 +124,12 @@ var _load16 = function(instr, context) {
 			Base.conditional_math(AVR_MEMORY[ptr].high, AVR_MEMORY[ptr].low, v, 'LT', AVR_MEMORY[ptr].high, 1, AVR_MEMORY[ptr].high, '+')
 		];
 		op = Base.composed(m);
-		Global().context.addMacro(AVR_MEMORY[ptr].macro);
+		Shared.context.addMacro(AVR_MEMORY[ptr].macro);
 		return op;
 	}
 	//pointer, register, bits, is_signed
 	op = Base.read_memory(AVR_MEMORY[ptr].name, instr.parsed.opd[0], 8, false);
-	Global().context.addMacro(AVR_MEMORY[ptr].macro);
+	Shared.context.addMacro(AVR_MEMORY[ptr].macro);
 	return op;
 };
 
@@ -150,7 +149,7 @@ var _store16 = function(instr, context) {
 			Base.conditional_math(AVR_MEMORY[ptr].high, AVR_MEMORY[ptr].low, v, 'LT', AVR_MEMORY[ptr].high, 1, AVR_MEMORY[ptr].high, '-')
 		];
 		op = Base.composed(m);
-		Global().context.addMacro(AVR_MEMORY[ptr].macro);
+		Shared.context.addMacro(AVR_MEMORY[ptr].macro);
 		return op;
 	} else if (ptr.indexOf('+') >= 0) {
 		ptr = ptr.replace(/\+\d?/, '');
@@ -163,12 +162,12 @@ var _store16 = function(instr, context) {
 			Base.conditional_math(AVR_MEMORY[ptr].high, AVR_MEMORY[ptr].low, v, 'LT', AVR_MEMORY[ptr].high, 1, AVR_MEMORY[ptr].high, '+')
 		];
 		op = Base.composed(m);
-		Global().context.addMacro(AVR_MEMORY[ptr].macro);
+		Shared.context.addMacro(AVR_MEMORY[ptr].macro);
 		return op;
 	}
 	//pointer, register, bits, is_signed
 	op = Base.write_memory(AVR_MEMORY[ptr].name, instr.parsed.opd[1], 8, false);
-	Global().context.addMacro(AVR_MEMORY[ptr].macro);
+	Shared.context.addMacro(AVR_MEMORY[ptr].macro);
 	return op;
 };
 
@@ -353,14 +352,14 @@ export default {
 			instr.setBadJump();
 			//name, args, is_pointer, returns, bits
 			var op = Base.call(Variable.functionPointer(AVR_MEMORY.z.name), []);
-			Global().context.addMacro(AVR_MEMORY.z.macro);
+			Shared.context.addMacro(AVR_MEMORY.z.macro);
 			return op;
 		},
 		ijmp: function(instr, context) {
 			_returns_r0(instr, context);
 			instr.setBadJump();
 			var op = Base.goto(AVR_MEMORY.z.name);
-			Global().context.addMacro(AVR_MEMORY.z.macro);
+			Shared.context.addMacro(AVR_MEMORY.z.macro);
 			return op;
 		},
 		in: function(instr, context) {
@@ -387,7 +386,7 @@ export default {
 			var offset = ptr[1].replace(/(-)/, ' - ').replace(/(\+)/, ' + ');
 			//pointer, register, bits, is_signed
 			var op = Base.read_memory(AVR_MEMORY[ptr[0]].name + offset, instr.parsed.opd[0], 8, false);
-			Global().context.addMacro(AVR_MEMORY[ptr[0]].macro);
+			Shared.context.addMacro(AVR_MEMORY[ptr[0]].macro);
 			return op;
 		},
 		ldi: function(instr, context) {
@@ -424,7 +423,7 @@ export default {
 		},
 		mul: function(instr, context) {
 			context.returns = 'r0';
-			var name = 'value' + (++AVR_CTR);
+			var name = 'value' + (++context.counter);
 			var ops = [];
 			ops.push(Base.multiply('uint16_t ' + name, instr.parsed.opd[0], instr.parsed.opd[1]));
 			ops.push(Base.assign('r0', '(' + name + ' & 0xFF)'));
@@ -433,7 +432,7 @@ export default {
 		},
 		muls: function(instr, context) {
 			context.returns = 'r0';
-			var name = 'value' + (++AVR_CTR);
+			var name = 'value' + (++context.counter);
 			var ops = [];
 			ops.push(Base.multiply('int16_t ' + name, instr.parsed.opd[0], instr.parsed.opd[1]));
 			ops.push(Base.assign('r0', '(' + name + ' & 0xFF)'));
@@ -442,7 +441,7 @@ export default {
 		},
 		mulsu: function(instr, context) {
 			context.returns = 'r0';
-			var name = 'value' + (++AVR_CTR);
+			var name = 'value' + (++context.counter);
 			var ops = [];
 			ops.push(Base.multiply('uint16_t ' + name, instr.parsed.opd[0], instr.parsed.opd[1]));
 			ops.push(Base.assign('r0', '(' + name + ' & 0xFF)'));
@@ -598,7 +597,7 @@ export default {
 			var offset = ptr[1].replace(/(-)/, ' - ').replace(/(\+)/, ' + ');
 			//pointer, register, bits, is_signed
 			var op = Base.write_memory(AVR_MEMORY[ptr[0]].name + offset, instr.parsed.opd[1], 8, false);
-			Global().context.addMacro(AVR_MEMORY[ptr[0]].macro);
+			Shared.context.addMacro(AVR_MEMORY[ptr[0]].macro);
 			return op;
 		},
 		sts: function(instr, context) {
@@ -655,6 +654,7 @@ export default {
 				b: null,
 				instr: null
 			},
+			counter: 0,
 			returns: null
 		};
 	},
@@ -5,6 +5,7 @@ import Base from '../core/base.js';
 import Variable from '../core/variable.js';
 import Extra from '../core/extra.js';
 import Long from '../long.js';
+import Shared from '../shared.js';
 
 const JavaObject = 'java.lang.Object';
 const JavaClassCastException = 'java.lang.ClassCastException';
@@ -559,7 +560,7 @@ export default {
 			var dst = context.data[instr.parsed.opd[1]];
 			if (!dst) {
 				var addr = Long.from(instr.parsed.opd[1], true, instr.parsed.opd[1].startsWith('0x') ? 16 : 10);
-				var reference = Global().xrefs.find_string(addr) || Global().xrefs.find_symbol(addr);
+				var reference = Shared.xrefs.find_string(addr) || Shared.xrefs.find_symbol(addr);
 				if (!reference) {
 					var varname = Variable.uniqueName("data");
 					var type = 0,
@@ -397,6 +397,7 @@ export default {
 					d.pointer = p.join(' + ');
 					d.register = p[0];
 				}
+				Base.invalidate(d);
 				return d;
 			}),
 		};
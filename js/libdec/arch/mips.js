@@ -5,6 +5,7 @@ import Instruction from '../core/instruction.js';
 import Base from '../core/base.js';
 import Variable from '../core/variable.js';
 import Long from '../long.js';
+import Shared from '../shared.js';
 
 const _mips_registers = [
     'zero', 'at', 'v0', 'v1',
@@ -162,8 +163,8 @@ var lui32 = function(instr, start, instructions, context) {
     }
     --i;
     if (instr.parsed.opd[0] != 'gp') {
-        instr.string = Global().xrefs.find_string(addr);
-        instr.symbol = Global().xrefs.find_symbol(addr);
+        instr.string = Shared.xrefs.find_string(addr);
+        instr.symbol = Shared.xrefs.find_symbol(addr);
         addr = instr.string ? Variable.string(instr.string) : (instr.symbol || ('0x' + addr.toString(16)).replace(/0x-/, '-0x'));
         instr.valid = true;
     } else {
@@ -6,6 +6,7 @@
 import Base from '../core/base.js';
 import Variable from '../core/variable.js';
 import Long from '../long.js';
+import Shared from '../shared.js';
 
 var sprs = {
 	SPR_MQ: {
@@ -639,8 +640,8 @@ var lis64_ppc = function(instr, start, instructions) {
 		instructions[i].valid = false;
 	}
 	--i;
-	instr.string = Global().xrefs.find_string(addr);
-	instr.symbol = Global().xrefs.find_symbol(addr);
+	instr.string = Shared.xrefs.find_string(addr);
+	instr.symbol = Shared.xrefs.find_symbol(addr);
 	addr = instr.string ? Variable.string(instr.string) : (instr.symbol || ('0x' + addr.toString(16)).replace(/0x-/, '-0x'));
 	instr.code = Base.assign(instr.parsed.opd[0], addr);
 	instr.valid = true;
@@ -719,8 +720,8 @@ var lis64_vle = function(instr, start, instructions) {
 	}
 	--i;
 	instructions[i].valid = true;
-	instr.string = Global().xrefs.find_string(addr);
-	instr.symbol = Global().xrefs.find_symbol(addr);
+	instr.string = Shared.xrefs.find_string(addr);
+	instr.symbol = Shared.xrefs.find_symbol(addr);
 	addr = instr.string ? Variable.string(instr.string) : (instr.symbol || ('0x' + addr.toString(16)).replace(/0x-/, '-0x'));
 	instr.code = Base.assign(instr.parsed.opd[0], addr);
 	return i;
@@ -1019,7 +1020,7 @@ export default {
 			var arg0 = spr.indexOf('0x') != 0 ? new Base.macro(spr) : spr;
 			var op = Base.call('_mfspr', [arg0], false, instr.parsed.opd[0], bits, false);
 			if (spr.indexOf('0x') != 0) {
-				Global().context.addMacro('#define ' + spr + ' (' + instr.parsed.opd[0] + ')');
+				Shared.context.addMacro('#define ' + spr + ' (' + instr.parsed.opd[0] + ')');
 			}
 			return op;
 		},
@@ -1031,7 +1032,7 @@ export default {
 			var arg0 = spr.indexOf('0x') != 0 ? Variable.macro(spr) : spr;
 			var op = Base.call('_mtspr', [arg0, reg]);
 			if (spr.indexOf('0x') != 0) {
-				Global().context.addMacro('#define ' + spr + ' (' + instr.parsed.opd[0] + ')');
+				Shared.context.addMacro('#define ' + spr + ' (' + instr.parsed.opd[0] + ')');
 			}
 			return op;
 		},
@@ -1075,7 +1076,7 @@ export default {
 				if (instructions[p].parsed.opd[0] == instr.parsed.opd[0]) {
 					instructions[p].valid = false;
 				}
-				var xref = Global().xrefs.find_string(v0);
+				var xref = Shared.xrefs.find_string(v0);
 				if (xref) {
 					instr.string = xref;
 					xref = Variable.string(xref);
@@ -1298,10 +1299,10 @@ export default {
 		},
 		wrteei: function(instr) {
 			if (instr.parsed.opd[0] != '0') {
-				Global().context.addMacro('#define DISABLE_INTERRUPTS() __asm(wrteei 0)');
+				Shared.context.addMacro('#define DISABLE_INTERRUPTS() __asm(wrteei 0)');
 				return Base.call(Variable.macro('DISABLE_INTERRUPTS'), []);
 			} else if (instr.parsed.opd[0] != '1') {
-				Global().context.addMacro('#define ENABLE_INTERRUPTS() __asm(wrteei 1)');
+				Shared.context.addMacro('#define ENABLE_INTERRUPTS() __asm(wrteei 1)');
 				return Base.call(Variable.macro('ENABLE_INTERRUPTS'), []);
 			}
 			return Base.unknown(instr.opcode);
@@ -4,6 +4,7 @@
 import Base from '../core/base.js';
 import Variable from '../core/variable.js';
 import Long from '../long.js';
+import Shared from '../shared.js';
 
 function load_bits(instr, bits, unsigned) {
 	instr.setBadJump();
@@ -158,8 +159,8 @@ function lui32(instr, start, instructions, context) {
 	}
 	--i;
 	if (instr.parsed.opd[0] != 'gp') {
-		instr.string = Global().xrefs.find_string(addr);
-		instr.symbol = Global().xrefs.find_symbol(addr);
+		instr.string = Shared.xrefs.find_string(addr);
+		instr.symbol = Shared.xrefs.find_symbol(addr);
 		addr = instr.string ? Variable.string(instr.string) : (instr.symbol || ('0x' + addr.toString(16)).replace(/0x-/, '-0x'));
 		instr.valid = true;
 	} else {
@@ -192,6 +192,7 @@ function ensure_stack_local(context, offset, bits) {
         const cur = type_bits(v.type);
         if (bits > cur) {
             v.type = type_for_bits(bits);
+            Base.invalidate(v);
         }
     }
     return v;
@@ -3,6 +3,7 @@
 
 import Base from '../core/base.js';
 import Variable from '../core/variable.js';
+import Shared from '../shared.js';
 
 var _common_math = function(e, op, reversed) {
 	if (e.opd[1] == '0') {
@@ -280,7 +281,7 @@ export default {
 			if (e.opd[0] == 'v' || e.opd[0] == 'nv') {
 				var m = new Variable.macro((e.opd[0] == 'nv' ? '!' : '') + 'IS_OVERFLOW(' + context.cond.a + ', ' + context.cond.b + ')');
 				var op = Base.conditional_assign(e.opd[1], m, null, 'CUST', '1', '0');
-				Global().context.addMarcro('#define IS_OVERFLOW(a,b) (((a<0)&&(b<0)&&(a+b>0))||((a>0)&&(b>0)&&(a+b<0)))');
+				Shared.context.addMarcro('#define IS_OVERFLOW(a,b) (((a<0)&&(b<0)&&(a+b>0))||((a>0)&&(b>0)&&(a+b<0)))');
 				return op;
 			}
 			var o = _setf_v850_cond[e.opd[0]];
@@ -4,6 +4,7 @@
 import Base from '../core/base.js';
 import Variable from '../core/variable.js';
 import Extra from '../core/extra.js';
+import Shared from '../shared.js';
 
 var _memory_name = "_memory";
 
@@ -135,6 +136,8 @@ var _math = function(instr, context, instructions, type, op) {
     var source_a = context.stack.pop();
     source_a.type = type;
     source_b.type = type;
+    Base.invalidate(source_a);
+    Base.invalidate(source_b);
     var pos = _is_next_a_set(instr, instructions);
     var destination = StackVar(type, instr);
     context.stack.push(destination); // push must happen.
@@ -426,7 +429,7 @@ var _wasm_arch = {
             var ret = null;
             if (context.stack.length > 0) {
                 if (context.stack.length > 1) {
-                    Global().warning('[wasm] stack len is not zero: ' + context.stack.length);
+                    Shared.warning('[wasm] stack len is not zero: ' + context.stack.length);
                 }
                 context.returned = context.stack.pop();
                 ret = _remove_const(instr, instructions, context.returned);
@@ -462,7 +465,7 @@ var _wasm_arch = {
                     var ret = null;
                     if (context.stack.length > 0) {
                         if (context.stack.length > 1) {
-                            Global().warning('[wasm] stack len is not zero: ' + context.stack.length);
+                            Shared.warning('[wasm] stack len is not zero: ' + context.stack.length);
                         }
                         context.returned = context.stack.pop();
                         ret = _remove_const(instr, instructions, context.returned);
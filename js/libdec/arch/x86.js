@@ -8,6 +8,8 @@ import Variable from '../core/variable.js';
 import Extra from '../core/extra.js';
 import Syscalls from '../db/syscalls.js';
 import Long from '../long.js';
+import r2pipe from '../r2pipe.js';
+import Shared from '../shared.js';
 
 /**
  * Maps a return register to its corresponding size in bits, This is used to
@@ -64,18 +66,7 @@ var _is_xmm = function(op) {
 };
 
 var _value_at = function(address) {
-    if (radare2 && address) {
-        try {
-            //this is truly an hack
-            var bytes = Global().evars.archbits > 32 ? 8 : 4;
-            var p = JSON.parse(radare2.command('pxj ' + bytes + ' @ 0x' + address.toString(16)).trim()).reverse().map(function(x) {
-                x = x.toString(16);
-                return x.length > 1 ? x : '0' + x;
-            }).join('');
-            return Long.from(p, true, 16);
-        } catch (e) {}
-    }
-    return null;
+    return Shared.evars.archbits > 32 ? r2pipe.u64le(address) : r2pipe.u32le(address);
 };
 
 var _REGEX_FRAME_REG = /^[re]?bp$/;
@@ -158,12 +149,12 @@ var _has_changed_return = function(reg, signed, context) {
 
 /**
  * Queries whether a given instruction is the last instruction in function.
- * @param {Object} instr Instruction instance to check
+ * @param {number} pos Position of the instruction to check
  * @param {Array<Object>} instructions Array of all instructions in the enclosing function
  * @returns {boolean} `true` if given instruction appears as the last instruction in function, `false` otherwise
  */
-var _is_last_instruction = function(instr, instructions) {
-    return instructions.indexOf(instr) == (instructions.length - 1);
+var _is_last_instruction = function(pos, instructions) {
+    return pos == (instructions.length - 1);
 };
 
 /**
@@ -180,29 +171,30 @@ var _is_jumping_externally = function(instr, instructions) {
 };
 
 /**
- * Returns any instruction which a jump is pointing to.
+ * Returns the position of the instruction which a jump is pointing to.
  * @param {Object} instr Instruction instance to check
  * @param {Array<Object>} instructions Array of all instructions in the enclosing function
- * @returns {object} Returns the instruction that is pointed or null
+ * @param {number} current Position of the instruction to check
+ * @returns {number} Returns the position of the instruction that is pointed or -1
  */
-var _get_jump_instruction = function(instr, instructions) {
-    var i, current = instructions.indexOf(instr);
+var _get_jump_instruction = function(instr, instructions, current) {
+    var i;
     if (instr.jump && instr.location.eq(instr.jump)) {
-        return instr;
+        return current;
     } else if (instr.jump && instr.location.lt(instr.jump)) {
         for (i = current + 1; i < instructions.length; i++) {
             if (instructions[i].location.eq(instr.jump)) {
-                return instructions[i];
+                return i;
             }
         }
     } else if (instr.jump && instr.location.gt(instr.jump)) {
         for (i = 0; i < current; i++) {
             if (instructions[i].location.eq(instr.jump)) {
-                return instructions[i];
+                return i;
             }
         }
     }
-    return null;
+    return -1;
 };
 
 /**
@@ -468,13 +460,14 @@ var _jcc_common = function(instr, context, type) {
  * @param {Object} p Parsed instruction structure
  * @param {Object} context Context object
  * @param {Array<Object>} instrs Array of function's instructions
+ * @param {number} pos Position of the instruction
  * @param {string} type Condition type symbol
  */
-var _cmov_common = function(instr, context, instrs, type) {
+var _cmov_common = function(instr, context, instrs, pos, type) {
     instr.conditional(context.cond.a, context.cond.b, type);
-    instr.jump = instrs[instrs.indexOf(instr) + 1].location;
+    instr.jump = instrs[pos + 1].location;
 
-    return _standard_mov(instr, context, instrs);
+    return _standard_mov(instr, context, instrs, pos);
 };
 
 // TODO: the following function should be moved to a higher analysis level, and be applied by operand size
@@ -487,7 +480,7 @@ var _cmov_common = function(instr, context, instrs, type) {
  */
 var _check_known_neg = function(x) {
     var arch_minus_one;
-    switch (Global().evars.archbits) {
+    switch (Shared.evars.archbits) {
         case 64:
             arch_minus_one = '0xffffffffffffffff';
             break;
@@ -503,46 +496,70 @@ var _check_known_neg = function(x) {
 };
 
 /**
- * Try to guess the number of arguments passed to a specific cdecl function call, when
- * number of arguments is either unknown or may vary (i.e. like in variadic functions).
- * @param {Array<Object>} instrs Array of instructions preceding the function call
+ * Returns the summary of the instructions preceding `pos`; it is kept in the
+ * context and extended incrementally, thus each instruction is visited once
+ * since the handlers are called in order:
+ *  - push:     position of the last push instruction.
+ *  - boundary: position of the last call or stack pointer update.
+ *  - nargs:    evidence of cdecl arguments since the last call or stack cleanup.
  * @param {Object} context Context object
- * @returns {number} Number of guessed arguments passed in this cdecl function call
+ * @param {Array<Object>} instrs Array of function's instructions
+ * @param {number} pos Position of the current instruction
+ * @returns {Object} Summary of the instructions in [0, pos)
  */
-var _guess_cdecl_nargs = function(instrs, context) {
-    var nargs = 0;
-
-    // scan preceding instructions backwards, in order to find evidece for passed args
-    for (var i = (instrs.length - 1); i >= 0; i--) {
-        var mnem = instrs[i].parsed.mnem;
-        var opd1 = instrs[i].parsed.opd[0];
+var _summary = function(context, instrs, pos) {
+    var s = context.summary;
+    if (pos < s.scanned) {
+        s.scanned = 0;
+        s.push = -1;
+        s.boundary = -1;
+        s.nargs = 0;
+    }
+    for (; s.scanned < pos; s.scanned++) {
+        var mnem = instrs[s.scanned].parsed.mnem;
+        var opd1 = instrs[s.scanned].parsed.opd[0];
+
+        if (mnem === 'push') {
+            s.push = s.scanned;
+        } else if ((mnem === 'call') || _is_stack_reg(opd1.token)) {
+            s.boundary = s.scanned;
+        }
 
         // a "push" instruction which is not the function's prologue indicates
         // that it is probably a function's argument
         if ((mnem === 'push') && !_is_frame_reg(opd1.token)) {
-            nargs++;
+            s.nargs++;
         } else if (mnem === 'mov' && ((opd1.mem_access && _is_stack_reg(opd1.token)) || _is_stack_based_local_var(opd1.token, context))) {
-            nargs++;
-        } else if ((mnem === 'add') && _is_stack_reg(opd1.token)) {
-            // reached the previous function call cleanup, stop searching
-            break;
-        } else if (mnem === 'call') {
-            // reached the previous function call, stop searching
-            break;
+            s.nargs++;
+        } else if (((mnem === 'add') && _is_stack_reg(opd1.token)) || (mnem === 'call')) {
+            // previous function call or its cleanup, the evidence restarts from here
+            s.nargs = 0;
         }
     }
+    return s;
+};
 
-    return nargs;
+/**
+ * Try to guess the number of arguments passed to a specific cdecl function call, when
+ * number of arguments is either unknown or may vary (i.e. like in variadic functions).
+ * @param {Array<Object>} instrs Array of function's instructions
+ * @param {number} start Position of the function call
+ * @param {Object} context Context object
+ * @returns {number} Number of guessed arguments passed in this cdecl function call
+ */
+var _guess_cdecl_nargs = function(instrs, start, context) {
+    return _summary(context, instrs, start).nargs;
 };
 
 /**
  * Try to guess the number of arguments passed to a specific amd64 systemv function call,
  * when number of arguments is either unknown or may vary (i.e. like in variadic functions).
- * @param {Array<Object>} instrs Array of instructions preceding the function call
+ * @param {Array<Object>} instrs Array of function's instructions
+ * @param {number} start Position of the function call
  * @param {Object} context Context object
  * @returns {number} Number of guessed arguments passed in this cdecl function call
  */
-var _guess_amd64_nargs = function(instrs, context) {
+var _guess_amd64_nargs = function(instrs, start, context) {
     var nargs = 0;
 
     // TODO: implement this
@@ -552,13 +569,14 @@ var _guess_amd64_nargs = function(instrs, context) {
 
 /**
  * Return a list of the cdecl function call arguments.
- * @param {Array<Object>} instrs Array of instructions preceding the function call
+ * @param {Array<Object>} instrs Array of function's instructions
+ * @param {number} start   Position of the function call
  * @param {number} nargs   Number of arguments expected for this function call
  * @param {Object} context Context object
  * @param {Object} instr   Instruction object
  * @returns {Array<Variable>} An array of arguments instances, ordered as declared in callee
  */
-var _populate_cdecl_call_args = function(instrs, nargs, context, instr) {
+var _populate_cdecl_call_args = function(instrs, start, nargs, context, instr) {
     var args = [];
     var argidx = 0;
     var arg;
@@ -567,7 +585,7 @@ var _populate_cdecl_call_args = function(instrs, nargs, context, instr) {
         return x.name;
     });
 
-    for (var i = instrs.length - 1; i >= 0 && nargs > 0; i--) {
+    for (var i = start - 1; i >= 0 && nargs > 0; i--) {
         arg = null;
         var mnem = instrs[i].parsed.mnem;
         var opd1 = instrs[i].parsed.opd[0];
@@ -597,9 +615,9 @@ var _populate_cdecl_call_args = function(instrs, nargs, context, instr) {
                 offset = nargs;
             } else if (opd1.mem_access && _is_stack_reg(opd1.token)) {
                 var deref = opd1.token.match(/[er]?[bs]p(?:\s+\+\s+(\d+))/);
-                offset = deref ? (parseInt(deref[1]) / (Global().evars.archbits / 8)) : 0;
+                offset = deref ? (parseInt(deref[1]) / (Shared.evars.archbits / 8)) : 0;
             } else if (_is_stack_based_local_var(opd1.token, context)) {
-                offset = Math.abs(_get_var_offset(opd1.token, context)) / (Global().evars.archbits / 8);
+                offset = Math.abs(_get_var_offset(opd1.token, context)) / (Shared.evars.archbits / 8);
             } else {
                 // an irrelevant 'mov' instruction; nothing to do here
                 continue;
@@ -639,13 +657,14 @@ var _populate_cdecl_call_args = function(instrs, nargs, context, instr) {
 
 /**
  * Return a list of the amd64 function call arguments.
- * @param {Array<Object>} instrs Array of instructions preceding the function call
+ * @param {Array<Object>} instrs Array of function's instructions
+ * @param {number} start Position of the function call
  * @param {number} nargs Number of arguments expected for this function call
  * @param {Object} context Context object (not used)
  * @param {Object} regs Registers mapping.
  * @returns {Array<Variable>} An array of arguments instances, ordered as declared in callee
  */
-var _populate_generic_amd64_call_args = function(instrs, nargs, context, regs) {
+var _populate_generic_amd64_call_args = function(instrs, start, nargs, context, regs) {
     var _regs64 = regs['regs64'];
     var _regs32 = regs['regs32'];
     var _krnl64 = regs['krnl64'];
@@ -660,7 +679,7 @@ var _populate_generic_amd64_call_args = function(instrs, nargs, context, regs) {
     var args = _regs64.slice(0, nargs);
     var seen_regs = []; // regs can be used only once.
     // scan the preceding instructions to find where args registers are used, to take their values
-    for (var i = (instrs.length - 1);
+    for (var i = (start - 1);
         (i >= 0) && (nargs > 0); i--) {
         if (instrs[i].jump || instrs[i].parsed.mnem == 'call') {
             break;
@@ -707,42 +726,44 @@ var _populate_generic_amd64_call_args = function(instrs, nargs, context, regs) {
 
 /**
  * Return a list of the amd64 systemv function call arguments.
- * @param {Array<Object>} instrs Array of instructions preceding the function call
+ * @param {Array<Object>} instrs Array of function's instructions
+ * @param {number} start Position of the function call
  * @param {number} nargs Number of arguments expected for this function call
  * @param {Object} context Context object (not used)
  * @returns {Array<Variable>} An array of arguments instances, ordered as declared in callee
  */
-var _populate_systemv_amd64_call_args = function(instrs, nargs, context) {
+var _populate_systemv_amd64_call_args = function(instrs, start, nargs, context) {
     var regs = {
         regs64: [ /**/ 'rdi', /**/ 'rsi', /**/ 'rdx', /* */ 'rcx', /* */ 'r8', /* */ 'r9'],
         regs32: [ /**/ 'edi', /**/ 'esi', /**/ 'edx', /* */ 'ecx', /**/ 'r8d', /**/ 'r9d'],
         krnl64: [ /* */ null, /* */ null, /* */ null, /* */ 'r10'], // kernel interface uses r10 instead of rcx
         krnl32: [ /* */ null, /* */ null, /* */ null, /**/ 'r10d'],
     };
-    return _populate_generic_amd64_call_args(instrs, nargs, context, regs);
+    return _populate_generic_amd64_call_args(instrs, start, nargs, context, regs);
 };
 
 
 /**
  * Return a list of the amd64 microsoft function call arguments.
  * https://docs.microsoft.com/en-us/cpp/cpp/fastcall?view=msvc-170
- * @param {Array<Object>} instrs Array of instructions preceding the function call
+ * @param {Array<Object>} instrs Array of function's instructions
+ * @param {number} start Position of the function call
  * @param {number} nargs Number of arguments expected for this function call
  * @param {Object} context Context object (not used)
  * @returns {Array<Variable>} An array of arguments instances, ordered as declared in callee
  */
-var _populate_ms_amd64_call_args = function(instrs, nargs, context) {
+var _populate_ms_amd64_call_args = function(instrs, start, nargs, context) {
     var regs = {
         regs64: ['rcx', 'rdx', 'r8', 'r9'],
         regs32: ['ecx', 'edx'],
         krnl64: [],
         krnl32: [],
     };
-    return _populate_generic_amd64_call_args(instrs, nargs, context, regs);
+    return _populate_generic_amd64_call_args(instrs, start, nargs, context, regs);
 };
 
-var _call_function = function(instr, context, instrs, is_pointer, cannot_return) {
-    var call, start = instrs.indexOf(instr);
+var _call_function = function(instr, context, instrs, start, is_pointer, cannot_return) {
+    var call;
     var i, j;
     // indicates the function call return type (if used)
     var returnval = undefined;
@@ -750,7 +771,7 @@ var _call_function = function(instr, context, instrs, is_pointer, cannot_return)
     var tailcall = false;
 
     // is this a tail call?
-    if (_is_last_instruction(instr, instrs)) {
+    if (_is_last_instruction(start, instrs)) {
         tailcall = true;
     } else {
         // scan the instructions down the road to see whether the function's call return
@@ -938,10 +959,10 @@ var _call_function = function(instr, context, instrs, is_pointer, cannot_return)
         // if number of arguments is unknown (either an unrecognized or a variadic function),
         // try to guess the number of arguments
         if (nargs == (-1)) {
-            nargs = guess_nargs(instrs.slice(0, start), context);
+            nargs = guess_nargs(instrs, start, context);
         }
 
-        args = populate_call_args(instrs.slice(0, start), nargs, context, instr);
+        args = populate_call_args(instrs, start, nargs, context, instr);
     } else {
         // trying to identify the fcn..
         nargs = callname.startsWith('sym.') || callname.startsWith('reloc.') ?
@@ -950,20 +971,20 @@ var _call_function = function(instr, context, instrs, is_pointer, cannot_return)
         // if number of arguments is unknown (either an unrecognized or a variadic function),
         // try to guess the number of arguments
         if (nargs == -1) {
-            nargs = _guess_cdecl_nargs(instrs.slice(0, start), context);
+            nargs = _guess_cdecl_nargs(instrs, start, context);
             callee = _populate_cdecl_call_args;
             if (nargs == -1) {
-                nargs = _guess_amd64_nargs(instrs.slice(0, start), context);
+                nargs = _guess_amd64_nargs(instrs, start, context);
                 callee = _populate_systemv_amd64_call_args;
             }
 
             if (callee && nargs > -1) {
-                args = callee(instrs.slice(0, start), nargs, context, instr);
+                args = callee(instrs, start, nargs, context, instr);
             }
         } else {
-            args = _populate_systemv_amd64_call_args(instrs.slice(0, start), nargs, context);
+            args = _populate_systemv_amd64_call_args(instrs, start, nargs, context);
             if (args.length < 1 && nargs > 0) {
-                _populate_cdecl_call_args(instrs.slice(0, start), nargs, context, instr);
+                _populate_cdecl_call_args(instrs, start, nargs, context, instr);
             }
         }
     }
@@ -993,14 +1014,14 @@ var _call_function = function(instr, context, instrs, is_pointer, cannot_return)
     return call;
 };
 
-var _standard_mov = function(instr, context, instructions) {
+var _standard_mov = function(instr, context, instructions, pos) {
     var marker = _apply_marker_math(instr, context);
     if (marker) {
         return marker;
     }
     var dst = instr.parsed.opd[0];
     var src = instr.parsed.opd[1];
-    var prev = instructions[instructions.indexOf(instr) - 1];
+    var prev = instructions[pos - 1];
 
     _has_changed_return(dst.token, context.returns.signed, context);
 
@@ -1009,9 +1030,9 @@ var _standard_mov = function(instr, context, instructions) {
     } else if (src.mem_access) {
         if (src.token.startsWith('0x')) {
             var v = _value_at(Long.from(src.token, true, 16));
-            instr.string = Global().xrefs.find_string(v);
-            instr.symbol = Global().xrefs.find_symbol(v);
-            instr.klass = Global().xrefs.find_class(_value_at(v)) || Global().xrefs.find_class(v);
+            instr.string = Shared.xrefs.find_string(v);
+            instr.symbol = Shared.xrefs.find_symbol(v);
+            instr.klass = Shared.xrefs.find_class(_value_at(v)) || Shared.xrefs.find_class(v);
         } else if (src.token == dst.token && prev.parsed.mnem == 'lea' && prev.parsed.opd[0].token == src.token) {
             prev.valid = false;
             return prev.code;
@@ -1027,7 +1048,7 @@ var _standard_mov = function(instr, context, instructions) {
     } else {
         if (src.token.startsWith('str.') && !instr.string) {
             var sref = Long.from(x86x64.parse(instr.simplified).opd[1].token, true);
-            instr.string = Global().xrefs.find_string(sref);
+            instr.string = Shared.xrefs.find_string(sref);
         }
         if (prev && prev.parsed.mnem == instr.parsed.mnem &&
             prev.parsed.opd[0].token == src.token &&
@@ -1081,7 +1102,7 @@ var _string_common = function(instr, context) {
         16: 'cx',
         32: 'ecx',
         64: 'rcx'
-    }[Global().evars.archbits];
+    }[Shared.evars.archbits];
 
     // scasd eax, dword es:[edi]
     // cmpsd dword [esi], dword ptr es:[edi]
@@ -1176,7 +1197,7 @@ var _get_reg_value_from_map = function(expected, map) {
     return null;
 };
 
-var _syscall_common = function(instr, instructions, sysinfo, regs) {
+var _syscall_common = function(instr, instructions, pos, sysinfo, regs) {
     if (!sysinfo) {
         return null;
     }
@@ -1187,7 +1208,6 @@ var _syscall_common = function(instr, instructions, sysinfo, regs) {
         return null;
     }
     var reglist = {};
-    var pos = instructions.indexOf(instr);
     var end = pos - regs.length;
     // push pop variable to save the register.
     var push_instr = null;
@@ -1236,7 +1256,7 @@ var _syscall_common = function(instr, instructions, sysinfo, regs) {
     if (typeof syscall_num != 'string') {
         return null;
     }
-    sysinfo = sysinfo.table[syscall_num];
+    sysinfo = sysinfo.table(syscall_num);
     if (!sysinfo) {
         return null;
     }
@@ -1460,35 +1480,35 @@ const x86x64 = {
             return Base.assign(dst.token, arg);
         },
         call: _call_function,
-        cmova: function(instr, context, instructions) {
-            return _cmov_common(instr, context, instructions, 'LE');
+        cmova: function(instr, context, instructions, pos) {
+            return _cmov_common(instr, context, instructions, pos, 'LE');
         },
-        cmovae: function(instr, context, instructions) {
-            return _cmov_common(instr, context, instructions, 'LT');
+        cmovae: function(instr, context, instructions, pos) {
+            return _cmov_common(instr, context, instructions, pos, 'LT');
         },
-        cmovb: function(instr, context, instructions) {
-            return _cmov_common(instr, context, instructions, 'GE');
+        cmovb: function(instr, context, instructions, pos) {
+            return _cmov_common(instr, context, instructions, pos, 'GE');
         },
-        cmovbe: function(instr, context, instructions) {
-            return _cmov_common(instr, context, instructions, 'GT');
+        cmovbe: function(instr, context, instructions, pos) {
+            return _cmov_common(instr, context, instructions, pos, 'GT');
         },
-        cmove: function(instr, context, instructions) {
-            return _cmov_common(instr, context, instructions, 'NE');
+        cmove: function(instr, context, instructions, pos) {
+            return _cmov_common(instr, context, instructions, pos, 'NE');
         },
-        cmovg: function(instr, context, instructions) {
-            return _cmov_common(instr, context, instructions, 'LE');
+        cmovg: function(instr, context, instructions, pos) {
+            return _cmov_common(instr, context, instructions, pos, 'LE');
         },
-        cmovge: function(instr, context, instructions) {
-            return _cmov_common(instr, context, instructions, 'LT');
+        cmovge: function(instr, context, instructions, pos) {
+            return _cmov_common(instr, context, instructions, pos, 'LT');
         },
-        cmovl: function(instr, context, instructions) {
-            return _cmov_common(instr, context, instructions, 'GE');
+        cmovl: function(instr, context, instructions, pos) {
+            return _cmov_common(instr, context, instructions, pos, 'GE');
         },
-        cmovle: function(instr, context, instructions) {
-            return _cmov_common(instr, context, instructions, 'GT');
+        cmovle: function(instr, context, instructions, pos) {
+            return _cmov_common(instr, context, instructions, pos, 'GT');
         },
-        cmovne: function(instr, context, instructions) {
-            return _cmov_common(instr, context, instructions, 'EQ');
+        cmovne: function(instr, context, instructions, pos) {
+            return _cmov_common(instr, context, instructions, pos, 'EQ');
         },
         bswap: function(instr, context) {
             var dst = instr.parsed.opd[0];
@@ -1570,7 +1590,7 @@ const x86x64 = {
         rcr: function(instr, context) {
             return _bitwise_rotate(instr.parsed, Base.rotate_right, context);
         },
-        jmp: function(instr, context, instructions) {
+        jmp: function(instr, context, instructions, pos) {
             var dst = instr.parsed.opd[0];
 
             // in some cases, a jmp instruction would be considered as a function call
@@ -1581,18 +1601,18 @@ const x86x64 = {
                     return Base.call(dst.token);
                 } else if (_is_local_var(dst.token, context) || dst.token.startsWith('0x')) {
                     // indirectly jumping through a local variable or to an explicit memory address
-                    return _call_function(instr, context, instructions, true);
+                    return _call_function(instr, context, instructions, pos, true);
                 }
-            } else if (_is_last_instruction(instr, instructions) && dst.token.startsWith('sym.')) {
+            } else if (_is_last_instruction(pos, instructions) && dst.token.startsWith('sym.')) {
                 return Base.call(dst.token);
             }
 
-            var ijmp = _get_jump_instruction(instr, instructions);
-            if (ijmp && ijmp.parsed.mnem == 'call') {
-                var prev = instructions[instructions.indexOf(ijmp) - 1];
+            var ijmp = _get_jump_instruction(instr, instructions, pos);
+            if (ijmp >= 0 && instructions[ijmp].parsed.mnem == 'call') {
+                var prev = instructions[ijmp - 1];
                 if (prev && prev.parsed.mnem == 'push') {
-                    instr.parsed = ijmp.parsed;
-                    var r = _call_function(instr, context, instructions, false, true);
+                    instr.parsed = instructions[ijmp].parsed;
+                    var r = _call_function(instr, context, instructions, pos, false, true);
                     return r ? Base.composed([r]) : null;
                 }
             }
@@ -1601,7 +1621,7 @@ const x86x64 = {
 
             // indirect jump through a register or an offset to register
             if (_x86_x64_registers.indexOf(ref[0]) > (-1)) {
-                return _call_function(instr, context, instructions, true);
+                return _call_function(instr, context, instructions, pos, true);
             }
 
             return Base.nop();
@@ -1639,7 +1659,7 @@ const x86x64 = {
 
             return Base.nop();
         },
-        ret: function(instr, context, instructions) {
+        ret: function(instr, context, instructions, pos) {
             var register = {
                 8: 'al',
                 16: 'ax',
@@ -1648,7 +1668,7 @@ const x86x64 = {
             }[context.returns.bits] || '';
 
             // if the function is not returning anything, discard the empty "return" statement at the end
-            if (_is_last_instruction(instr, instructions) && (register === '')) {
+            if (_is_last_instruction(pos, instructions) && (register === '')) {
                 return Base.nop();
             }
 
@@ -1663,7 +1683,7 @@ const x86x64 = {
                 Variable.pointer(val.token, Extra.to.type(val.mem_access, false)) :
                 val.token;
         },
-        pop: function(instr, context, instrs) {
+        pop: function(instr, context, instrs, pos) {
             var dst = instr.parsed.opd[0];
 
             // unless this 'pop' restores the frame pointer, look for the
@@ -1671,20 +1691,16 @@ const x86x64 = {
             //      push n  \
             //      ...      } reg = n
             //      pop reg /
-            if (!_is_frame_reg(dst.token)) {
-                for (var i = instrs.indexOf(instr); i >= 0; i--) {
-                    var mnem = instrs[i].parsed.mnem;
-                    var opd1 = instrs[i].parsed.opd[0];
-
-                    if (mnem === 'push') {
-                        var value = instrs[i].string ?
-                            Variable.string(instrs[i].string) :
-                            opd1.token;
-
-                        return Base.assign(dst.token, value);
-                    } else if ((mnem === 'call') || _is_stack_reg(opd1.token)) {
-                        break;
-                    }
+            // i.e. a push which is not followed by a call or a stack pointer update.
+            if (!_is_frame_reg(dst.token) && !_is_stack_reg(dst.token)) {
+                var summary = _summary(context, instrs, pos);
+                if (summary.push > summary.boundary) {
+                    var push = instrs[summary.push];
+                    var value = push.string ?
+                        Variable.string(push.string) :
+                        push.parsed.opd[0].token;
+
+                    return Base.assign(dst.token, value);
                 }
             }
 
@@ -1706,13 +1722,13 @@ const x86x64 = {
         stosq: _string_common,
         movsb: _string_common,
         movsw: _string_common,
-        movsd: function(instr, context, instructions) {
+        movsd: function(instr, context, instructions, pos) {
             var p = instr.parsed;
             var lhand = p.opd[0];
             var rhand = p.opd[1];
 
             if (_is_xmm(lhand) || _is_xmm(rhand)) {
-                return _standard_mov(instr, context, instructions);
+                return _standard_mov(instr, context, instructions, pos);
             } else {
                 return _string_common(instr, context);
             }
@@ -1798,21 +1814,21 @@ const x86x64 = {
                 Base.assign(rhand.token, tmp) // src = tmp
             ]);
         },
-        int: function(instr, context, instructions) {
+        int: function(instr, context, instructions, pos) {
             var syscall_num = parseInt(instr.parsed.opd[0].token).toString(16);
             var name = 'syscall_' + syscall_num + 'h';
             var regs = ['eax', 'ebx', 'ecx', 'edx', 'esi', 'edi', 'edp'];
-            var info = _syscall_common(instr, instructions, Syscalls(syscall_num, 'x86'), regs);
+            var info = _syscall_common(instr, instructions, pos, Syscalls(syscall_num, 'x86'), regs);
             if (info) {
                 name = info.name;
                 regs = info.args;
             }
             return Base.assign('eax', Base.call(name, regs));
         },
-        syscall: function(instr, context, instructions) {
+        syscall: function(instr, context, instructions, pos) {
             var name = 'syscall_80h';
             var regs = ['rax', 'rdi', 'rsi', 'rdx', 'r10', 'r8', 'r9'];
-            var info = _syscall_common(instr, instructions, Syscalls('80', 'x86'), regs);
+            var info = _syscall_common(instr, instructions, pos, Syscalls('80', 'x86'), regs);
             if (info) {
                 name = info.name;
                 regs = info.args;
@@ -2223,9 +2239,9 @@ const x86x64 = {
 
         var vars_args = Array.prototype.concat(fcnargs.bp || [], fcnargs.sp || [], fcnargs.reg || []).map(function(x) {
             if (x.type === 'int' || x.type === 'signed int') {
-                x.type = (Global().evars.archbits < 32) ? 'int16_t' : 'int32_t';
+                x.type = (Shared.evars.archbits < 32) ? 'int16_t' : 'int32_t';
             } else if (x.type === 'unsigned int') {
-                x.type = (Global().evars.archbits < 32) ? 'uint16_t' : 'uint32_t';
+                x.type = (Shared.evars.archbits < 32) ? 'uint16_t' : 'uint32_t';
             }
 
             return x;
@@ -2241,6 +2257,12 @@ const x86x64 = {
                 bits: 0,
                 signed: true
             },
+            summary: {
+                scanned: 0,
+                push: -1,
+                boundary: -1,
+                nargs: 0
+            },
             arch_bits: data.bits,
             vars: vars_args.filter(function(e) {
                 return (e.kind === 'var');
@@ -1,7 +1,17 @@
 // SPDX-FileCopyrightText: 2018-2023 Giovanni Dante Grazioli <deroad@libero.it>
 // SPDX-License-Identifier: BSD-3-Clause
 
+import Shared from './shared.js';
+
 export default function() {
+    /*
+     * the evars do not change during a run, thus the identation
+     * mode used by identfy for each printed line is captured once.
+     */
+    const honor = Shared.evars.honor;
+    const ident_assembly = honor.assembly && !honor.blocks;
+    const ident_offsets = !ident_assembly && honor.offsets && !honor.blocks;
+
     this.lines = [];
     this.errors = [];
     this.log = [];
@@ -22,7 +32,7 @@ export default function() {
      * @param error - boolean whether this is an error (optional)
      */
     this.printLog = function(str, error) {
-        if (Global().evars.extra.json) {
+        if (Shared.evars.extra.json) {
             if(error) {
                 this.errors.push(str);
             } else {
@@ -53,8 +63,8 @@ export default function() {
      * prints all the macros. used internally by core.js
      */
     this.printMacros = function(offset) {
-        if (!Global().evars.honor.blocks) {
-            var t = Global().printer.theme;
+        if (!Shared.evars.honor.blocks) {
+            var t = Shared.printer.theme;
             for (var i = 0; i < this.macros.length; i++) {
                 this.printLine(this.identfy() + t.macro(this.macros[i]), offset);
             }
@@ -83,7 +93,7 @@ export default function() {
      * prints all the dependencies. used internally by core.js
      */
     this.printDependencies = function(offset) {
-        if (Global().evars.honor.blocks) {
+        if (Shared.evars.honor.blocks) {
             return;
         }
 
@@ -153,11 +163,11 @@ export default function() {
      */
     this.identfy = function(size_no_colors, string_to_print, disable_identation) {
         var ident = disable_identation ? '' : this.ident;
-        if (Global().evars.honor.assembly && !Global().evars.honor.blocks) {
+        if (ident_assembly) {
             string_to_print = string_to_print || '';
             size_no_colors = size_no_colors || 0;
             return '    ' + string_to_print + this.identAsm.substring(size_no_colors, this.identAsm.length) + ' | ' + ident;
-        } else if (Global().evars.honor.offsets && !Global().evars.honor.blocks) {
+        } else if (ident_offsets) {
             string_to_print = string_to_print || '';
             size_no_colors = size_no_colors || 0;
             return '    ' + string_to_print + this.identAsm.substring(size_no_colors, 14) + ' | ' + ident;
@@ -14,6 +14,7 @@ import ControlFlow from './core/controlflow.js';
 import XRefs from './core/xrefs.js';
 import Anno from './annotation.js';
 import Long from './long.js';
+import Shared from './shared.js';
 
 /**
  * Fixes for known routine names that are standard (like main)
@@ -83,12 +84,12 @@ var _decompile = function(session, arch, arch_context) {
     for (var i = 0; i < instructions.length; i++) {
         var instr = instructions[i];
         if (!instr.parsed.mnem || instr.parsed.mnem.length < 1) {
-            Global().warning("invalid mnem. stopping instruction analysis.");
+            Shared.warning("invalid mnem. stopping instruction analysis.");
             break;
         }
         var fcn = arch.instructions[instr.parsed.mnem];
-        // Global().context.printLine(instr.assembly)
-        instr.code = fcn ? fcn(instr, arch_context, instructions) : new Base.unknown(instr.assembly);
+        // Shared.context.printLine(instr.assembly)
+        instr.code = fcn ? fcn(instr, arch_context, instructions, i) : new Base.unknown(instr.assembly);
     }
 };
 
@@ -98,47 +99,49 @@ var _decompile = function(session, arch, arch_context) {
  */
 var _print = function(session) {
     if (!session.routine) {
-        Global().context.printLog('Error: no "good" data given (all invalid opcodes).', true);
+        Shared.context.printLog('Error: no "good" data given (all invalid opcodes).', true);
         return;
     }
-    if (Global().evars.extra.ascomment) {
+    if (Shared.evars.extra.ascomment) {
         session.ascomment();
-        Global().context.printLog('[r2dec] comments applied for "' + session.routine_name + '".');
+        Shared.evars.apply_metadata();
+        Shared.context.printLog('[r2dec] comments applied for "' + session.routine_name + '".');
         return;
-    } else if (Global().evars.extra.ascodeline) {
+    } else if (Shared.evars.extra.ascodeline) {
         session.ascodeline();
-        Global().context.printLog('[r2dec] new code lines applied for "' + session.routine_name + '".');
+        Shared.evars.apply_metadata();
+        Shared.context.printLog('[r2dec] new code lines applied for "' + session.routine_name + '".');
         return;
     }
-    if (!Global().evars.extra.allfunctions) {
-        var t = Global().printer.theme;
-        var asm_header = Global().evars.honor.offsets ? '' : '; assembly';
-        var details = '/* ' + Global().evars.extra.file + ' @ 0x' + Global().evars.extra.offset.toString(16) + ' */';
+    if (!Shared.evars.extra.allfunctions) {
+        var t = Shared.printer.theme;
+        var asm_header = Shared.evars.honor.offsets ? '' : '; assembly';
+        var details = '/* ' + Shared.evars.extra.file + ' @ 0x' + Shared.evars.extra.offset.toString(16) + ' */';
         var r2version = '';
-        if (Global().evars.version) {
-            r2version = ' (r2 ' + Global().evars.version + ')';
+        if (Shared.evars.version) {
+            r2version = ' (r2 ' + Shared.evars.version + ')';
         }
-        if (Global().evars.extra.annotation) {
-            Global().context.addAnnotation(Anno.comment('/* r2dec pseudo code output' + r2version + ' */\n'));
-            Global().context.addAnnotation(Anno.comment(details + '\n'));
+        if (Shared.evars.extra.annotation) {
+            Shared.context.addAnnotation(Anno.comment('/* r2dec pseudo code output' + r2version + ' */\n'));
+            Shared.context.addAnnotation(Anno.comment(details + '\n'));
         } else {
-            Global().context.printLine(Global().context.identfy(asm_header.length, t.comment(asm_header)) + t.comment('/* r2dec pseudo code output' + r2version + ' */'));
-            Global().context.printLine(Global().context.identfy() + t.comment(details));
+            Shared.context.printLine(Shared.context.identfy(asm_header.length, t.comment(asm_header)) + t.comment('/* r2dec pseudo code output' + r2version + ' */'));
+            Shared.context.printLine(Shared.context.identfy() + t.comment(details));
         }
-        if (['java', 'dalvik'].indexOf(Global().evars.arch) < 0) {
-            Global().context.printMacros();
-            Global().context.printDependencies();
+        if (['java', 'dalvik'].indexOf(Shared.evars.arch) < 0) {
+            Shared.context.printMacros();
+            Shared.context.printDependencies();
         }
     }
     session.print();
     var last_instr = session.instructions[session.instructions.length - 1];
-    while (Global().context.ident.length > 0) {
-        Global().context.identOut();
-        var value = Global().context.identfy() + '}';
-        if (Global().evars.extra.annotation) {
-            Global().context.addAnnotation(value + '\n', last_instr ? last_instr.location : null);
+    while (Shared.context.ident.length > 0) {
+        Shared.context.identOut();
+        var value = Shared.context.identfy() + '}';
+        if (Shared.evars.extra.annotation) {
+            Shared.context.addAnnotation(value + '\n', last_instr ? last_instr.location : null);
         } else {
-            Global().context.printLine(value);
+            Shared.context.printLine(value);
         }
     }
 };
@@ -157,7 +160,7 @@ var _session = function(data, arch) {
     var functions = new Functions(data.xrefs.functions);
     var max_length = 0;
     var max_address = 8;
-    Global().xrefs = new XRefs(strings, symbols, classes);
+    Shared.xrefs = new XRefs(strings, symbols, classes);
     if (data.graph[0].blocks[0].addr) {
         data.graph[0].blocks.sort((a, b) => {
             var aa = Long.isLong(a.addr) ? a.addr : Long.from(a.addr, true);
@@ -201,13 +204,15 @@ var _session = function(data, arch) {
     if (max_length < this.routine_name.length) {
         max_length = this.routine_name.length;
     }
-    Global().context.identAsmSet(max_address + (max_length < this.routine_name.length ? this.routine_name.length : max_length));
-    this.instructions = instructions.filter(function(op, p, ops) {
-        for (var i = p - 1; i >= 0; i--) {
-            if (ops[i].location.eq(op.location)) {
-                return false;
-            }
+    Shared.context.identAsmSet(max_address + (max_length < this.routine_name.length ? this.routine_name.length : max_length));
+    // drops the duplicated locations, keeping the first one.
+    var seen = {};
+    this.instructions = instructions.filter(function(op) {
+        var key = op.location.toString(16);
+        if (seen[key]) {
+            return false;
         }
+        seen[key] = true;
         return true;
     });
     this.ascomment = function() {
@@ -8,6 +8,7 @@ import Extra from './extra.js';
 import Variable from './variable.js';
 import Condition from './condition.js';
 import Long from '../long.js';
+import Shared from '../shared.js';
 
 /**
  * Wraps a string with parenthesis.
@@ -27,17 +28,53 @@ var autoParen = function(s) {
 	return (s.indexOf(' ') > (-1) ? parenthesize(s) : s);
 };
 
+/**
+ * Renders an IR node, memoizing the text per printer mode; a node changed
+ * in place must be passed to invalidate() to drop its stale text.
+ * @param {Object|string} node IR node or plain string
+ * @returns {string}
+ */
+var render = function(node) {
+	if (node === null || node === undefined) {
+		return '';
+	} else if (typeof node != 'object' || Array.isArray(node) || !Object.isExtensible(node)) {
+		return '' + node;
+	}
+	var mode = Shared.printer.mode;
+	var cache = node._rendered;
+	if (!cache) {
+		cache = {};
+		Object.defineProperty(node, '_rendered', {
+			value: cache,
+			writable: true
+		});
+	} else if (Object.prototype.hasOwnProperty.call(cache, mode)) {
+		return cache[mode];
+	}
+	return (cache[mode] = node.toString());
+};
+
+/**
+ * Drops the memoized text of a node that has been mutated in place.
+ * @param {Object} node IR node
+ */
+var invalidate = function(node) {
+	if (node && node._rendered) {
+		node._rendered = null;
+	}
+};
+
 var autoString = function(v) {
 	v = v || "";
-	return Extra.is.string(v) ? Global().printer.auto(v) : v.toString();
+	return Extra.is.string(v) ? Shared.printer.auto(v) : render(v);
 };
 
 var _generic_asm = function(asm) {
 	this.asm = asm;
+};
 
-	this.toString = function() {
-		return Global().printer.theme.callname('__asm') + ' (' + Global().printer.theme.text('"' + this.asm + '"') + ')';
-	};
+_generic_asm.prototype.toString = function() {
+	return Shared.printer.theme.callname('__asm') + ' (' + Shared.printer.theme.text('"' + this.asm + '"') + ')';
 };
 
 /**
@@ -51,14 +88,14 @@ var _uexpr = function(operator, operand) {
 	this.operands = [
 		autoString(operand)
 	];
+};
 
-	/** @returns {!string} */
-	this.toString = function() {
-		return [
-			this.operator,
-			this.operands[0]
-		].join('');
-	};
+/** @returns {!string} */
+_uexpr.prototype.toString = function() {
+	return [
+		this.operator,
+		this.operands[0]
+	].join('');
 };
 
 /**
@@ -68,18 +105,18 @@ var _uexpr = function(operator, operand) {
  */
 var _uexpr_pf = function(operator, operand) {
 	_uexpr.call(this, operator, [operand]);
-
-	/** @returns {!string} */
-	this.toString = function() {
-		return [
-			this.operands[0],
-			this.operator,
-		].join('');
-	};
 };
 
 _uexpr_pf.prototype = Object.create(_uexpr.prototype);
 
+/** @returns {!string} */
+_uexpr_pf.prototype.toString = function() {
+	return [
+		this.operands[0],
+		this.operator,
+	].join('');
+};
+
 /**
  * Binary expression
  * @constructor
@@ -92,15 +129,15 @@ var _bexpr = function(operator, lhand, rhand) {
 		autoString(lhand),
 		autoString(rhand)
 	];
+};
 
-	/** @returns {!string} */
-	this.toString = function() {
-		return [
-			this.operands[0],
-			this.operator,
-			this.operands[1]
-		].join(' ');
-	};
+/** @returns {!string} */
+_bexpr.prototype.toString = function() {
+	return [
+		this.operands[0],
+		this.operator,
+		this.operands[1]
+	].join(' ');
 };
 
 /**
@@ -116,17 +153,17 @@ var _texpr = function(operator1, operator2, operand1, operand2, operand3) {
 		autoParen(autoString(operand2)),
 		autoParen(autoString(operand3))
 	];
+};
 
-	/** @returns {!string} */
-	this.toString = function() {
-		return [
-			this.operands[0],
-			this.operators[0],
-			this.operands[1],
-			this.operators[1],
-			this.operands[2]
-		].join(' ');
-	};
+/** @returns {!string} */
+_texpr.prototype.toString = function() {
+	return [
+		this.operands[0],
+		this.operators[0],
+		this.operands[1],
+		this.operators[1],
+		this.operands[2]
+	].join(' ');
 };
 
 var _assign = function(lhand, rhand) {
@@ -146,22 +183,22 @@ var _assign = function(lhand, rhand) {
 };
 
 var _cast = function(source, type) {
-	return new _uexpr(parenthesize(Global().printer.theme.types(type)) + ' ', source);
+	return new _uexpr(parenthesize(Shared.printer.theme.types(type)) + ' ', source);
 };
 
 var _generic_call = function(function_name, args) {
 	this.function_name = Extra.is.string(function_name) ? Cpp(Extra.replace.call(function_name)) : function_name;
 	this.callargs = args || [];
+};
 
-	this.toString = function() {
-		var fname = this.function_name;
+_generic_call.prototype.toString = function() {
+	var fname = this.function_name;
 
-		if (Extra.is.string(fname)) {
-			fname = Global().printer.theme.callname(fname);
-		}
+	if (Extra.is.string(fname)) {
+		fname = Shared.printer.theme.callname(fname);
+	}
 
-		return [fname, parenthesize(this.callargs.join(', '))].join(' ');
-	};
+	return [fname, parenthesize(this.callargs.join(', '))].join(' ');
 };
 
 var _generic_method_call = function(object_this, function_name, args, method_sep, prefix, postfix) {
@@ -171,16 +208,16 @@ var _generic_method_call = function(object_this, function_name, args, method_sep
 	this.method_sep = method_sep;
 	this.prefix = prefix || "";
 	this.postfix = postfix || "";
+};
 
-	this.toString = function() {
-		var fname = this.function_name;
+_generic_method_call.prototype.toString = function() {
+	var fname = this.function_name;
 
-		if (Extra.is.string(fname)) {
-			fname = Global().printer.theme.callname(fname);
-		}
+	if (Extra.is.string(fname)) {
+		fname = Shared.printer.theme.callname(fname);
+	}
 
-		return this.prefix + this.object_this + this.method_sep + [fname, parenthesize(this.callargs.join(', '))].join(' ') + this.postfix;
-	};
+	return this.prefix + this.object_this + this.method_sep + [fname, parenthesize(this.callargs.join(', '))].join(' ') + this.postfix;
 };
 
 var _generic_rotate = function(destination, source_a, rotation, bits, is_left) {
@@ -188,45 +225,45 @@ var _generic_rotate = function(destination, source_a, rotation, bits, is_left) {
 	this.destination = destination;
 	this.source_a = source_a;
 	this.rotation = Extra.is.number(rotation) ? ("0x" + rotation.toString(16)) : rotation;
+};
 
-	this.toString = function() {
-		var args = [autoString(this.source_a), autoString(this.rotation)];
+_generic_rotate.prototype.toString = function() {
+	var args = [autoString(this.source_a), autoString(this.rotation)];
 
-		return [autoString(this.destination), '=',
-			Global().printer.theme.callname(this.call),
-			parenthesize(args.join(', '))
-		].join(' ');
-	};
+	return [autoString(this.destination), '=',
+		Shared.printer.theme.callname(this.call),
+		parenthesize(args.join(', '))
+	].join(' ');
 };
 
 var _generic_return = function(value) {
 	this.value = value;
+};
 
-	this.toString = function(options) {
-		var value = '';
+_generic_return.prototype.toString = function(options) {
+	var value = '';
 
-		if (this.value) {
-			value = ' ' + autoString(this.value);
-		}
+	if (this.value) {
+		value = ' ' + autoString(this.value);
+	}
 
-		return Global().printer.theme.flow('return') + value;
-	};
+	return Shared.printer.theme.flow('return') + value;
 };
 
 var _generic_goto = function(label_or_address) {
 	this.value = label_or_address;
+};
 
-	this.toString = function(options) {
-		return [Global().printer.theme.flow('goto'), autoString(this.value)].join(' ');
-	};
+_generic_goto.prototype.toString = function(options) {
+	return [Shared.printer.theme.flow('goto'), autoString(this.value)].join(' ');
 };
 
 var _generic_flow = function(name) {
 	this.name = name;
+};
 
-	this.toString = function(options) {
-		return Global().printer.theme.flow(this.name);
-	};
+_generic_flow.prototype.toString = function(options) {
+	return Shared.printer.theme.flow(this.name);
 };
 
 var _assign_object_field = function(destination, object, field, method_sep, is_from) {
@@ -235,21 +272,21 @@ var _assign_object_field = function(destination, object, field, method_sep, is_f
 	this.field = field;
 	this.method_sep = method_sep;
 	this.is_from = is_from;
+};
 
-	this.toString = function(options) {
-		if (this.is_from) {
-			return [
-				this.object + this.method_sep + this.field,
-				'=',
-				this.destination
-			].join(' ');
-		}
+_assign_object_field.prototype.toString = function(options) {
+	if (this.is_from) {
 		return [
-			this.destination,
+			this.object + this.method_sep + this.field,
 			'=',
-			this.object + this.method_sep + this.field
+			this.destination
 		].join(' ');
-	};
+	}
+	return [
+		this.destination,
+		'=',
+		this.object + this.method_sep + this.field
+	].join(' ');
 };
 
 var _assign_array_at = function(destination, source, index, is_from) {
@@ -257,55 +294,78 @@ var _assign_array_at = function(destination, source, index, is_from) {
 	this.source = source;
 	this.index = index;
 	this.is_from = is_from;
+};
 
-	this.toString = function(options) {
-		if (this.is_from) {
-			return [
-				this.destination,
-				'=',
-				this.source,
-				'[' + this.index + ']'
-			].join(' ');
-		}
+_assign_array_at.prototype.toString = function(options) {
+	if (this.is_from) {
 		return [
 			this.destination,
-			'[' + this.index + ']',
 			'=',
-			this.source
+			this.source,
+			'[' + this.index + ']'
 		].join(' ');
-	};
+	}
+	return [
+		this.destination,
+		'[' + this.index + ']',
+		'=',
+		this.source
+	].join(' ');
 };
 
 var _generic_throw = function(value) {
 	this.value = value;
+};
 
-	this.toString = function(options) {
-		var value = '';
+_generic_throw.prototype.toString = function(options) {
+	var value = '';
 
-		if (this.value) {
-			value = ' ' + autoString(this.value);
-		}
+	if (this.value) {
+		value = ' ' + autoString(this.value);
+	}
 
-		return Global().printer.theme.flow('throw') + value;
-	};
+	return Shared.printer.theme.flow('throw') + value;
 };
 
 var _generic_objc_call = function(object_this, function_name, function_arguments) {
 	this.object_this = object_this;
 	this.function_name = function_name;
 	this.callargs = function_arguments || [];
+};
 
-	this.toString = function() {
-		var fname = this.object_this;
-		if (Extra.is.string(object_this)) {
-			fname = Global().printer.theme.callname(object_this);
-		}
+_generic_objc_call.prototype.toString = function() {
+	var fname = this.object_this;
+	if (Extra.is.string(fname)) {
+		fname = Shared.printer.theme.callname(fname);
+	}
+
+	return "[" + [fname, this.function_name].concat(this.callargs).join(' ') + "]";
+};
+
+var _composed = function(composed) {
+	this.composed = composed;
+};
 
-		return "[" + [fname, this.function_name].concat(this.callargs).join(' ') + "]";
-	};
+var _macro = function(macro) {
+	this.macro = macro;
+};
+
+_macro.prototype.toString = function() {
+	return Shared.printer.theme.macro(this.macro);
+};
+
+var _special = function(data) {
+	this.data = data;
+};
+
+_special.prototype.toString = function() {
+	return Shared.printer.auto(this.data);
 };
 
 export default {
+	/* RENDERING */
+	render: render,
+	invalidate: invalidate,
 	/* COMMON */
 	assign: _assign,
 	cast: function(destination, source, type) {
@@ -419,17 +479,17 @@ export default {
 		return _assign(destination, new _bexpr('>>', source_a, source_b));
 	},
 	rotate_left: function(destination, source_a, source_b, bits) {
-		Global().context.addDependency(new CCalls.rotate_left.fcn(bits));
+		Shared.context.addDependency(new CCalls.rotate_left.fcn(bits));
 
 		return new _generic_rotate(destination, source_a, source_b, bits, true);
 	},
 	rotate_right: function(destination, source_a, source_b, bits) {
-		Global().context.addDependency(new CCalls.rotate_right.fcn(bits));
+		Shared.context.addDependency(new CCalls.rotate_right.fcn(bits));
 
 		return new _generic_rotate(destination, source_a, source_b, bits, false);
 	},
 	swap_endian: function(value, returns, bits) {
-		Global().context.addDependency(new CCalls.swap_endian.fcn(bits));
+		Shared.context.addDependency(new CCalls.swap_endian.fcn(bits));
 
 		return _assign(returns, new _generic_call('SWAP' + bits, [value]));
 	},
@@ -440,12 +500,10 @@ export default {
 			_assign(source_a, source_b),
 			_assign(source_b, t),
 		];
-		return new function(composed) {
-			this.composed = composed;
-		}(ops);
+		return new _composed(ops);
 	},
 	bit_mask: function(destination, source_a, source_b) {
-		Global().context.addDependency(new CCalls.bit_mask.fcn());
+		Shared.context.addDependency(new CCalls.bit_mask.fcn());
 
 		return _assign(destination, new _generic_call('BIT_MASK', [source_a, source_b]));
 	},
@@ -468,29 +526,15 @@ export default {
 	},
 	/* SPECIAL */
 	composed: function(instructions) {
-		return new function(composed) {
-			this.composed = composed;
-		}(instructions);
+		return new _composed(instructions);
 	},
 	macro: function(macro, macro_rule) {
-		Global().context.addMacro(macro_rule);
-
-		return new function(macro) {
-			this.macro = macro;
+		Shared.context.addMacro(macro_rule);
 
-			this.toString = function() {
-				return Global().printer.theme.macro(this.macro);
-			};
-		}(macro);
+		return new _macro(macro);
 	},
 	special: function(data) {
-		return new function(data) {
-			this.data = data;
-
-			this.toString = function() {
-				return Global().printer.auto(this.data);
-			};
-		}(data);
+		return new _special(data);
 	},
 	/* Object based langs */
 	method_call: function(object_this, method_separator, function_name, function_arguments, prefix, postfix) {
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 import Extra from './extra.js';
+import Shared from '../shared.js';
 const _cmps = {
 	CUST: ['', ''],
 	INF: ['1', '0'],
@@ -19,7 +20,7 @@ const _cmps = {
 export default {
 	inf: function() {
 		this.toString = function() {
-			return Global().printer.theme.integers('1');
+			return Shared.printer.theme.integers('1');
 		};
 	},
 	convert: function(a, b, cond, invert) {
@@ -29,12 +30,12 @@ export default {
 		this.b = b || '';
 		/* main method */
 		this.toString = function() {
-			var a = Extra.is.string(this.a) ? Global().printer.auto(this.a) : this.a;
-			var b = Extra.is.string(this.b) ? Global().printer.auto(this.b) : this.b;
+			var a = Extra.is.string(this.a) ? Shared.printer.auto(this.a) : this.a;
+			var b = Extra.is.string(this.b) ? Shared.printer.auto(this.b) : this.b;
 			if (this.invert && _cmps[this.condition][1]) {
 				return a + _cmps[this.condition][1] + b;
 			} else if (this.invert) {
-				return '!(' + a + Global().printer.theme.flow(_cmps[this.condition][0]) + b + ')';
+				return '!(' + a + Shared.printer.theme.flow(_cmps[this.condition][0]) + b + ')';
 			}
 			return a + _cmps[this.condition][0] + b;
 		};
@@ -62,6 +62,7 @@ var _set_goto = function(instruction, label) {
 		instruction.valid = true;
 	} else if (instruction.code.composed) {
 		instruction.code.composed.push(Base.goto(label));
+		Base.invalidate(instruction.code);
 	} else {
 		instruction.code = Base.composed([instruction.code, Base.goto(label)]);
 	}
@@ -199,6 +200,7 @@ var _set_if_else = function(instruction, index, context) {
 				context.addLabel(label);
 			}
 			instruction.code.composed.push(Base.goto(label));
+			Base.invalidate(instruction.code);
 		}
 		return true;
 	}
@@ -3,6 +3,7 @@
 
 import _call_common from '../db/macros.js';
 import Long from '../long.js';
+import Shared from '../shared.js';
 
 /**
  * Types size
@@ -85,7 +86,7 @@ const _to = {
 		return (signed ? 'int' : 'uint') + bits + '_t';
 	},
 	bits: function(type) {
-		var bits = Global().evars.archbits;
+		var bits = Shared.evars.archbits;
 		type = type.replace(/[un]?signed\s?/, '');
 		if (type.length == 0) {
 			type = bits < 32 ? 'int16_t' : 'int32_t';
@@ -114,10 +115,11 @@ const _to = {
 const _find = {
 	arguments_number: function(name) {
 		name = _replace.call(name);
-		if (_call_common[name]) {
-			return _call_common[name].required;
-		} else if (Global().argdb) {
-			var db = Global().argdb;
+		var known = _call_common(name);
+		if (known) {
+			return known.required;
+		} else if (Shared.argdb) {
+			var db = Shared.argdb;
 			for (var k in db) {
 				if (_replace.call(db[k].name.replace(/^_+/, '')) == name) {
 					return parseInt(db[k].count.toString());
@@ -128,8 +130,9 @@ const _find = {
 	},
 	call_additional: function(name) {
 		name = _replace.call(name);
-		if (_call_common[name]) {
-			return !!_call_common[name].varargs;
+		var known = _call_common(name);
+		if (known) {
+			return known.varargs;
 		}
 		return false;
 	}
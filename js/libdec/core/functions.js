@@ -3,6 +3,7 @@
 
 import r2pipe from '../r2pipe.js';
 import Utils from './utils.js';
+import Shared from '../shared.js';
 
 var _compare_search = function(a, b) {
     if (a.eq(b.offset)) {
@@ -42,7 +43,7 @@ export default function(aflj, sort_by_name) {
     });
 
     this.search = function(offset) {
-        if (!Global().evars.extra.slow && offset) {
+        if (!Shared.evars.extra.slow && offset) {
             var x = r2pipe.json('afij @ 0x' + offset.toString(16), [])[0];
             return create_fcn_data(x);
         }
@@ -1,12 +1,14 @@
 // SPDX-FileCopyrightText: 2018-2023 Giovanni Dante Grazioli <deroad@libero.it>
 // SPDX-License-Identifier: BSD-3-Clause
 
+import Base from './base.js';
 import Condition from './condition.js';
 import Extra from './extra.js';
 import Long from '../long.js';
+import Shared from '../shared.js';
 
 var _printable = function(instr) {
-	return instr.valid && instr.code && instr.code.toString().length > 0;
+	return instr.valid && instr.code && Base.render(instr.code).length > 0;
 };
 
 var _conditional = function(cond) {
@@ -23,68 +25,73 @@ var _asm_radare2_view = function(instr, ascodeline) {
 			s += (instr.jump.gt(instr.location) ? "if" : "while") + " (" + _conditional(instr.cond) + ") {\n";
 		}
 		for (var i = 0; i < instr.code.composed.length; i++) {
-			s += instr.code.composed[i] + '\n';
+			s += Base.render(instr.code.composed[i]) + '\n';
 		}
 		if (instr.cond && instr.jump) {
 			s += "}\n";
 		}
 	} else if (_printable(instr)) {
 		if (instr.cond && instr.jump) {
-			s += "if (" + _conditional(instr.cond) + ") " + instr.code + "\n";
+			s += "if (" + _conditional(instr.cond) + ") " + Base.render(instr.code) + "\n";
 		} else {
-			s += instr.code + "\n";
+			s += Base.render(instr.code) + "\n";
 		}
 	} else if (instr.cond && !_printable(instr) && instr.jump) {
 		s += "if (" + _conditional(instr.cond) + ") goto 0x" + instr.jump.toString(16);
 	}
 
 	if (ascodeline) {
-		Global().evars.add_code_line(s.trim(), instr.location);
+		Shared.evars.add_code_line(s.trim(), instr.location);
 	} else {
-		Global().evars.add_comment(s.trim(), instr.location);
+		Shared.evars.add_comment(s.trim(), instr.location);
 	}
 };
 
 var _asm_view = function(instr) {
 	var i, t, b, s, addr;
-	if (Global().evars.honor.blocks) {
+	var honor = Shared.evars.honor;
+	var context = Shared.context;
+	if (honor.blocks) {
 		return;
 	}
-	if (Global().evars.honor.offsets) {
-		t = Global().printer.theme;
+	if (honor.offsets) {
+		t = Shared.printer.theme;
 		addr = Extra.align_address(instr.location);
 		if (instr.code && instr.code.composed) {
-			Global().context.printLine(Global().context.identfy(addr.length, t.integers(addr)) + instr.code.composed[0] + ';', instr.location);
+			context.printLine(context.identfy(addr.length, t.integers(addr)) + Base.render(instr.code.composed[0]) + ';', instr.location);
 			for (i = 1; i < instr.code.composed.length; i++) {
-				Global().context.printLine(Global().context.identfy(addr.length, t.integers(addr)) + instr.code.composed[i] + ';', instr.location);
+				context.printLine(context.identfy(addr.length, t.integers(addr)) + Base.render(instr.code.composed[i]) + ';', instr.location);
 			}
 		} else if (_printable(instr)) {
-			Global().context.printLine(Global().context.identfy(addr.length, t.integers(addr)) + instr.code + ';', instr.location);
+			context.printLine(context.identfy(addr.length, t.integers(addr)) + Base.render(instr.code) + ';', instr.location);
 		}
-	} else if (Global().evars.honor.assembly) {
-		t = Global().printer.theme;
-		b = Global().printer.auto;
+	} else if (honor.assembly) {
+		t = Shared.printer.theme;
+		b = Shared.printer.auto;
 		addr = Extra.align_address(instr.location);
 		s = 1 + addr.length + instr.simplified.length;
 		if (instr.code && instr.code.composed) {
-			Global().context.printLine(Global().context.identfy(s, t.integers(addr) + ' ' + b(instr.simplified)) + instr.code.composed[0] + ';', instr.location);
+			context.printLine(context.identfy(s, t.integers(addr) + ' ' + b(instr.simplified)) + Base.render(instr.code.composed[0]) + ';', instr.location);
 			for (i = 1; i < instr.code.composed.length; i++) {
-				Global().context.printLine(Global().context.identfy() + instr.code.composed[i] + ';', instr.location);
+				context.printLine(context.identfy() + Base.render(instr.code.composed[i]) + ';', instr.location);
 			}
 		} else {
-			Global().context.printLine(Global().context.identfy(s, t.integers(addr) + ' ' + b(instr.simplified)) + (_printable(instr) ? (instr.code + ';') : ''), instr.location);
+			context.printLine(context.identfy(s, t.integers(addr) + ' ' + b(instr.simplified)) + (_printable(instr) ? (Base.render(instr.code) + ';') : ''), instr.location);
 		}
 	} else {
 		if (instr.code && instr.code.composed) {
 			for (i = 0; i < instr.code.composed.length; i++) {
-				Global().context.printLine(Global().context.identfy() + instr.code.composed[i] + ';', instr.location);
+				context.printLine(context.identfy() + Base.render(instr.code.composed[i]) + ';', instr.location);
 			}
 		} else if (_printable(instr)) {
-			Global().context.printLine(Global().context.identfy() + instr.code + ';', instr.location);
+			context.printLine(context.identfy() + Base.render(instr.code) + ';', instr.location);
 		}
 	}
 };
 
+/* shared by every instruction without xrefs/refs; never mutated. */
+var _none = Object.freeze([]);
+
 var _instruction = function(data, arch, marker) {
 	this.code = null;
 	this.marker = marker;
@@ -95,9 +102,9 @@ var _instruction = function(data, arch, marker) {
 	this.location = Long.from(data.addr?? data.offset, true);
 	this.assembly = data.disasm || data.opcode;
 	this.simplified = data.opcode;
-	this.cpp_type = this.assembly.match(/(class|method|struct)\s[\w:]+(<[\w:<, >]+>)?\s+/);
-	if (this.cpp_type) {
-		this.assembly = this.assembly.replace(this.cpp_type[0], '');
+	var cpp_type = this.assembly.match(/(class|method|struct)\s[\w:]+(<[\w:<, >]+>)?\s+/);
+	if (cpp_type) {
+		this.assembly = this.assembly.replace(cpp_type[0], '');
 	}
 	this.parsed = arch.parse(this.assembly, this.simplified);
 	this.string = null;
@@ -107,53 +114,73 @@ var _instruction = function(data, arch, marker) {
 	this.label = null;
 	this.cond = null;
 	this.customflow = null;
-	this.xrefs = data.xrefs ? data.xrefs.slice() : [];
-	this.refs = data.refs ? data.refs.slice() : [];
-	this.comments = data.comment ? [atob(data.comment)] : [];
-	if (Global().evars.honor.xrefs) {
+	this.xrefs = data.xrefs || _none;
+	this.refs = data.refs || _none;
+	this._comments = data.comment ? [atob(data.comment)] : null;
+	if (Shared.evars.honor.xrefs) {
 		for (var i = 0; i < this.xrefs.length; i++) {
 			var e = 'XREF ' + this.xrefs[i].type + ": 0x" + this.xrefs[i].addr.toString(16);
 			this.comments.push(e);
 		}
 	}
+};
 
-	this.conditional = function(a, b, type) {
-		if (type) {
-			this.cond = {
-				a: a,
-				b: b,
-				type: type
-			};
-		}
-	};
-
-	this.setBadJump = function() {
-		this.jump = null;
-	};
-
-	this.print = function() {
-		var t = Global().printer.theme;
-		var empty = Global().context.identfy();
-		if (this.comments.length == 1) {
-			Global().context.printLine(empty + t.comment('/* ' + this.comments[0] + ' */'), this.location);
-		} else if (this.comments.length > 1) {
-			Global().context.printLine(empty + t.comment('/* ' + this.comments[0]), this.location);
-			for (var i = 1; i < this.comments.length; i++) {
-				var comment = ' * ' + this.comments[i] + (i == this.comments.length - 1 ? ' */' : '');
-				Global().context.printLine(empty + t.comment(comment), this.location);
-			}
+/**
+ * The comments array is allocated on first access, since most
+ * of the instructions never get one.
+ */
+Object.defineProperty(_instruction.prototype, 'comments', {
+	get: function() {
+		if (!this._comments) {
+			this._comments = [];
 		}
-		if (this.label) {
-			Global().context.printLine(Global().context.identfy(null, null, true) + this.label + ':', this.location);
+		return this._comments;
+	},
+	set: function(comments) {
+		this._comments = comments;
+	}
+});
+
+_instruction.prototype.conditional = function(a, b, type) {
+	if (type) {
+		this.cond = {
+			a: a,
+			b: b,
+			type: type
+		};
+	}
+};
+
+_instruction.prototype.setBadJump = function() {
+	this.jump = null;
+};
+
+_instruction.prototype.print = function() {
+	var t = Shared.printer.theme;
+	var context = Shared.context;
+	var comments = this._comments || _none;
+	var empty = comments.length > 0 ? context.identfy() : '';
+	if (comments.length == 1) {
+		context.printLine(empty + t.comment('/* ' + comments[0] + ' */'), this.location);
+	} else if (comments.length > 1) {
+		context.printLine(empty + t.comment('/* ' + comments[0]), this.location);
+		for (var i = 1; i < comments.length; i++) {
+			var comment = ' * ' + comments[i] + (i == comments.length - 1 ? ' */' : '');
+			context.printLine(empty + t.comment(comment), this.location);
 		}
-		_asm_view(this);
-	};
-	this.ascomment = function() {
-		_asm_radare2_view(this, false);
-	};
-	this.ascodeline = function() {
-		_asm_radare2_view(this, true);
-	};
+	}
+	if (this.label) {
+		context.printLine(context.identfy(null, null, true) + this.label + ':', this.location);
+	}
+	_asm_view(this);
+};
+
+_instruction.prototype.ascomment = function() {
+	_asm_radare2_view(this, false);
+};
+
+_instruction.prototype.ascodeline = function() {
+	_asm_radare2_view(this, true);
 };
 
 _instruction.swap = function(instructions, index_a, index_b) {
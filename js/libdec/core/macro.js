@@ -1,12 +1,14 @@
 // SPDX-FileCopyrightText: 2018-2023 Giovanni Dante Grazioli <deroad@libero.it>
 // SPDX-License-Identifier: BSD-3-Clause
 
+import Shared from '../shared.js';
+
 export default function(data) {
 	this.data = data;
 	this.print = function() {
-		var t = Global().printer.theme;
+		var t = Shared.printer.theme;
 		for (var i = 0; i < this.data.length; i++) {
-			Global().context.printLine(Global().context.identfy() + t.macro(this.data[i]));
+			Shared.context.printLine(Shared.context.identfy() + t.macro(this.data[i]));
 		}
 	};
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 import Extra from './extra.js';
 import Base from './base.js';
+import Shared from '../shared.js';
 
 const _x86_stret = {
 	'32': {
@@ -220,7 +221,7 @@ const _object_c_block_methods = {
 		} else {
 			context.object_c.autorelease.push(instr);
 		}
-		instr.customflow = '@' + Global().printer.theme.flow('autoreleasepool');
+		instr.customflow = '@' + Shared.printer.theme.flow('autoreleasepool');
 		return Base.nop();
 	},
 	objc_autoreleasePoolPop: function(instr, context, instructions) {
@@ -231,13 +232,13 @@ const _object_c_block_methods = {
 		return Base.nop();
 	},
 	objc_release: function() {
-		var arch = Global().evars.arch;
-		var bits = Global().evars.archbits.toString();
+		var arch = Shared.evars.arch;
+		var bits = Shared.evars.archbits.toString();
 		return Base.objc_call(_object_c_registers[arch][bits][0], 'release');
 	},
 	objc_retain: function() {
-		var arch = Global().evars.arch;
-		var bits = Global().evars.archbits.toString();
+		var arch = Shared.evars.arch;
+		var bits = Shared.evars.archbits.toString();
 		return Base.objc_call(_object_c_registers[arch][bits][0], 'retain');
 	},
 };
@@ -245,26 +246,26 @@ const _object_c_block_methods = {
 export default {
 	arguments: function(callname) {
 		callname = Extra.replace.call(callname);
-		var arch = Global().evars.arch;
-		var bits = Global().evars.archbits.toString();
+		var arch = Shared.evars.arch;
+		var bits = Shared.evars.archbits.toString();
 		return _object_c_class_methods[callname][arch][bits].args.slice();
 	},
 	returns: function(callname) {
 		callname = Extra.replace.call(callname);
-		var arch = Global().evars.arch;
-		var bits = Global().evars.archbits.toString();
+		var arch = Shared.evars.arch;
+		var bits = Shared.evars.archbits.toString();
 		return _object_c_class_methods[callname][arch][bits].returns;
 	},
 	receiver: function(callname) {
 		callname = Extra.replace.call(callname);
-		var arch = Global().evars.arch;
-		var bits = Global().evars.archbits.toString();
+		var arch = Shared.evars.arch;
+		var bits = Shared.evars.archbits.toString();
 		return _object_c_class_methods[callname][arch][bits].receiver;
 	},
 	selector: function(callname) {
 		callname = Extra.replace.call(callname);
-		var arch = Global().evars.arch;
-		var bits = Global().evars.archbits.toString();
+		var arch = Shared.evars.arch;
+		var bits = Shared.evars.archbits.toString();
 		return _object_c_class_methods[callname][arch][bits].selector;
 	},
 	handle_others: function(callname, instr, context, instructions) {
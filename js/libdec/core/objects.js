@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 import Extra from './extra.js';
+import Shared from '../shared.js';
 
 const _java = {
 	array: function(type, size, create, init) {
@@ -9,7 +10,7 @@ const _java = {
 		this.type = Extra.replace.object(type);
 		this.init = init;
 		this.toString = function() {
-			var t = [Global().printer.theme.flow('new'), Global().printer.theme.callname(this.type), '[' + this.size + ']'];
+			var t = [Shared.printer.theme.flow('new'), Shared.printer.theme.callname(this.type), '[' + this.size + ']'];
 			if (this.init && this.init.length > 0) {
 				t.push('{' + this.init.join(', ') + '}');
 			}
@@ -23,9 +24,9 @@ const _java = {
 		this.toString = function() {
 			var a = this.args.length > 0 ? '(' + this.args.join(', ') + ')' : '';
 			if (this.create) {
-				return [Global().printer.theme.flow('new'), Global().printer.theme.callname(this.type), a].join(' ').trim();
+				return [Shared.printer.theme.flow('new'), Shared.printer.theme.callname(this.type), a].join(' ').trim();
 			}
-			return [Global().printer.theme.callname(this.type), a].join(' ').trim();
+			return [Shared.printer.theme.callname(this.type), a].join(' ').trim();
 		};
 	}
 };
@@ -37,14 +38,14 @@ const _all_langs = {
 
 export default {
 	array: function(type, size, create, lang, init) {
-		lang = lang || Global().evars.arch;
+		lang = lang || Shared.evars.arch;
 		if (!_all_langs[lang]) {
 			throw new Error('Missing lang for array (objects.js)');
 		}
 		return new _all_langs[lang].array(type, size, create, init || []);
 	},
 	object: function(type, args, create, lang) {
-		lang = lang || Global().evars.arch;
+		lang = lang || Shared.evars.arch;
 		if (!_all_langs[lang]) {
 			throw new Error('Missing lang for object (objects.js)');
 		}
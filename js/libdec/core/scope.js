@@ -2,169 +2,206 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 import Extra from './extra.js';
+import Shared from '../shared.js';
 var __debug = false;
 
 function _print_locals(locals, address, spaced) {
-	if (Global().evars.honor.blocks) {
+	if (Shared.evars.honor.blocks) {
 		return;
 	}
-	if (!Global().evars.honor.vars) {
+	if (!Shared.evars.honor.vars) {
 		return;
 	}
-	var a = Global().printer.auto;
+	var a = Shared.printer.auto;
 	for (var i = 0; i < locals.length; i++) {
 		var local = Extra.is.string(locals[i]) ? a(locals[i]) : locals[i].toString(true);
-		Global().context.printLine(Global().context.identfy() + local + ';', address);
+		Shared.context.printLine(Shared.context.identfy() + local + ';', address);
 	}
 	if (spaced && locals.length > 0) {
-		Global().context.printLine(Global().context.identfy(), address);
+		Shared.context.printLine(Shared.context.identfy(), address);
 	}
 }
 
 function _print_block_data(block) {
-	if (Global().evars.honor.blocks) {
-		var t = Global().printer.theme;
-		var ident = Global().context.identfy();
+	if (Shared.evars.honor.blocks) {
+		var t = Shared.printer.theme;
+		var ident = Shared.context.identfy();
 		var addr = block.address.toString(16);
-		Global().context.printLine(ident + t.comment('/* address 0x' + addr + ' */'), block.address);
+		Shared.context.printLine(ident + t.comment('/* address 0x' + addr + ' */'), block.address);
 	}
 }
 
+var _brace = function(address) {
+	this.address = address;
+};
+
+_brace.prototype.toString = function() {
+	return '}' + (__debug ? Shared.printer.theme.comment(' // 0x' + this.address.toString(16)) : '');
+};
+
+_brace.prototype.print = function() {
+	Shared.context.identOut();
+	var offset = Shared.evars.honor.offsets ? Extra.align_address(this.address) : '';
+	Shared.context.printLine(Shared.context.identfy(offset.length, Shared.printer.theme.integers(offset)) + this.toString(), this.address);
+};
+
+var _custom = function(address, colorname) {
+	this.address = address;
+	this.colorname = colorname;
+};
+
+_custom.prototype.toString = function() {
+	return this.colorname + ' {' + (__debug ? Shared.printer.theme.comment(' // 0x' + this.address.toString(16)) : '');
+};
+
+_custom.prototype.print = function() {
+	var offset = Shared.evars.honor.offsets ? Extra.align_address(this.address) : '';
+	Shared.context.printLine(Shared.context.identfy(offset.length, Shared.printer.theme.integers(offset)) + this.toString(), this.address);
+	Shared.context.identIn();
+	_print_block_data(this);
+};
+
+var _routine = function(address, extra) {
+	this.address = address;
+	this.extra = extra;
+};
+
+_routine.prototype.toString = function() {
+	var e = this.extra;
+	var t = Shared.printer.theme;
+	var a = Shared.printer.auto;
+	return t.types(e.returns) + ' ' + t.callname(e.routine_name) + ' (' + e.args.map(function(x) {
+		return Extra.is.string(x) ? a(x) : x.toString(true);
+	}).join(', ') + ') {' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
+};
+
+_routine.prototype.print = function() {
+	var e = this.extra;
+	var t = Shared.printer.theme;
+	_print_locals(e.globals, this.address, true);
+	var asmname = Shared.evars.honor.offsets ? Extra.align_address(this.address) : '; (fcn) ' + e.name + ' ()';
+	var color = Shared.evars.honor.offsets ? 'integers' : 'comment';
+	var ident = Shared.context.identfy(asmname.length, t[color](asmname));
+	Shared.context.printLine(ident + this.toString(), this.address);
+	Shared.context.identIn();
+	_print_block_data(this);
+	_print_locals(e.locals, this.address);
+};
+
+var _if = function(address, condition, locals) {
+	this.address = address;
+	this.condition = condition;
+	this.locals = locals || [];
+};
+
+_if.prototype.toString = function() {
+	var t = Shared.printer.theme;
+	return t.flow('if') + ' (' + this.condition + ') {' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
+};
+
+_if.prototype.print = function() {
+	var offset = Shared.evars.honor.offsets ? Extra.align_address(this.address) : '';
+	Shared.context.printLine(Shared.context.identfy(offset.length, Shared.printer.theme.integers(offset)) + this.toString(), this.address);
+	Shared.context.identIn();
+	_print_block_data(this);
+	_print_locals(this.locals, this.address);
+};
+
+var _else = function(address, locals) {
+	this.isElse = true;
+	this.address = address;
+	this.locals = locals || [];
+};
+
+_else.prototype.toString = function() {
+	var t = Shared.printer.theme;
+	return '} ' + t.flow('else') + ' {' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
+};
+
+_else.prototype.print = function() {
+	Shared.context.identOut();
+	var offset = Shared.evars.honor.offsets ? Extra.align_address(this.address) : '';
+	Shared.context.printLine(Shared.context.identfy(offset.length, Shared.printer.theme.integers(offset)) + this.toString(), this.address);
+	Shared.context.identIn();
+	_print_block_data(this);
+	_print_locals(this.locals, this.address);
+};
+
+var _do = function(address, locals) {
+	this.address = address;
+	this.locals = locals || [];
+};
+
+_do.prototype.toString = function() {
+	var t = Shared.printer.theme;
+	return t.flow('do') + ' {' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
+};
+
+_do.prototype.print = function() {
+	Shared.context.printLine(Shared.context.identfy() + this.toString(), this.address);
+	Shared.context.identIn();
+	_print_block_data(this);
+	_print_locals(this.locals, this.address);
+};
+
+var _while = function(address, condition, locals) {
+	this.address = address;
+	this.condition = condition;
+	this.locals = locals || [];
+};
+
+_while.prototype.toString = function() {
+	var t = Shared.printer.theme;
+	return t.flow('while') + ' (' + this.condition + ') {' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
+};
+
+_while.prototype.print = function() {
+	var offset = Shared.evars.honor.offsets ? Extra.align_address(this.address) : '';
+	Shared.context.printLine(Shared.context.identfy(offset.length, Shared.printer.theme.integers(offset)) + this.toString(), this.address);
+	Shared.context.identIn();
+	_print_block_data(this);
+	_print_locals(this.locals, this.address);
+};
+
+var _whileEnd = function(address, condition) {
+	this.address = address;
+	this.condition = condition;
+};
+
+_whileEnd.prototype.toString = function() {
+	var t = Shared.printer.theme;
+	return '} ' + t.flow('while') + ' (' + this.condition + ');' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
+};
+
+_whileEnd.prototype.print = function() {
+	Shared.context.identOut();
+	Shared.context.printLine(Shared.context.identfy() + this.toString(), this.address);
+};
+
+var _whileInline = function(address, condition) {
+	this.address = address;
+	this.condition = condition;
+};
+
+_whileInline.prototype.toString = function() {
+	var t = Shared.printer.theme;
+	return t.flow('while') + ' (' + this.condition + ');' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
+};
+
+_whileInline.prototype.print = function() {
+	_print_block_data(this);
+	var offset = Shared.evars.honor.offsets ? Extra.align_address(this.address) : '';
+	Shared.context.printLine(Shared.context.identfy(offset.length, Shared.printer.theme.integers(offset)) + this.toString(), this.address);
+};
+
 export default {
-	brace: function(address) {
-		this.address = address;
-		this.toString = function() {
-			return '}' + (__debug ? Global().printer.theme.comment(' // 0x' + this.address.toString(16)) : '');
-		};
-		this.print = function() {
-			Global().context.identOut();
-			var offset = Global().evars.honor.offsets ? Extra.align_address(this.address) : '';
-			Global().context.printLine(Global().context.identfy(offset.length, Global().printer.theme.integers(offset)) + this.toString(), this.address);
-		};
-	},
-	custom: function(address, colorname) {
-		this.address = address;
-		this.colorname = colorname;
-		this.toString = function() {
-			return this.colorname + ' {' + (__debug ? Global().printer.theme.comment(' // 0x' + this.address.toString(16)) : '');
-		};
-		this.print = function() {
-			var offset = Global().evars.honor.offsets ? Extra.align_address(this.address) : '';
-			Global().context.printLine(Global().context.identfy(offset.length, Global().printer.theme.integers(offset)) + this.toString(), this.address);
-			Global().context.identIn();
-			_print_block_data(this);
-		};
-	},
-	routine: function(address, extra) {
-		this.address = address;
-		this.extra = extra;
-		this.toString = function() {
-			var e = this.extra;
-			var t = Global().printer.theme;
-			var a = Global().printer.auto;
-			return t.types(e.returns) + ' ' + t.callname(e.routine_name) + ' (' + e.args.map(function(x) {
-				return Extra.is.string(x) ? a(x) : x.toString(true);
-			}).join(', ') + ') {' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
-		};
-		this.print = function() {
-			var e = this.extra;
-			var t = Global().printer.theme;
-			_print_locals(e.globals, this.address, true);
-			var asmname = Global().evars.honor.offsets ? Extra.align_address(this.address) : '; (fcn) ' + e.name + ' ()';
-			var color = Global().evars.honor.offsets ? 'integers' : 'comment';
-			var ident = Global().context.identfy(asmname.length, t[color](asmname));
-			Global().context.printLine(ident + this.toString(), this.address);
-			Global().context.identIn();
-			_print_block_data(this);
-			_print_locals(e.locals, this.address);
-		};
-	},
-	if: function(address, condition, locals) {
-		this.address = address;
-		this.condition = condition;
-		this.locals = locals || [];
-		this.toString = function() {
-			var t = Global().printer.theme;
-			return t.flow('if') + ' (' + this.condition + ') {' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
-		};
-		this.print = function() {
-			var offset = Global().evars.honor.offsets ? Extra.align_address(this.address) : '';
-			Global().context.printLine(Global().context.identfy(offset.length, Global().printer.theme.integers(offset)) + this.toString(), this.address);
-			Global().context.identIn();
-			_print_block_data(this);
-			_print_locals(this.locals, this.address);
-		};
-	},
-	else: function(address, locals) {
-		this.isElse = true;
-		this.address = address;
-		this.locals = locals || [];
-		this.toString = function() {
-			var t = Global().printer.theme;
-			return '} ' + t.flow('else') + ' {' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
-		};
-		this.print = function() {
-			Global().context.identOut();
-			var offset = Global().evars.honor.offsets ? Extra.align_address(this.address) : '';
-			Global().context.printLine(Global().context.identfy(offset.length, Global().printer.theme.integers(offset)) + this.toString(), this.address);
-			Global().context.identIn();
-			_print_block_data(this);
-			_print_locals(this.locals, this.address);
-		};
-	},
-	do: function(address, locals) {
-		this.address = address;
-		this.locals = locals || [];
-		this.toString = function() {
-			var t = Global().printer.theme;
-			return t.flow('do') + ' {' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
-		};
-		this.print = function() {
-			Global().context.printLine(Global().context.identfy() + this.toString(), this.address);
-			Global().context.identIn();
-			_print_block_data(this);
-			_print_locals(this.locals, this.address);
-		};
-	},
-	while: function(address, condition, locals) {
-		this.address = address;
-		this.condition = condition;
-		this.locals = locals || [];
-		this.toString = function() {
-			var t = Global().printer.theme;
-			return t.flow('while') + ' (' + this.condition + ') {' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
-		};
-		this.print = function() {
-			var offset = Global().evars.honor.offsets ? Extra.align_address(this.address) : '';
-			Global().context.printLine(Global().context.identfy(offset.length, Global().printer.theme.integers(offset)) + this.toString(), this.address);
-			Global().context.identIn();
-			_print_block_data(this);
-			_print_locals(this.locals, this.address);
-		};
-	},
-	whileEnd: function(address, condition) {
-		this.address = address;
-		this.condition = condition;
-		this.toString = function() {
-			var t = Global().printer.theme;
-			return '} ' + t.flow('while') + ' (' + this.condition + ');' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
-		};
-		this.print = function() {
-			Global().context.identOut();
-			Global().context.printLine(Global().context.identfy() + this.toString(), this.address);
-		};
-	},
-	whileInline: function(address, condition) {
-		this.address = address;
-		this.condition = condition;
-		this.toString = function() {
-			var t = Global().printer.theme;
-			return t.flow('while') + ' (' + this.condition + ');' + (__debug ? t.comment(' // 0x' + this.address.toString(16)) : '');
-		};
-		this.print = function() {
-			_print_block_data(this);
-			var offset = Global().evars.honor.offsets ? Extra.align_address(this.address) : '';
-			Global().context.printLine(Global().context.identfy(offset.length, Global().printer.theme.integers(offset)) + this.toString(), this.address);
-		};
-	}
+	brace: _brace,
+	custom: _custom,
+	routine: _routine,
+	if: _if,
+	else: _else,
+	do: _do,
+	while: _while,
+	whileEnd: _whileEnd,
+	whileInline: _whileInline
 };
@@ -3,22 +3,19 @@
 
 import r2pipe from '../r2pipe.js';
 import Utils from './utils.js';
+import Shared from '../shared.js';
 
 var _compare = function(a, b) {
-    if (a.eq(b.location)) {
+    if (a.eq(b)) {
         return 0;
-    } else if (a.lt(b.location)) {
+    } else if (a.lt(b)) {
         return 1;
     }
     return -1;
 };
 
-var _str_compare_location = function(a, b) {
-    return a.location.lt(b.location) ? -1 : (a.location.eq(b.location) ? 0 : 1);
-};
-
-var _str_compare_size = function(a, b) {
-    return a.value < b.value ? -1 : (a.value == b.value ? 0 : 1);
+var _decode = function(encoded) {
+    return atob(encoded).replace(/\\\\/g, '\\');
 };
 
 var _sanitize = function(x) {
@@ -40,33 +37,84 @@ var _flag_filter = function(x) {
     return '_';
 };
 
+var _flag_name = function(value) {
+    var elem = 'str.' + value.split('').map(_flag_filter).join('').trim();
+    elem = elem.replace(/\\[abnrtv]/g, '_').replace(/\\/g, '_');
+    elem = elem.replace(/^str._+/, 'str.');
+    return elem.replace(/_+$/, '');
+};
+
 /*
  * Expects the Csj json as input.
+ * The entries are kept base64 encoded in arrays sorted by location and each
+ * value is decoded only when a search hits it (Csj can be huge while a
+ * function references only a few strings); sorting by size needs all the
+ * values, thus it decodes them upfront.
  */
 export default function(Csj, sort_by_size) {
-    this.data = Csj.filter(_sanitize).map(function(x) {
-        return {
-            location: Global().evars.honor.paddr ? x.paddr : x.vaddr || x.offset,
-            value: atob(x.string || x.name).replace(/\\\\/g, '\\')
-        };
-    }).sort(sort_by_size ? _str_compare_size : _str_compare_location);
+    var paddr = Shared.evars.honor.paddr;
+    var entries = Csj.filter(_sanitize);
+    var order = entries.map(function(x, i) {
+        return i;
+    });
+    var location = function(i) {
+        var x = entries[i];
+        return paddr ? x.paddr : x.vaddr || x.offset;
+    };
+    var encoded = function(i) {
+        var x = entries[i];
+        return x.string || x.name;
+    };
+    var values = new Array(entries.length);
+    if (sort_by_size) {
+        order.forEach(function(i) {
+            values[i] = _decode(encoded(i));
+        });
+        order.sort(function(a, b) {
+            return values[a] < values[b] ? -1 : (values[a] == values[b] ? 0 : 1);
+        });
+    } else {
+        // Csj is usually already sorted by address.
+        var sorted = true;
+        for (var i = 1; i < order.length && sorted; i++) {
+            sorted = !location(i).lt(location(i - 1));
+        }
+        if (!sorted) {
+            order.sort(function(a, b) {
+                var la = location(a), lb = location(b);
+                return la.lt(lb) ? -1 : (la.eq(lb) ? 0 : 1);
+            });
+        }
+    }
+    this.locations = order.map(location);
+    this.encoded = order.map(encoded);
+    this.values = sort_by_size ? order.map(function(i) {
+        return values[i];
+    }) : values;
+    this.flags = new Array(order.length);
+    this.value = function(index) {
+        if (this.values[index] === undefined) {
+            this.values[index] = _decode(this.encoded[index]);
+        }
+        return this.values[index];
+    };
     this.search = function(address) {
         if (address) {
-            if (!Global().evars.extra.slow) {
+            if (!Shared.evars.extra.slow) {
                 var x = r2pipe.string('Cs.q @ 0x' + address.toString(16));
                 if (x) {
                     x = x.substr(1);
                     return x.substr(0, x.length - 1);
                 }
             }
-            var r = Utils.search(address, this.data, _compare);
-            return r ? r.value : null;
+            var index = Utils.indexOf(address, this.locations, _compare);
+            return index >= 0 ? this.value(index) : null;
         }
         return null;
     };
     this.search_by_flag = function(flag) {
         if (flag && flag.startsWith('str.')) {
-            if (!Global().evars.extra.slow) {
+            if (!Shared.evars.extra.slow) {
                 var address = r2pipe.string('s @ ' + flag);
                 var x = r2pipe.string('Cs.q @ ' + address.toString(16));
                 if (x) {
@@ -74,16 +122,15 @@ export default function(Csj, sort_by_size) {
                     return x.substr(0, x.length - 1);
                 }
             }
-            for (var i = 0; i < this.data.length; i++) {
-                var elem = 'str.' + this.data[i].value.split('').map(_flag_filter).join('').trim();
-                elem = elem.replace(/\\[abnrtv]/g, '_').replace(/\\/g, '_');
-                elem = elem.replace(/^str._+/, 'str.');
-                elem = elem.replace(/_+$/, '');
-                if (elem == flag) {
-                    return this.data[i].value;
+            for (var i = 0; i < this.flags.length; i++) {
+                if (this.flags[i] === undefined) {
+                    this.flags[i] = _flag_name(this.value(i));
+                }
+                if (this.flags[i] == flag) {
+                    return this.value(i);
                 }
             }
         }
         return null;
     };
-}
\ No newline at end of file
+}
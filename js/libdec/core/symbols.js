@@ -4,6 +4,7 @@
 import r2pipe from '../r2pipe.js';
 import Utils from './utils.js';
 import Long from '../long.js';
+import Shared from '../shared.js';
 
 var _compare = function(a, b) {
 	if (a.eq(b.location)) {
@@ -30,14 +31,14 @@ var _sanitize = function(x) {
  * Expects the isj json as input.
  */
 export default function(isj) {
-	this.data = isj.filter(_sanitize).sort(Global().evars.honor.paddr ? _physical_compare : _virtual_compare).map(function(x) {
+	this.data = isj.filter(_sanitize).sort(Shared.evars.honor.paddr ? _physical_compare : _virtual_compare).map(function(x) {
 		return {
-			location: Global().evars.honor.paddr ? x.paddr : x.vaddr,
+			location: Shared.evars.honor.paddr ? x.paddr : x.vaddr,
 			value: (x.demname && x.demname.length > 0) ? x.demname : x.name,
 		};
 	});
 	this.search = function(address) {
-		const evars = Global().evars;
+		const evars = Shared.evars;
 		if (!address) {
 			return null;
 		} else if (!Long.isLong(address)) {
@@ -5,6 +5,7 @@
 import Extra from './extra.js';
 import Objects from './objects.js';
 import Long from '../long.js';
+import Shared from '../shared.js';
 
 var _internal_label_cnt = 0;
 var _internal_variable_cnt = 0;
@@ -24,70 +25,70 @@ var autoParen = function(s) {
 var _label = function(name, address) {
     this.name = name;
     this.address = address;
+};
 
-    this.toString = function() {
-        return Global().printer.theme.labels(this.name);
-    };
+_label.prototype.toString = function() {
+    return Shared.printer.theme.labels(this.name);
 };
 
 var _func_ptr = function(name, type, args) {
     this.name = name;
     this.type = type;
     this.args = args.map(function(x) {
-        return x.toType ? x.toType() : ('uint' + Global().evars.archbits + '_t');
+        return x.toType ? x.toType() : ('uint' + Shared.evars.archbits + '_t');
     });
+};
 
-    this.toType = function() {
-        return Global().printer.theme.types(this.type) + ' (*)(' + this.args.join(', ') + ')';
-    };
+_func_ptr.prototype.toType = function() {
+    return Shared.printer.theme.types(this.type) + ' (*)(' + this.args.join(', ') + ')';
+};
 
-    this.toString = function() {
-        return Global().printer.theme.types(this.type) + ' (*' + Global().printer.auto(this.name) + ')(' + this.args.join(', ') + ')';
-    };
+_func_ptr.prototype.toString = function() {
+    return Shared.printer.theme.types(this.type) + ' (*' + Shared.printer.auto(this.name) + ')(' + this.args.join(', ') + ')';
 };
 
 var _ptr = function(name, type, pointer) {
     this.name = name;
     this.type = type;
     this.pointer = pointer;
+};
 
-    this.toType = function() {
-        return Global().printer.theme.types(this.type) + '*';
-    };
-
-    this.toString = function(define) {
-        if (define) {
-            var suffix = '';
-            if (this.pointer) {
-                suffix = ' = ' + Global().printer.auto(this.pointer);
-            }
-            return Global().printer.theme.types(this.type) + '* ' + this.name + suffix;
-        }
+_ptr.prototype.toType = function() {
+    return Shared.printer.theme.types(this.type) + '*';
+};
 
-        var c = '*(';
-        if (Global().evars.honor.casts) {
-            c += '(' + Global().printer.theme.types(this.type) + '*) ';
+_ptr.prototype.toString = function(define) {
+    if (define) {
+        var suffix = '';
+        if (this.pointer) {
+            suffix = ' = ' + Shared.printer.auto(this.pointer);
         }
+        return Shared.printer.theme.types(this.type) + '* ' + this.name + suffix;
+    }
 
-        return c + Global().printer.auto(autoParen(this.name)) + ')';
-    };
+    var c = '*(';
+    if (Shared.evars.honor.casts) {
+        c += '(' + Shared.printer.theme.types(this.type) + '*) ';
+    }
+
+    return c + Shared.printer.auto(autoParen(this.name)) + ')';
 };
 
 var _local = function(name, type) {
     this.name = name;
     this.type = type;
+};
 
-    this.toType = function() {
-        return Global().printer.theme.types(this.type);
-    };
+_local.prototype.toType = function() {
+    return Shared.printer.theme.types(this.type);
+};
 
-    this.toString = function(define) {
-        if (define) {
-            return Global().printer.theme.types(this.type) + ' ' + Global().printer.auto(this.name);
-        }
+_local.prototype.toString = function(define) {
+    if (define) {
+        return Shared.printer.theme.types(this.type) + ' ' + Shared.printer.auto(this.name);
+    }
 
-        return Global().printer.auto(this.name);
-    };
+    return Shared.printer.auto(this.name);
 };
 
 var _string = function(content) {
@@ -99,43 +100,47 @@ var _string = function(content) {
         this.content += '"';
     }
     this.content = this.content.replace(/\n/g, '\\n').replace(/\r/g, '\\r');
+};
 
-    this.toType = function() {
-        return Global().printer.theme.types('char') + '*';
-    };
+_string.prototype.toType = function() {
+    return Shared.printer.theme.types('char') + '*';
+};
 
-    this.toString = function(define) {
-        return define ? null : Global().printer.theme.text(this.content);
-    };
+_string.prototype.toString = function(define) {
+    return define ? null : Shared.printer.theme.text(this.content);
 };
 
 var _number = function(content) {
     this.content = Long.isLong(content) ? ('0x' + content.toString(16)) : content;
+};
 
-    this.toType = function() {
-        return '';
-    };
+_number.prototype.toType = function() {
+    return '';
+};
 
-    this.toString = function(define) {
-        return define ? null : Global().printer.theme.integers(this.content);
-    };
+_number.prototype.toString = function(define) {
+    return define ? null : Shared.printer.theme.integers(this.content);
 };
 
 var _macro = function(content) {
     this.content = content;
+};
 
-    this.toType = function() {
-        return '';
-    };
+_macro.prototype.toType = function() {
+    return '';
+};
 
-    this.toString = function(define) {
-        return define ? null : Global().printer.theme.macro(this.content);
-    };
+_macro.prototype.toString = function(define) {
+    return define ? null : Shared.printer.theme.macro(this.content);
 };
 
 // ------------------------------
 
 export default {
+    resetNames: function() {
+        _internal_label_cnt = 0;
+        _internal_variable_cnt = 0;
+    },
     uniqueName: function(variable_name) {
         var n = _internal_variable_cnt++;
 
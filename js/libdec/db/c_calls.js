@@ -1,15 +1,27 @@
 // SPDX-FileCopyrightText: 2018-2023 Giovanni Dante Grazioli <deroad@libero.it>
 // SPDX-License-Identifier: BSD-3-Clause
 
+import Shared from '../shared.js';
+
 var mident = '    ';
-var _unique_print = {
-	rotate_left: [],
-	rotate_right: [],
-	bit_mask: false,
-	swap_endian: [],
+var _unique_print = null;
+
+var _reset_printed = function() {
+	_unique_print = {
+		rotate_left: [],
+		rotate_right: [],
+		bit_mask: false,
+		swap_endian: [],
+	};
 };
+_reset_printed();
 
 export default {
+	/**
+	 * Each helper is printed once per run; the runtime is reused between
+	 * runs, so the main module calls this on every run.
+	 */
+	resetPrinted: _reset_printed,
 	rotate_left: {
 		macros: ['#include <stdint.h>', '#include <limits.h>'],
 		fcn: function(bits) {
@@ -35,13 +47,13 @@ export default {
 					return x.replace(/###/g, bits);
 				});
 				args = args[0] + ' ' + args[1] + ', ' + args[2] + ' ' + args[3];
-				var a = Global().printer.auto;
-				var t = Global().printer.theme;
-				Global().context.printLine(Global().context.identfy() + t.types(type) + ' ' + t.callname(call) + ' (' + args + ') {', offset);
+				var a = Shared.printer.auto;
+				var t = Shared.printer.theme;
+				Shared.context.printLine(Shared.context.identfy() + t.types(type) + ' ' + t.callname(call) + ' (' + args + ') {', offset);
 				for (i = 0; i < this.data.length; i++) {
-					Global().context.printLine(Global().context.identfy() + a(this.data[i].replace(/###/g, this.bits)), offset);
+					Shared.context.printLine(Shared.context.identfy() + a(this.data[i].replace(/###/g, this.bits)), offset);
 				}
-				Global().context.printLine(Global().context.identfy() + '}', offset);
+				Shared.context.printLine(Shared.context.identfy() + '}', offset);
 			};
 		}
 	},
@@ -69,14 +81,14 @@ export default {
 				var args = this.args.map(function(x) {
 					return x.replace(/###/g, bits);
 				});
-				var a = Global().printer.auto;
-				var t = Global().printer.theme;
+				var a = Shared.printer.auto;
+				var t = Shared.printer.theme;
 				args = args[0] + ' ' + args[1] + ', ' + args[2] + ' ' + args[3];
-				Global().context.printLine(Global().context.identfy() + t.types(type) + ' ' + t.callname(call) + ' (' + args + ') {', offset);
+				Shared.context.printLine(Shared.context.identfy() + t.types(type) + ' ' + t.callname(call) + ' (' + args + ') {', offset);
 				for (i = 0; i < this.data.length; i++) {
-					Global().context.printLine(Global().context.identfy() + a(this.data[i].replace(/###/g, this.bits)), offset);
+					Shared.context.printLine(Shared.context.identfy() + a(this.data[i].replace(/###/g, this.bits)), offset);
 				}
-				Global().context.printLine(Global().context.identfy() + '}', offset);
+				Shared.context.printLine(Shared.context.identfy() + '}', offset);
 			};
 		}
 	},
@@ -91,8 +103,8 @@ export default {
 					return;
 				}
 				_unique_print.bit_mask = true;
-				var t = Global().printer.theme;
-				Global().context.printLine(Global().context.identfy() + t.macro(this.mask), offset);
+				var t = Shared.printer.theme;
+				Shared.context.printLine(Shared.context.identfy() + t.macro(this.mask), offset);
 			};
 		}
 	},
@@ -125,9 +137,9 @@ export default {
 					return;
 				}
 				_unique_print.swap_endian.push(this.bits);
-				var t = Global().printer.theme;
+				var t = Shared.printer.theme;
 				for (var i = 0; i < this.data.length; i++) {
-					Global().context.printLine(Global().context.identfy() + t.macro(this.data[i]), offset);
+					Shared.context.printLine(Shared.context.identfy() + t.macro(this.data[i]), offset);
 				}
 			};
 		}
@@ -3,6 +3,7 @@
 
 const _known_cpp_data = {
 	'std::basic_string<char,std::char_traits<char>,std::allocator<char>>,std::allocator<std::basic_string<char,std::char_traits<char>,std::allocator<char>>>': 'std::string',
+	'std::basic_string<char,std::char_traits<char>,std::allocator<char>>,std::allocator<std::basic_string<char,std::char_traits<char>,std::allocator<char>>>const': 'std::string const',
 	'std::basic_stringstream<char,std::char_traits<char>,std::allocator<char>>::basic_stringstream': 'std::stringstream ',
 	'std::basic_istringstream<char,std::char_traits<char>,std::allocator<char>>::basic_istringstream': 'std::istringstream ',
 	'std::basic_ostringstream<char,std::char_traits<char>,std::allocator<char>>::basic_ostringstream': 'std::ostringstream ',
@@ -35,18 +36,37 @@ const _known_cpp_data = {
 	'operator|': 'operator | ',
 
 	'std::stringconst': 'std::string const',
+	'unsignedlonglong': 'unsigned long long',
 	'unsignedlong': 'unsigned long',
 	'longlong': 'long long',
 	'charconst': 'char const',
 };
 
+// one pass over the symbol, longest keys first, thus a key wins over the keys it
+// contains (i.e. operator+= and operator+); the output of a key is not matched
+// again, thus combined keys (i.e. unsignedlonglong) are listed in the table.
+const _known_cpp_regex = new RegExp(Object.keys(_known_cpp_data).sort(function(a, b) {
+	return b.length - a.length;
+}).map(function(key) {
+	return key.replace(/([()[\]|\\*+])/g, '\\$1');
+}).join('|'), 'g');
+
+const _known_cpp_replace = function(key) {
+	return _known_cpp_data[key];
+};
+
+// the same symbols are printed again and again, and the runtime outlives a single run.
+const _simplified_max = 8192;
+var _simplified = new Map();
+
 export default function(str) {
-	str = str.replace(/::_cxx\d\d::/g, '::').replace(/\s+/g, '');
-	for (var key in _known_cpp_data) {
-		if (str.indexOf(key) >= 0) {
-			var find = new RegExp(key.replace(/([()[\]|\\*+])/g, '\\$1'), 'g');
-			str = str.replace(find, _known_cpp_data[key]);
+	var simple = _simplified.get(str);
+	if (simple === undefined) {
+		simple = str.replace(/::_cxx\d\d::/g, '::').replace(/\s+/g, '').replace(_known_cpp_regex, _known_cpp_replace);
+		if (_simplified.size >= _simplified_max) {
+			_simplified = new Map();
 		}
+		_simplified.set(str, simple);
 	}
-	return str;
-}
\ No newline at end of file
+	return simple;
+}
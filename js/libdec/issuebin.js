@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: 2026 Giovanni Dante Grazioli <deroad@kumo.xn--q9jyb4c>
+// SPDX-License-Identifier: BSD-3-Clause
+
+import Long from './long.js';
+
+// see c/issue.h
+const TAG_NULL = 0;
+const TAG_FALSE = 1;
+const TAG_TRUE = 2;
+const TAG_UINT = 3;
+const TAG_NINT = 4;
+const TAG_DOUBLE = 5;
+const TAG_STRING = 6;
+const TAG_ARRAY = 7;
+const TAG_OBJECT = 8;
+const TAG_END = 9;
+
+const SAFE_SCALE = 0x2000000000000; // 2^49, the first 7 varint bytes fit a double
+
+/**
+ * Decodes one section of a binary issue into the same values returned
+ * by JSONex.parse (integers are unsigned Long objects).
+ * @param {ArrayBuffer} buffer  - Section payload
+ * @param {Array}       strings - String pool of the issue
+ */
+function Decoder(buffer, strings) {
+    this.bytes = new Uint8Array(buffer);
+    this.at = 0;
+    this.strings = strings;
+}
+
+/**
+ * Returns the varint as number, or as BigInt when it needs more than 49 bits.
+ */
+Decoder.prototype.uint = function() {
+    var bytes = this.bytes;
+    var value = 0;
+    var scale = 1;
+    var b;
+    do {
+        b = bytes[this.at++];
+        value += (b & 0x7f) * scale;
+        scale *= 128;
+    } while ((b & 0x80) && scale < SAFE_SCALE);
+    if (!(b & 0x80)) {
+        return value;
+    }
+    var big = BigInt(value);
+    var shift = 49n;
+    do {
+        b = bytes[this.at++];
+        big |= BigInt(b & 0x7f) << shift;
+        shift += 7n;
+    } while (b & 0x80);
+    return big;
+};
+
+Decoder.prototype.double = function() {
+    var view = new DataView(this.bytes.buffer, this.bytes.byteOffset + this.at, 8);
+    this.at += 8;
+    return view.getFloat64(0, true);
+};
+
+Decoder.prototype.value = function() {
+    var tag = this.bytes[this.at++];
+    switch (tag) {
+        case TAG_NULL:
+            return null;
+        case TAG_FALSE:
+            return false;
+        case TAG_TRUE:
+            return true;
+        case TAG_UINT:
+            return Long.from(this.uint(), true);
+        case TAG_NINT:
+            return Long.from(-BigInt(this.uint()), true);
+        case TAG_DOUBLE:
+            return this.double();
+        case TAG_STRING:
+            return this.strings[this.uint()];
+        case TAG_ARRAY:
+            var array = [];
+            while (this.bytes[this.at] != TAG_END) {
+                array.push(this.value());
+            }
+            this.at++;
+            return array;
+        case TAG_OBJECT:
+            var object = {};
+            while (this.bytes[this.at] != TAG_END) {
+                var key = this.strings[this.uint()];
+                object[key] = this.value();
+            }
+            this.at++;
+            return object;
+        default:
+            break;
+    }
+    throw new Error('invalid binary issue tag ' + tag + ' at ' + (this.at - 1));
+};
+
+/**
+ * Wraps the unit of a binary issue; each section is decoded on its first
+ * access and the string pool is built only when the first section is.
+ * @param  {Object} unit - {sections: {name: ArrayBuffer}, strings: function}
+ * @return {Object}      - Issue object, like the JSONex.parse output of the json
+ */
+function open(unit) {
+    var issue = {};
+    var strings = null;
+    Object.keys(unit.sections).forEach(function(name) {
+        var value;
+        var decoded = false;
+        Object.defineProperty(issue, name, {
+            enumerable: true,
+            get: function() {
+                if (!decoded) {
+                    strings = strings || unit.strings();
+                    value = new Decoder(unit.sections[name], strings).value();
+                    decoded = true;
+                }
+                return value;
+            }
+        });
+    });
+    return issue;
+}
+
+export default {
+    open: open
+};
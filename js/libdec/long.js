@@ -42,24 +42,25 @@ function Long(value, isUnsigned) {
 	this.unsigned = isUnsigned;
 	this.value = to64(value, isUnsigned);
 	this.isLong = true;
-	this.toString = function(x) { return this.value.toString(x); };
-	this.add = function(x) { return new Long(this.value + toNum(x, this.unsigned), this.unsigned); };
-	this.sub = function(x) { return new Long(this.value - toNum(x, this.unsigned), this.unsigned); };
-	this.shl = function(x) { return new Long(this.value << toNum(x, this.unsigned), this.unsigned); };
-	this.shru = function(x) { return new Long(this.value >> toNum(x, this.unsigned), this.unsigned); };
-	this.and = function(x) { return new Long(this.value & toNum(x, this.unsigned), this.unsigned); };
-	this.or = function(x) { return new Long(this.value | toNum(x, this.unsigned), this.unsigned); };
-	this.xor = function(x) { return new Long(this.value ^ toNum(x, this.unsigned), this.unsigned); };
-	this.not = function() { return new Long(!this.value, this.unsigned); };
-	this.eq = function(x) { return this.value == toNum(x, this.unsigned); };
-	this.ne = function(x) { return this.value != toNum(x, this.unsigned); };
-	this.lt = function(x) { return this.value < toNum(x, this.unsigned); };
-	this.gt = function(x) { return this.value > toNum(x, this.unsigned); };
-	this.lte = function(x) { return this.value <= toNum(x, this.unsigned); };
-	this.gte = function(x) { return this.value >= toNum(x, this.unsigned); };
-	this.compare = compare;
 }
 
+Long.prototype.toString = function(x) { return this.value.toString(x); };
+Long.prototype.add = function(x) { return new Long(this.value + toNum(x, this.unsigned), this.unsigned); };
+Long.prototype.sub = function(x) { return new Long(this.value - toNum(x, this.unsigned), this.unsigned); };
+Long.prototype.shl = function(x) { return new Long(this.value << toNum(x, this.unsigned), this.unsigned); };
+Long.prototype.shru = function(x) { return new Long(this.value >> toNum(x, this.unsigned), this.unsigned); };
+Long.prototype.and = function(x) { return new Long(this.value & toNum(x, this.unsigned), this.unsigned); };
+Long.prototype.or = function(x) { return new Long(this.value | toNum(x, this.unsigned), this.unsigned); };
+Long.prototype.xor = function(x) { return new Long(this.value ^ toNum(x, this.unsigned), this.unsigned); };
+Long.prototype.not = function() { return new Long(!this.value, this.unsigned); };
+Long.prototype.eq = function(x) { return this.value == toNum(x, this.unsigned); };
+Long.prototype.ne = function(x) { return this.value != toNum(x, this.unsigned); };
+Long.prototype.lt = function(x) { return this.value < toNum(x, this.unsigned); };
+Long.prototype.gt = function(x) { return this.value > toNum(x, this.unsigned); };
+Long.prototype.lte = function(x) { return this.value <= toNum(x, this.unsigned); };
+Long.prototype.gte = function(x) { return this.value >= toNum(x, this.unsigned); };
+Long.prototype.compare = compare;
+
 Long.isLong = function(value) {
 	return value && typeof value == "object" && value.isLong;
 };
@@ -6,6 +6,7 @@ import Long from './long.js';
 import Anno from './annotation.js';
 import ColorsAnsi from './colors/ansi.js';
 import ColorsInvalid from './colors/invalid.js';
+import Shared from './shared.js';
 
 function initializeColors() {
     const config = {};
@@ -38,7 +39,7 @@ const _autotheme = {
     string: /("[^"]+")/,
 };
 
-const defaulttheme = initializeColors();
+var defaulttheme = initializeColors();
 
 /**
  * Color types (ansi, nocolor)
@@ -88,7 +89,7 @@ var _colorize_text = function(input) {
     if (!input || input.length < 1) {
         return '';
     }
-    if (!Global().evars.honor.color) {
+    if (!Shared.evars.honor.color) {
         return input;
     }
     /* control flow (if, else, while, do, etc..) */
@@ -113,34 +114,150 @@ var _colorize_text = function(input) {
     return input;
 };
 
+/**
+ * Theme of a colored window (--window): the colors are kept as markers
+ * around the text and turned into ansi codes only for the emitted slice.
+ */
+var _window_theme = function(theme) {
+    var g = {};
+    Object.keys(theme).forEach(function(key) {
+        g[key] = function(x) {
+            return '\u0001' + key + '\u0002' + x + '\u0003';
+        };
+    });
+    return g;
+};
+
 /**
  * Applies all the colors options (theme/colors).
  */
 var _get_theme = function(evars) {
     if (evars && evars.honor && evars.honor.color) {
-        return Colors.ansi.make(defaulttheme);
+        return evars.extra && evars.extra.window ? _window_theme(defaulttheme) : Colors.ansi.make(defaulttheme);
     }
     return Colors.text.make(defaulttheme);
 };
 
+/**
+ * Keeps only the lines of the requested window (--window); without a first
+ * line, the window is centered on the line of the current offset.
+ * @param  {Array}  lines  - All the lines of the function
+ * @param  {Object} window - Window option ({lines, first})
+ * @return {Object}        - Window position and its lines
+ */
+var _apply_window = function(lines, window) {
+    var first = window.first;
+    if (first === null) {
+        var offset = Shared.evars.extra.offset;
+        var center = 0;
+        for (var i = 0; i < lines.length; i++) {
+            if (lines[i].offset && lines[i].offset.lte(offset)) {
+                center = i;
+                if (lines[i].offset.eq(offset)) {
+                    break;
+                }
+            }
+        }
+        first = Math.max(0, center - Math.floor(window.lines / 2));
+    }
+    first = Math.min(first, Math.max(0, lines.length - window.lines));
+    return {
+        first: first,
+        total: lines.length,
+        lines: lines.slice(first, first + window.lines)
+    };
+};
+
+/**
+ * Turns the color markers of the window lines (see _window_theme) into the
+ * ansi codes of the theme used by pdd, thus only the slice is colorized.
+ * @param  {Array} lines - Lines of the window
+ * @return {Array}       - Colorized lines
+ */
+var _colorize_window = function(lines) {
+    var theme = Colors.ansi.make(defaulttheme);
+    return lines.map(function(x) {
+        var open = [];
+        var str = x.str.replace(/\u0001(\w+)\u0002|\u0003/g, function(marker, key) {
+            if (key) {
+                open.push(key);
+                return theme[key].open;
+            }
+            key = open.pop();
+            return key ? theme[key].close : '';
+        });
+        return { str: str, offset: x.offset };
+    });
+};
+
+/**
+ * Returns the lines in the annotation format (code + annotations) as json.
+ */
+var _format_annotation = function(lines) {
+    var defines = ['function_name', 'function_parameter', 'local_variable', 'constant_variable', 'offset'];
+    var res = {
+        code: "",
+        annotations: []
+    };
+    lines.forEach(function(x) {
+        Anno.auto(x.str, x.offset).forEach(function(a) {
+            if (a.value.length < 1) {
+                return;
+            }
+            var current = res.code.length;
+            res.annotations.push(defines.indexOf(a.type) >= 0 ? a.define(current) : a.syntax(current));
+            res.code += a.value;
+        });
+        res.code += '\n';
+    });
+    return JSONex.stringify(res);
+};
+
+/**
+ * Returns the lines as plain text.
+ */
+var _format_code = function(lines) {
+    return lines.map(function(x) {
+        return x.str + '\n';
+    }).join('');
+};
+
+/**
+ * Writes all the lines with a single native call, when available.
+ * @param {Array} out - Array of strings
+ */
+var _write_output = function(out) {
+    if (out.length < 1) {
+        return;
+    } else if (console.write) {
+        console.write(out);
+        return;
+    }
+    for (var i = 0; i < out.length; i++) {
+        console.log(out[i]);
+    }
+};
+
 /**
  * Prints the final r2dec output
  * @param useJSON - boolean whether to print as json
  */
 var _flush_output = function(lines, errors, log) {
-    if (Global().evars.extra.annotation && lines) {
-        var actx = Anno.context();
-        var res = {
-            code: "",
-            annotations: []
-        };
-        lines.forEach(function(x) {
-            var parsed = Anno.parse(res.code.length, x, actx);
-            res.annotations = res.annotations.concat(parsed);
-            res.code += x.str + '\n';
-        });
-        console.log(JSONex.stringify(res));
-    } else if (Global().evars.extra.json) {
+    var window = null;
+    if (Shared.evars.extra.window && lines) {
+        window = _apply_window(lines, Shared.evars.extra.window);
+        if (Shared.evars.extra.json) {
+            // the offsets of the whole function, to map any line without a new run.
+            window.offsets = lines.map(function(x) {
+                return x.offset || null;
+            });
+        }
+        lines = Shared.evars.honor.color ? _colorize_window(window.lines) : window.lines;
+    }
+    var out = [];
+    if (Shared.evars.extra.annotation && lines) {
+        out.push(_format_annotation(lines));
+    } else if (Shared.evars.extra.json) {
         var jdata = {};
         if (lines && lines.length > 0) {
             jdata.lines = lines;
@@ -151,25 +268,33 @@ var _flush_output = function(lines, errors, log) {
         if (log && log.length > 0) {
             jdata.log = log;
         }
-        console.log(JSONex.stringify(jdata));
+        if (window) {
+            jdata.window = {
+                first: window.first,
+                total: window.total,
+                offsets: window.offsets
+            };
+        }
+        out.push(JSONex.stringify(jdata));
     } else {
-        var prefix = Global().evars.extra.allfunctions ? "// " : "";
+        var prefix = Shared.evars.extra.allfunctions ? "// " : "";
         if (lines && lines.length > 0) {
             for (var i = 0; i < lines.length; i++) {
-                if (Global().evars.extra.highlights && Global().evars.extra.offset.eq(lines[i].offset || Long.ZERO)) {
-                    console.log('\u001b[7m' + lines[i].str + '\u001b[49m\u001b[0m');
+                if (Shared.evars.extra.highlights && Shared.evars.extra.offset.eq(lines[i].offset || Long.ZERO)) {
+                    out.push('\u001b[7m' + lines[i].str + '\u001b[49m\u001b[0m');
                 } else {
-                    console.log(lines[i].str);
+                    out.push(lines[i].str);
                 }
             }
         }
         if (errors && errors.length > 0) {
-            console.log(prefix + errors.join("\n").replace(/\n/g, '\n' + prefix));
+            out.push(prefix + errors.join("\n").replace(/\n/g, '\n' + prefix));
         }
         if (log && log.length > 0) {
-            console.log(prefix + log.join("\n").replace(/\n/g, '\n' + prefix));
+            out.push(prefix + log.join("\n").replace(/\n/g, '\n' + prefix));
         }
     }
+    _write_output(out);
 };
 
 /**
@@ -177,7 +302,16 @@ var _flush_output = function(lines, errors, log) {
  * @return {Function} - Printer object (to be called via `new Printer()`)
  */
 export default function() {
-    this.theme = _get_theme(Global().evars);
+    var evars = Shared.evars;
+    /* the runtime can outlive a run, thus the r2 colors are reloaded */
+    defaulttheme = initializeColors();
+    /* render mode, used as key by the IR render cache (see Base.render) */
+    this.mode = evars && evars.extra && evars.extra.annotation ? 'annotation' : (evars && evars.honor && evars.honor.color ? (evars.extra.window ? 'window' : 'ansi') : 'plain');
+    /* the window lines hold color markers, not ansi codes */
+    this.signature = JSON.stringify(defaulttheme) + this.mode;
+    this.theme = _get_theme(evars);
     this.auto = _colorize_text;
     this.flushOutput = _flush_output;
+    this.formatCode = _format_code;
+    this.formatAnnotation = _format_annotation;
 }
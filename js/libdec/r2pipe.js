@@ -51,6 +51,54 @@ function r2bool(value) {
 	return x == 'true' || x == '1';
 }
 
+function r2bytes(address, size) {
+	if (!radare2 || !radare2.read || !address) {
+		return null;
+	}
+	try {
+		var buffer = radare2.read('0x' + address.toString(16), size);
+		return buffer ? new Uint8Array(buffer) : null;
+	} catch (e) {}
+	return null;
+}
+
+function r2load(view, offset, size, big_endian) {
+	switch (size) {
+		case 1:
+			return Long.from(view.getUint8(offset), true);
+		case 2:
+			return Long.from(view.getUint16(offset, !big_endian), true);
+		case 4:
+			return Long.from(view.getUint32(offset, !big_endian), true);
+		case 8:
+			return Long.from(view.getBigUint64(offset, !big_endian), true);
+		default:
+			throw new Error('unsupported load size ' + size);
+	}
+}
+
+/**
+ * Reads `count` unsigned values of `size` bytes (1, 2, 4 or 8) with a single
+ * memory read (i.e. jump tables); returns an array of Long or null.
+ */
+function r2read_array(address, count, size, big_endian) {
+	var bytes = r2bytes(address, count * size);
+	if (!bytes) {
+		return null;
+	}
+	var view = new DataView(bytes.buffer);
+	var values = new Array(count);
+	for (var i = 0; i < count; i++) {
+		values[i] = r2load(view, i * size, size, big_endian);
+	}
+	return values;
+}
+
+function r2read(address, size, big_endian) {
+	var values = r2read_array(address, 1, size, big_endian);
+	return values ? values[0] : null;
+}
+
 export default {
 	custom: r2custom,
 	string: r2str,
@@ -58,4 +106,28 @@ export default {
 	int: r2int,
 	long: r2long,
 	bool: r2bool,
+	bytes: r2bytes,
+	read: r2read,
+	readArray: r2read_array,
+	u8: function(address) {
+		return r2read(address, 1, false);
+	},
+	u16le: function(address) {
+		return r2read(address, 2, false);
+	},
+	u16be: function(address) {
+		return r2read(address, 2, true);
+	},
+	u32le: function(address) {
+		return r2read(address, 4, false);
+	},
+	u32be: function(address) {
+		return r2read(address, 4, true);
+	},
+	u64le: function(address) {
+		return r2read(address, 8, false);
+	},
+	u64be: function(address) {
+		return r2read(address, 8, true);
+	},
 };
@@ -8,11 +8,13 @@ import Long from './long.js';
 
 export default (function() {
 	var __line_cnt = 0;
+	// global tables do not change during a run, thus pddf fetches them once.
+	var __tables = {};
 
-    function r2_arch() {
-        var arch = r2pipe.string('e asm.arch');
+    function r2_arch(cfg) {
+        var arch = cfg['asm.arch'];
         if (arch === 'r2ghidra') {
-            arch = r2pipe.string('e asm.cpu');
+            arch = cfg['asm.cpu'];
             const colon = arch.indexOf(':');
             if (colon !== -1) {
                 arch = arch.substring(0, colon);
@@ -21,8 +23,26 @@ export default (function() {
         return r2_sanitize(arch);
     }
 
+    /**
+     * Reads all the requested r2 config variables with one native call.
+     * @param  {Array} names - List of variable names
+     * @return {Object}      - Map of name to (string) value
+     */
+    function r2_config(names) {
+        return radare2.config.get(names);
+    }
+
+    function config_bool(value) {
+        return value == 'true' || value == '1';
+    }
+
+    function config_int(value, def) {
+        var x = parseInt(value);
+        return isNaN(x) ? (def || 0) : x;
+    }
+
     function aflj() {
-        const functions = r2pipe.json('aflj', []);
+        const functions = table_json('aflj', []);
         console.log(functions);
         if (functions.length > 0 && functions[0].addr) {
             return functions.map((x) => {
@@ -33,16 +53,67 @@ export default (function() {
         return functions;
     }
 
-    function r2_sanitize(value, expected) {
-        return value.length == 0 ? expected : value;
+    /**
+     * Converts all the BigInt values returned by the native bindings
+     * into Long objects, like JSONex.parse does with JSON integers.
+     * @param  {Object} value - Any value
+     * @return {Object}       - Same value with Long objects
+     */
+    function bigint_to_long(value) {
+        if (typeof value == 'bigint') {
+            return Long.from(value, true);
+        } else if (Array.isArray(value)) {
+            for (var i = 0; i < value.length; i++) {
+                value[i] = bigint_to_long(value[i]);
+            }
+        } else if (value && typeof value == 'object') {
+            for (var key in value) {
+                value[key] = bigint_to_long(value[key]);
+            }
+        }
+        return value;
     }
 
-    function r2dec_sanitize(enable, evar, oldstatus, newstatus) {
-        if (enable) {
-            radare2.command('e ' + evar + '=' + newstatus);
-        } else {
-            radare2.command('e ' + evar + '=' + oldstatus);
+    function table(name) {
+        if (!(name in __tables)) {
+            __tables[name] = radare2.command(name) || "";
         }
+        return __tables[name].trim();
+    }
+
+    function table_json(name, def) {
+        var x = table(name).replace(/\n/g, '');
+        try {
+            return x.length > 0 ? JSONex.parse(x) : def;
+        } catch (e) {}
+        return def;
+    }
+
+    function function_vars() {
+        var def = {
+            "sp": [],
+            "bp": [],
+            "reg": []
+        };
+        if (!radare2.functionVars) {
+            return r2pipe.json('afvj', def);
+        }
+        var x = radare2.functionVars().replace(/\n/g, '').trim();
+        try {
+            return x.length > 0 ? JSONex.parse(x) : def;
+        } catch (e) {}
+        return def;
+    }
+
+    function function_graph() {
+        if (radare2.functionGraph) {
+            return bigint_to_long(radare2.functionGraph());
+        }
+        return r2pipe.json('agj', []);
+    }
+
+    function r2_sanitize(value, expected) {
+        return value.length == 0 ? expected : value;
     }
 
     function merge_arrays(input) {
@@ -103,6 +174,7 @@ export default (function() {
         "--colors": "enables syntax colors",
         "--debug": "do not catch exceptions",
         "--issue": "generates the json used for the test suite",
+        "--issue-binary": "<file> writes the issue data into file as binary (see r2dec-standalone)",
         "--offsets": "shows pseudo next to the assembly offset",
         "--paddr": "all xrefs uses physical addresses instead of virtual addresses",
         "--xrefs": "shows also instruction xrefs in the pseudo code",
@@ -110,20 +182,117 @@ export default (function() {
         "--as-comment": "the decompiled code is returned to r2 as comment (via CCu)",
         "--as-code-line": "the decompiled code is returned to r2 as 'file:line code' (via CL)",
         "--as-json": "the decompiled code lines are returned as JSON",
-        "--annotation": "the decompiled code lines are returned with the annotation format"
+        "--annotation": "the decompiled code lines are returned with the annotation format",
+        "--window": "[lines] [first] shows only the given lines (centered on the current offset when first is missing)",
+        "--shard": "<index>/<count> with --all-functions decompiles only one shard of the functions",
+        "--range": "<from> <to> with --all-functions decompiles only the functions within the address range",
+        "--functions": "<file> with --all-functions decompiles only the functions listed (name or address per line)",
+        "--export": "<dir> with --all-functions writes one file per function and an index (r2dec.idx) into dir",
+        "--export-annotation": "with --export writes also the annotation json of each function"
+	};
+
+	// options followed by values and how many values they take.
+	var valued = {
+		"--shard": 1,
+		"--range": 2,
+		"--functions": 1,
+		"--export": 1,
+		"--issue-binary": 1
 	};
 
 	function has_option(args, name) {
 		return (args.indexOf(name) >= 0);
 	}
 
+	function is_window_value(args, i) {
+		var w = args.indexOf('--window');
+		return w >= 0 && i > w && i <= w + 2 && /^\d+$/.test(args[i]);
+	}
+
+	function window_option(args) {
+		var w = args.indexOf('--window');
+		if (w < 0) {
+			return null;
+		}
+		var lines = is_window_value(args, w + 1) ? parseInt(args[w + 1]) : 50;
+		var first = is_window_value(args, w + 2) ? parseInt(args[w + 2]) : null;
+		return {
+			lines: lines > 0 ? lines : 50,
+			first: first
+		};
+	}
+
+	function option_values(args, name) {
+		var k = args.indexOf(name);
+		if (k < 0) {
+			return null;
+		}
+		var values = args.slice(k + 1, k + 1 + valued[name]);
+		return values.length == valued[name] ? values : null;
+	}
+
+	function is_option_value(args, i) {
+		for (var name in valued) {
+			var k = args.indexOf(name);
+			if (k >= 0 && i > k && i <= k + valued[name]) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	function shard_option(args) {
+		var values = option_values(args, '--shard');
+		if (values) {
+			var m = values[0].match(/^(\d+)\/(\d+)$/);
+			var index = m ? parseInt(m[1]) : -1;
+			var count = m ? parseInt(m[2]) : 0;
+			if (index < 0 || index >= count) {
+				return null;
+			}
+			return {
+				index: index,
+				count: count
+			};
+		}
+		values = option_values(args, '--range');
+		if (values) {
+			if (!/^(0x[0-9a-fA-F]+|\d+)$/.test(values[0]) || !/^(0x[0-9a-fA-F]+|\d+)$/.test(values[1])) {
+				return null;
+			}
+			var from = Long.from(values[0], true);
+			var to = Long.from(values[1], true);
+			if (from.gt(to)) {
+				return null;
+			}
+			return {
+				from: from,
+				to: to
+			};
+		}
+		values = option_values(args, '--functions');
+		if (values) {
+			return {
+				file: values[0]
+			};
+		}
+		return null;
+	}
+
 	function has_invalid_args(args) {
 		for (var i = 0; i < args.length; i++) {
-			if (args[i] != '' && !usages[args[i]]) {
+			if (args[i] != '' && !usages[args[i]] && !is_window_value(args, i) && !is_option_value(args, i)) {
 				console.log('Invalid argument \'' + args[i] + '\'\n');
 				return true;
 			}
 		}
+		for (var name in valued) {
+			var shard = ['--shard', '--range', '--functions'].indexOf(name) >= 0;
+			if (has_option(args, name) && (!option_values(args, name) || (shard && !shard_option(args)))) {
+				console.log('Invalid value for \'' + name + '\'\n');
+				return true;
+			}
+		}
 		return false;
 	}
 
@@ -159,6 +328,30 @@ export default (function() {
 			',"aflj":' + functions + '}');
 	}
 
+	/**
+	 * Same data of print_issue, but each table is encoded natively into
+	 * the binary issue without passing through javascript.
+	 */
+	function write_issue(file) {
+		if (!radare2 || !radare2.issueOpen || !radare2.issueOpen(file)) {
+			console.log('cannot create ' + file);
+			return;
+		}
+		radare2.issueWrite('name', null, 'string', 'issue_' + (new Date()).getTime());
+		radare2.issueWrite('version', null, 'string', radare2.version);
+		radare2.issueWrite('arch', 'e asm.arch', 'string', '');
+		radare2.issueWrite('archbits', 'e asm.bits', 'json', '32');
+		radare2.issueWrite('graph', 'agj', 'json', '[]');
+		radare2.issueWrite('isj', 'isj', 'json', '[]');
+		radare2.issueWrite('Csj', 'Csj', 'json', '[]');
+		radare2.issueWrite('icj', 'icj', 'json', '[]');
+		radare2.issueWrite('afvj', 'afvj', 'json', '{"sp":[],"bp":[],"reg":[]}');
+		radare2.issueWrite('afcfj', 'afsj @@i', 'merge', '[]');
+		radare2.issueWrite('aflj', 'aflj', 'json', '[]');
+		var bytes = radare2.issueClose();
+		console.log(bytes === null ? 'failed to write ' + file : file + ' (' + bytes + ' bytes)');
+	}
+
 	function print_archs() {
 		var archs = Object.keys(libdec.archs);
 		archs.sort();
@@ -178,6 +371,10 @@ export default (function() {
 				print_issue();
 				return true;
 			}
+			if (has_option(args, '--issue-binary')) {
+				write_issue(option_values(args, '--issue-binary')[0]);
+				return true;
+			}
 			if (has_option(args, '--architectures')) {
 				print_archs();
 				return true;
@@ -185,52 +382,85 @@ export default (function() {
 			return false;
 		},
 		evars: function(args) {
+			const e = r2_config([
+				'asm.arch', 'asm.bits', 'asm.ucase', 'asm.pseudo', 'asm.capitalize', 'asm.syntax',
+				'scr.color', 'scr.html', 'file.path',
+				'r2dec.casts', 'r2dec.asm', 'r2dec.blocks', 'r2dec.vars', 'r2dec.xrefs', 'r2dec.paddr',
+				'r2dec.debug', 'r2dec.highlight', 'r2dec.slow', 'r2dec.cache', 'r2dec.timing',
+				'r2dec.dedup', 'r2dec.dedup.compact',
+			]);
+			// the runtime is kept alive between runs, thus CL lines restart here.
+			__line_cnt = 0;
+			__tables = {};
 			let o = {};
 			o.version = radare2 ? radare2.version : "";
-			o.arch = r2pipe.string('e asm.arch');
-			o.archbits = r2pipe.int('e asm.bits', 32);
+			o.arch = e['asm.arch'];
+			o.archbits = config_int(e['asm.bits'], 32);
 			o.honor = {
-                casts: r2pipe.bool('e r2dec.casts') || has_option(args, '--casts'),
-                assembly: r2pipe.bool('e r2dec.asm') || has_option(args, '--assembly'),
-                blocks: r2pipe.bool('e r2dec.blocks') || has_option(args, '--blocks'),
-                vars: r2pipe.bool('e r2dec.vars'),
-                xrefs: r2pipe.bool('e r2dec.xrefs') || has_option(args, '--xrefs'),
-                paddr: r2pipe.bool('e r2dec.paddr') || has_option(args, '--paddr'),
+                casts: config_bool(e['r2dec.casts']) || has_option(args, '--casts'),
+                assembly: config_bool(e['r2dec.asm']) || has_option(args, '--assembly'),
+                blocks: config_bool(e['r2dec.blocks']) || has_option(args, '--blocks'),
+                vars: config_bool(e['r2dec.vars']),
+                xrefs: config_bool(e['r2dec.xrefs']) || has_option(args, '--xrefs'),
+                paddr: config_bool(e['r2dec.paddr']) || has_option(args, '--paddr'),
                 offsets: has_option(args, '--offsets'),
-                color: r2pipe.int('e scr.color', 0) > 0 || has_option(args, '--colors')
+                color: config_int(e['scr.color'], 0) > 0 || has_option(args, '--colors')
 			};
 			o.sanitize = {
-                ucase: r2pipe.bool('e asm.ucase'),
-                pseudo: r2pipe.bool('e asm.pseudo'),
-                capitalize: r2pipe.bool('e asm.capitalize'),
-                html: r2pipe.bool('e scr.html'),
-                syntax: r2pipe.string('e asm.syntax'),
+                ucase: config_bool(e['asm.ucase']),
+                pseudo: config_bool(e['asm.pseudo']),
+                capitalize: config_bool(e['asm.capitalize']),
+                html: config_bool(e['scr.html']),
+                syntax: e['asm.syntax'],
 			};
 			o.extra = {
                 allfunctions: has_option(args, '--all-functions'),
                 ascodeline: has_option(args, '--as-code-line'),
                 ascomment: has_option(args, '--as-comment'),
-                debug: r2pipe.bool('e r2dec.debug') || has_option(args, '--debug'),
-                file: r2pipe.string('i~^file[1:0]'),
-                highlights: r2pipe.bool('e r2dec.highlight') || has_option(args, '--highlight-current'),
+                debug: config_bool(e['r2dec.debug']) || has_option(args, '--debug'),
+                file: e['file.path'] || r2pipe.string('i~^file[1:0]'),
+                highlights: config_bool(e['r2dec.highlight']) || has_option(args, '--highlight-current'),
                 json: has_option(args, '--as-json'),
                 offset: r2pipe.long('s'),
-                slow: r2pipe.bool('e r2dec.slow'),
+                slow: config_bool(e['r2dec.slow']),
                 annotation: has_option(args, '--annotation'),
+                window: window_option(args),
+                shard: shard_option(args),
+                export: (option_values(args, '--export') || [null])[0],
+                export_annotation: has_option(args, '--export-annotation'),
+                cache: e['r2dec.cache'] === undefined || e['r2dec.cache'] === '' || config_bool(e['r2dec.cache']),
+                timing: config_bool(e['r2dec.timing']),
+                dedup: config_bool(e['r2dec.dedup']),
+                dedup_compact: config_bool(e['r2dec.dedup.compact']),
+			};
+			// comments and code lines are collected and then applied
+			// natively in one call (see apply_metadata).
+			o.metadata = {
+				comments: [],
+				codelines: []
 			};
 			o.add_comment = function(comment, offset) {
 				if (!comment || comment.length < 1) {
 					return;
 				}
-				radare2.command('CC- @ 0x' + offset.toString(16));
-				radare2.command('CCu base64:' + btoa(comment) + ' @ 0x' + offset.toString(16));
+				o.metadata.comments.push(['0x' + offset.toString(16), comment]);
 			};
 			o.add_code_line = function(comment, offset) {
 				if (comment.trim().length < 1) {
 					return;
 				}
 				var line = __line_cnt++;
-				radare2.command('"CL 0x' + offset.toString(16) + ' r2dec.c:' + line + ' ' + comment.replace(/\n/g, '; ').replace(/\\/g, '\\\\').replace(/"/g, '\\"') + ';"');
+				o.metadata.codelines.push(['0x' + offset.toString(16), 'r2dec.c:' + line + ' ' + comment.replace(/\n/g, '; ') + ';']);
+			};
+			o.apply_metadata = function() {
+				if (o.metadata.comments.length > 0) {
+					radare2.comments(o.metadata.comments);
+					o.metadata.comments = [];
+				}
+				if (o.metadata.codelines.length > 0) {
+					radare2.codelines(o.metadata.codelines);
+					o.metadata.codelines = [];
+				}
 			};
 
 			if (o.extra.ascomment || o.extra.ascodeline) {
@@ -243,7 +473,13 @@ export default (function() {
 				o.extra.annotation = false;
 			}
 
+			if (o.extra.ascomment || o.extra.ascodeline) {
+				o.extra.window = null;
+			}
+
 			if (o.extra.allfunctions) {
+				o.extra.window = null;
+				o.extra.cache = false;
 				o.extra.ascomment = false;
 				o.extra.ascodeline = false;
 				o.honor.assembly = false;
@@ -254,6 +490,14 @@ export default (function() {
 				o.extra.annotation = false;
 			}
 
+			if (!o.extra.allfunctions) {
+				o.extra.shard = null;
+				o.extra.export = null;
+			} else if (o.extra.shard || o.extra.export) {
+				// shard outputs and exported functions are files.
+				o.honor.color = false;
+			}
+
 			if (o.extra.annotation) {
 				o.extra.ascodeline = false;
 				o.extra.ascomment = false;
@@ -272,35 +516,38 @@ export default (function() {
 			return o;
 		},
 		data: function() {
-            var isfast = !r2pipe.bool('e r2dec.slow');
-            this.arch = r2_arch();
-            this.bits = r2pipe.int('e asm.bits', 32);
+            const e = r2_config(['asm.arch', 'asm.cpu', 'asm.bits', 'r2dec.slow']);
+            var isfast = !config_bool(e['r2dec.slow']);
+            this.arch = r2_arch(e);
+            this.bits = config_int(e['asm.bits'], 32);
             this.xrefs = {
-                symbols: (isfast ? [] : r2pipe.json('isj', [])),
-                strings: (isfast ? [] : r2pipe.json('Csj', [])),
+                symbols: (isfast ? [] : table_json('isj', [])),
+                strings: (isfast ? [] : table_json('Csj', [])),
                 functions: (isfast ? [] : aflj()),
-                classes: r2pipe.json('icj', []),
-                arguments: offset_long(r2pipe.json('afvj', {
-                    "sp": [],
-                    "bp": [],
-                    "reg": []
-                }))
+                classes: table_json('icj', []),
+                arguments: offset_long(function_vars())
             };
-            this.graph = r2pipe.json('agj', []);
-            this.argdb = r2pipe.custom('afcfj @@@i', merge_arrays);
+            this.graph = function_graph();
+            this.argdb = merge_arrays(table('afcfj @@@i'));
 		},
 		sanitize: function(enable, evars) {
 			if (!evars) {
 				return;
+			} else if (!enable) {
+				// restores the values saved by the push below.
+				radare2.config.pop();
+				return;
 			}
-            var s = evars.sanitize;
-            r2dec_sanitize(enable, 'asm.ucase', s.ucase, 'false');
-            r2dec_sanitize(enable, 'asm.pseudo', s.pseudo, 'false');
-            r2dec_sanitize(enable, 'asm.capitalize', s.capitalize, 'false');
-            r2dec_sanitize(enable, 'scr.html', s.html, 'false');
+            var overrides = [
+                ['asm.ucase', 'false'],
+                ['asm.pseudo', 'false'],
+                ['asm.capitalize', 'false'],
+                ['scr.html', 'false'],
+            ];
             if (evars.arch == 'x86') {
-                r2dec_sanitize(enable, 'asm.syntax', s.syntax, 'intel');
+                overrides.push(['asm.syntax', 'intel']);
             }
+            radare2.config.push(overrides);
 		},
 		debug: function(evars, exception) {
             r2util.sanitize(false, evars);
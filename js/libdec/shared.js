@@ -0,0 +1,13 @@
+// SPDX-FileCopyrightText: 2017-2023 Giovanni Dante Grazioli <deroad@libero.it>
+// SPDX-License-Identifier: BSD-3-Clause
+
+/**
+ * Shared data accessible from everywhere (evars, context, printer, argdb, xrefs).
+ *
+ * This is the object returned by the native Global(), fetched once when
+ * the module is loaded instead of with a native call on each access; the
+ * host keeps it for the whole life of the runtime and the main module
+ * resets its fields on every run.
+ * @type {Object}
+ */
+export default Global();
@@ -3,6 +3,7 @@
 
 import Long from './long.js';
 import JSONex from './JSONex.js';
+import IssueBin from './issuebin.js';
 
 function _new_evars(issue) {
     let evars = {};
@@ -64,7 +65,8 @@ function _new_data(issue) {
 }
 
 export default function(filename) {
-    const issue = JSONex.parse(unit.raw);
+    // unit.sections is set when the issue is binary (pddi <file>).
+    const issue = unit.sections ? IssueBin.open(unit) : JSONex.parse(unit.raw);
     this.data = _new_data(issue);
     this.evars = _new_evars(this.data);
 }
\ No newline at end of file
@@ -8,31 +8,477 @@ import r2util from './libdec/r2util.js';
 import r2pipe from './libdec/r2pipe.js';
 import Warning from './libdec/warning.js';
 import Printer from './libdec/printer.js';
+import Variable from './libdec/core/variable.js';
+import CCalls from './libdec/db/c_calls.js';
+import Extra from './libdec/core/extra.js';
+import Long from './libdec/long.js';
+import Shared from './libdec/shared.js';
 
-/**
- * Shared data accessible from everywhere.
- * @type {Object}
- */
-var Shared = Global();
 Shared.evars = null;
 Shared.context = null;
 Shared.printer = null;
 Shared.argdb = null;
 Shared.xrefs = null;
 Shared.warning = Warning;
+Shared.timing = null;
+Shared.profile = null;
+
+/**
+ * Time spent in each phase of the current run (r2dec.timing).
+ */
+var Timing = function() {
+	this.start = Date.now();
+	this.last = this.start;
+	this.phases = [];
+	this.cache = 'off';
+	this.mark = function(name) {
+		var now = Date.now();
+		this.phases.push(name + ' ' + (now - this.last) + 'ms');
+		this.last = now;
+	};
+	this.toString = function() {
+		return 'r2dec timing: ' + this.phases.join(', ') + ', total ' + (Date.now() - this.start) + 'ms (cache ' + this.cache + ')';
+	};
+};
+
+/**
+ * Heap traffic of each phase (r2dec.profile); r2dec.phase and r2dec.profile
+ * exist only when the runtime counts the allocations, otherwise phase is a no-op.
+ * The counters are reset at each snapshot and summed into the run totals; the
+ * final output flush is not part of the report, since it prints it.
+ */
+var Profile = function() {
+	this.enabled = typeof r2dec.profile === 'function';
+	this.phase = this.enabled ? r2dec.phase : function() {};
+	if (this.enabled) {
+		// drops what the previous run did after its report.
+		r2dec.profile(true);
+	}
+	this.total = { peak: 0, phases: {} };
+	this.functions = [];
+	this.snapshot = function() {
+		var report = r2dec.profile(true);
+		var total = this.total;
+		total.peak = Math.max(total.peak, report.peak);
+		for (var name in report.phases) {
+			var phase = report.phases[name];
+			var sum = total.phases[name];
+			if (!sum) {
+				total.phases[name] = Object.assign({}, phase);
+				continue;
+			}
+			sum.allocs += phase.allocs;
+			sum.frees += phase.frees;
+			sum.bytes += phase.bytes;
+			sum.freed += phase.freed;
+			sum.peak = Math.max(sum.peak, phase.peak);
+		}
+		return report;
+	};
+	this.function = function(name, address) {
+		if (!this.enabled) {
+			return;
+		}
+		var report = this.snapshot();
+		this.functions.push({
+			name: name,
+			address: '0x' + address.toString(16),
+			peak: report.peak,
+			phases: report.phases
+		});
+	};
+	this.toString = function() {
+		this.snapshot();
+		return JSON.stringify({
+			r2dec_profile: {
+				peak: this.total.peak,
+				phases: this.total.phases,
+				functions: this.functions
+			}
+		});
+	};
+};
+
+/**
+ * Post-analysis sessions of the recently decompiled functions; switching
+ * view (pdd, pdda, pddo, pddb, pddj, pddA, pdd*, pddc) or moving the
+ * highlight only prints them again.
+ */
+var SessionCache = {
+	max: 8,
+	entries: [],
+	get: function(key) {
+		for (var i = 0; i < this.entries.length; i++) {
+			if (this.entries[i].key == key) {
+				var entry = this.entries.splice(i, 1)[0];
+				this.entries.unshift(entry);
+				return entry;
+			}
+		}
+		return null;
+	},
+	add: function(entry) {
+		this.entries.unshift(entry);
+		if (this.entries.length > this.max) {
+			this.entries.pop();
+		}
+	},
+};
+
+/**
+ * pddf with r2dec.dedup: functions whose instruction stream, comments,
+ * variables and signature are identical once rebased to the entry (see
+ * radare2.bodyHash) are decompiled only once, the
+ * hash finds the candidate and the rebased bodies must be equal; the
+ * other copies are rebased from the first one or, with r2dec.dedup.compact,
+ * printed as a reference to it.
+ */
+var Dedup = function(compact) {
+	this.compact = compact;
+	this.classes = {};
+	this.functions = 0;
+	this.copies = 0;
+	this.saved = 0;
+	this.pending = null;
+
+	/**
+	 * Returns true when the function at the current seek is a copy of an
+	 * already decompiled one and its body has been emitted.
+	 */
+	this.emit = function(fcn, addr) {
+		this.functions++;
+		this.pending = null;
+		var body = radare2.bodyHash ? radare2.bodyHash('0x' + addr.toString(16)) : null;
+		if (!body || !body.body) {
+			return false;
+		}
+		var rep = this.classes[body.hash];
+		if (!rep) {
+			this.pending = {
+				name: fcn.name,
+				addr: addr,
+				size: body.size,
+				body: body.body,
+				start: Shared.context.lines.length,
+				lines: null,
+			};
+			this.classes[body.hash] = this.pending;
+			return false;
+		} else if (rep.body !== body.body) {
+			// same hash, different body: decompiled on its own.
+			return false;
+		}
+		this.copies++;
+		this.saved += body.ninstr;
+		if (this.compact || !rep.lines) {
+			Shared.context.printLine(Shared.printer.theme.comment('/* identical to ' + rep.name + ' @ 0x' + rep.addr.toString(16) + ' */'), addr);
+			return true;
+		}
+		var names = [
+			[rep.name, fcn.name],
+			[Extra.replace.call(rep.name), Extra.replace.call(fcn.name)]
+		].map(function(pair) {
+			var escaped = pair[0].replace(/[.*+?^${}()|[\]\\]/g, '\\$&');
+			return [new RegExp('(^|[^\\w.])' + escaped + '(?![\\w.])', 'g'), '$1' + pair[1].replace(/\$/g, '$$$$')];
+		});
+		var from = BigInt(rep.addr.toString());
+		var to = BigInt(addr.toString());
+		var end = from + BigInt(rep.size);
+		var rebase = function(value) {
+			return Long.isLong(value) ? value.sub(from).add(to) : value;
+		};
+		var relocate = function(match) {
+			var value = BigInt(match);
+			if (value < from || value >= end) {
+				return match;
+			}
+			return '0x' + (value - from + to).toString(16);
+		};
+		rep.lines.forEach(function(line) {
+			var str = line.str;
+			names.forEach(function(pair) {
+				str = str.replace(pair[0], pair[1]);
+			});
+			str = str.replace(/0x[0-9a-fA-F]+/g, relocate);
+			Shared.context.printLine(str, rebase(line.offset));
+		});
+		return true;
+	};
+
+	/**
+	 * Stores the lines of the representative that has just been decompiled.
+	 */
+	this.add = function() {
+		if (this.pending) {
+			this.pending.lines = Shared.context.lines.slice(this.pending.start);
+			this.pending = null;
+		}
+	};
+
+	this.toString = function() {
+		return 'r2dec dedup: ' + this.functions + ' functions, ' +
+			(this.functions - this.copies) + ' decompiled, ' + this.copies +
+			' identical copies, ' + this.saved + ' instructions not decompiled';
+	};
+};
+
+/**
+ * pddf --shard/--range/--functions: selects a deterministic subset of aflj.
+ * Shards are balanced by size (longest processing time first: the biggest
+ * function goes to the least loaded shard) and the output is wrapped into
+ * markers, thus `r2dec-standalone --merge` can combine the shards in address order.
+ */
+var Shard = {
+	header: '/* r2dec:header */',
+	end: '/* r2dec:end */',
+	marker: function(shard) {
+		if (shard.count) {
+			return '/* r2dec:shard ' + shard.index + '/' + shard.count + ' */';
+		} else if (shard.file) {
+			return '/* r2dec:shard ' + shard.file + ' */';
+		}
+		return '/* r2dec:shard 0x' + shard.from.toString(16) + '-0x' + shard.to.toString(16) + ' */';
+	},
+	function: function(addr) {
+		return '/* r2dec:function 0x' + addr.toString(16) + ' */';
+	},
+	partition: function(functions, shard) {
+		var sorted = functions.slice().sort(function(a, b) {
+			return b.size.compare(a.size) || a.addr.compare(b.addr);
+		});
+		var loads = new Array(shard.count).fill(0n);
+		return sorted.filter(function(x) {
+			var target = 0;
+			for (var i = 1; i < loads.length; i++) {
+				if (loads[i] < loads[target]) {
+					target = i;
+				}
+			}
+			loads[target] += x.size.value;
+			return target == shard.index;
+		});
+	},
+	select: function(functions, shard) {
+		functions = functions.map(function(x) {
+			var addr = Long.from(x.offset || x.addr, true);
+			return {
+				fcn: x,
+				addr: addr,
+				size: Long.from(x.size || 1, true),
+			};
+		});
+		if (shard.count) {
+			functions = Shard.partition(functions, shard);
+		} else if (shard.file) {
+			var list = (radare2.readFile(shard.file) || '').split('\n').map(function(x) {
+				return x.trim();
+			}).filter(function(x) {
+				return x.length > 0;
+			});
+			functions = functions.filter(function(x) {
+				return list.indexOf(x.fcn.name) >= 0 || list.some(function(y) {
+					return /^(0x)?[0-9a-fA-F]+$/.test(y) && x.addr.eq(Long.from(y.startsWith('0x') ? y : '0x' + y, true));
+				});
+			});
+		} else {
+			functions = functions.filter(function(x) {
+				return x.addr.gte(shard.from) && x.addr.lt(shard.to);
+			});
+		}
+		functions.sort(function(a, b) {
+			return a.addr.compare(b.addr);
+		});
+		return functions.map(function(x) {
+			return x.fcn;
+		});
+	},
+};
+
+/**
+ * pddf --export: each function is written into its own file (plus the
+ * annotation json with --export-annotation) by the native writer thread,
+ * which also builds the index (see radare2.exportOpen).
+ */
+var Export = function(dir, annotation) {
+	this.dir = dir;
+	this.annotation = annotation;
+	this.files = {};
+	this.functions = 0;
+
+	this.open = function() {
+		return radare2.exportOpen && radare2.exportOpen(this.dir);
+	};
+
+	this.filename = function(name, addr) {
+		var file = name.replace(/[^\w.-]/g, '_');
+		if (this.files[file]) {
+			file += '_' + addr.toString(16);
+		}
+		this.files[file] = true;
+		return file;
+	};
+
+	this.write = function(fcn, addr, context) {
+		var file = this.filename(fcn.name, addr);
+		var lines = header_lines(context, addr).concat(context.lines);
+		radare2.exportWrite(file + '.c', Shared.printer.formatCode(lines), fcn.name, '0x' + addr.toString(16), '0x' + (fcn.size || 0).toString(16));
+		if (this.annotation) {
+			radare2.exportWrite(file + '.json', Shared.printer.formatAnnotation(lines));
+		}
+		this.functions++;
+	};
+
+	this.close = function() {
+		var stats = radare2.exportClose();
+		if (!stats) {
+			return 'r2dec export: nothing written';
+		}
+		var failed = stats.failed > 0 ? ', ' + stats.failed + ' failed writes' : '';
+		return 'r2dec export: ' + this.functions + ' functions, ' + stats.files + ' files (' + stats.bytes + ' bytes) written to ' + this.dir + failed;
+	};
+};
+
+function header_comments() {
+	var r2version = '';
+	if (Shared.evars.version) {
+	    r2version = ' (r2 ' + Shared.evars.version + ')';
+	}
+	return [
+		Shared.printer.theme.comment('/* r2dec pseudo code output' + r2version + ' */'),
+		Shared.printer.theme.comment('/* ' + Shared.evars.extra.file + ' */')
+	];
+}
+
+/**
+ * The header of pddf: r2dec/file comments plus the macros and dependencies
+ * collected by the given context.
+ */
+function header_lines(context, offset) {
+	var o = Shared.context;
+	Shared.context = new libdec.context();
+	Shared.context.macros = context.macros;
+	Shared.context.dependencies = context.dependencies;
+	header_comments().forEach(function(comment) {
+		Shared.context.printLine(comment, offset);
+	});
+	if (['java', 'dalvik'].indexOf(Shared.evars.arch) < 0) {
+		Shared.context.printMacros(true);
+		Shared.context.printDependencies(true);
+	}
+	var lines = Shared.context.lines;
+	Shared.context = o;
+	return lines;
+}
+
+/**
+ * The header of a pddf shard: same content of header_lines, but each comment,
+ * macro and dependency is a block ended by an empty line, thus
+ * `r2dec-standalone --merge` can drop the blocks repeated by the shards.
+ */
+function shard_header_lines(context, offset) {
+	var o = Shared.context;
+	var lines = [];
+	var block = function(print) {
+		Shared.context = new libdec.context();
+		print();
+		if (Shared.context.lines.length > 0) {
+			lines = lines.concat(Shared.context.lines, [{ str: '', offset: offset }]);
+		}
+	};
+	header_comments().forEach(function(comment) {
+		block(function() {
+			Shared.context.printLine(comment, offset);
+		});
+	});
+	if (['java', 'dalvik'].indexOf(Shared.evars.arch) < 0) {
+		context.macros.forEach(function(macro) {
+			block(function() {
+				Shared.context.printLine(Shared.context.identfy() + Shared.printer.theme.macro(macro), offset);
+			});
+		});
+		context.dependencies.forEach(function(x) {
+			block(function() {
+				x.print(offset);
+			});
+		});
+	}
+	Shared.context = o;
+	return lines;
+}
+
+/**
+ * The key is made of the function fingerprint (graph, variables and
+ * signature, see radare2.fingerprint) plus the evars that change the IR;
+ * colors are part of it because strings are colorized when the IR is built.
+ */
+function session_key() {
+	if (!Shared.evars.extra.cache || !radare2.fingerprint) {
+		return null;
+	}
+	var fingerprint = radare2.fingerprint();
+	if (!fingerprint) {
+		return null;
+	}
+	var e = Shared.evars;
+	return [
+		fingerprint, e.arch, e.archbits,
+		e.honor.casts, e.honor.vars, e.honor.xrefs, e.honor.paddr, e.honor.color,
+		e.extra.slow, e.honor.color ? Shared.printer.signature : ''
+	].join('|');
+}
+
+function print_cached(entry) {
+	Shared.argdb = entry.argdb;
+	Shared.xrefs = entry.xrefs;
+	Shared.context.macros = entry.macros.slice();
+	Shared.context.dependencies = entry.dependencies.slice();
+	Shared.context.identAsm = entry.identAsm;
+	libdec.core.print(entry.session);
+}
 
 function decompile_offset(architecture, fcnname) {
+	var key = session_key();
+	var cached = key ? SessionCache.get(key) : null;
+	Shared.timing.cache = key ? (cached ? 'hit' : 'miss') : 'off';
+	if (cached) {
+		Shared.timing.mark('lookup');
+		Shared.profile.phase('print');
+		print_cached(cached);
+		Shared.timing.mark('print');
+		return;
+	}
+
+	Variable.resetNames();
+	Shared.profile.phase('fetch');
 	var data = new r2util.data();
 	Shared.argdb = data.argdb;
+	Shared.timing.mark('fetch');
 	// af seems to break renaming.
 	/* asm.pseudo breaks things.. */
 	if (data.graph && data.graph.length > 0) {
+		Shared.profile.phase('pre');
 		var p = new libdec.core.session(data, architecture);
 		var arch_context = architecture.context(data);
 		libdec.core.analysis.pre(p, architecture, arch_context);
+		Shared.profile.phase('decompile');
 		libdec.core.decompile(p, architecture, arch_context);
+		Shared.profile.phase('post');
 		libdec.core.analysis.post(p, architecture, arch_context);
+		Shared.timing.mark('decompile');
+		Shared.profile.phase('print');
+		if (key && p.routine) {
+			SessionCache.add({
+				key: key,
+				session: p,
+				argdb: Shared.argdb,
+				xrefs: Shared.xrefs,
+				macros: Shared.context.macros.slice(),
+				dependencies: Shared.context.dependencies.slice(),
+				identAsm: Shared.context.identAsm,
+			});
+		}
 		libdec.core.print(p);
+		Shared.timing.mark('print');
 	} else if (Shared.evars.extra.allfunctions) {
 		Shared.context.printLog('Error: Please analyze the ' + fcnname + ' first.', true);
 	} else {
@@ -44,6 +490,14 @@ function main(args) {
 	var lines = null;
 	var errors = [];
 	var log = [];
+	// the runtime is reused between runs.
+	Shared.evars = null;
+	Shared.context = null;
+	Shared.printer = null;
+	CCalls.resetPrinted();
+	Shared.timing = new Timing();
+	Shared.profile = new Profile();
+	Shared.profile.phase('setup');
 	try {
 		Shared.evars = r2util.evars(args);
 		r2util.sanitize(true, Shared.evars);
@@ -61,34 +515,74 @@ function main(args) {
 			Shared.context = new libdec.context();
 			var current = r2pipe.long('s');
 			if (Shared.evars.extra.allfunctions) {
-				var functions = r2pipe.json('aflj');
+				var shard = Shared.evars.extra.shard;
+				var functions = r2pipe.json('aflj', []).filter(function(x) {
+					return !x.name.startsWith('sym.imp.') && !x.name.startsWith('loc.imp.');
+				});
+				if (shard) {
+					functions = Shard.select(functions, shard);
+				}
+				var dedup = Shared.evars.extra.dedup ? new Dedup(Shared.evars.extra.dedup_compact) : null;
+				var exporter = Shared.evars.extra.export ? new Export(Shared.evars.extra.export, Shared.evars.extra.export_annotation) : null;
+				if (exporter && !exporter.open()) {
+					Shared.context.printLog('Error: cannot export to ' + exporter.dir, true);
+					functions = [];
+					exporter = null;
+				}
+				// exported files are not merged, thus they have no shard markers.
+				var markers = shard && !exporter;
+				if (radare2.prefetch && functions.length > 1) {
+					// graph and variables of the next functions are fetched while decompiling.
+					radare2.prefetch(functions.map(function(x) {
+						return '0x' + (x.offset || x.addr).toString(16);
+					}));
+				}
 				functions.forEach(function(x) {
-					if (x.name.startsWith('sym.imp.') || x.name.startsWith('loc.imp.')) {
-						return;
-					}
 					var fcn_addr = x.offset || x.addr;
+					var o = Shared.context;
 					r2pipe.string('s 0x' + fcn_addr.toString(16));
+					if (exporter) {
+						Shared.context = new libdec.context();
+					}
+					if (markers) {
+						Shared.context.printLine(Shard.function(fcn_addr), fcn_addr);
+					}
 					Shared.context.printLine("", fcn_addr);
 					Shared.context.printLine(Shared.printer.theme.comment('/* name: ' + x.name + ' @ 0x' + fcn_addr.toString(16) + ' */'), fcn_addr);
-					decompile_offset(architecture, x.name);
+					if (!dedup || !dedup.emit(x, fcn_addr)) {
+						decompile_offset(architecture, x.name);
+						if (dedup) {
+							dedup.add();
+						}
+					}
+					Shared.profile.function(x.name, fcn_addr);
+					Shared.profile.phase('setup');
+					if (markers) {
+						Shared.context.printLine(Shard.end, fcn_addr);
+					}
+					if (exporter) {
+						exporter.write(x, fcn_addr, Shared.context);
+						o.errors = o.errors.concat(Shared.context.errors);
+						o.log = o.log.concat(Shared.context.log);
+						Shared.context = o;
+					}
 				});
-				r2pipe.string('s 0x' + current.toString(16));
-				var r2version = '';
-				if (Shared.evars.version) {
-				    r2version = ' (r2 ' + Shared.evars.version + ')';
+				if (dedup) {
+					log.push(dedup.toString());
 				}
-				var o = Shared.context;
-				Shared.context = new libdec.context();
-				Shared.context.macros = o.macros;
-				Shared.context.dependencies = o.dependencies;
-				Shared.context.printLine(Shared.printer.theme.comment('/* r2dec pseudo code output' + r2version + ' */'), current);
-				Shared.context.printLine(Shared.printer.theme.comment('/* ' + Shared.evars.extra.file + ' */'), current);
-				if (['java', 'dalvik'].indexOf(Shared.evars.arch) < 0) {
-					Shared.context.printMacros(true);
-					Shared.context.printDependencies(true);
+				if (exporter) {
+					log.push(exporter.close());
+				}
+				r2pipe.string('s 0x' + current.toString(16));
+				if (!exporter) {
+					var header = markers ? shard_header_lines(Shared.context, current) : header_lines(Shared.context, current);
+					if (markers) {
+						header.unshift({ str: Shard.header, offset: current });
+						header.unshift({ str: Shard.marker(shard), offset: current });
+						header.push({ str: Shard.end, offset: current });
+					}
+					Shared.context.lines = header.concat(Shared.context.lines);
 				}
-				o.lines = Shared.context.lines.concat(o.lines);
-				Shared.context = o;
 			} else {
 				decompile_offset(architecture, null);
 			}
@@ -105,10 +599,21 @@ function main(args) {
 		errors.push(r2util.debug(Shared.evars, e));
 	}
 
+	if (Shared.evars && Shared.evars.extra.timing) {
+		log.push(Shared.timing.toString());
+	}
+	if (Shared.profile.enabled) {
+		log.push(Shared.profile.toString());
+	}
 	if (!Shared.printer) {
 		Shared.printer = new Printer();
 	}
 	Shared.printer.flushOutput(lines, errors, log);
 }
 
-main([...process.args]);
+r2dec.main = function() {
+	main([...process.args]);
+};
+
+// r2dec-standalone --replay runs the plugin through the testsuite.
+export default main;
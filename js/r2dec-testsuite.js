@@ -4,11 +4,31 @@
 import libdec from './libdec/libdec.js';
 import Printer from './libdec/printer.js';
 import TestSuite from './libdec/testsuite.js';
+import Variable from './libdec/core/variable.js';
+import CCalls from './libdec/db/c_calls.js';
+import Shared from './libdec/shared.js';
+import plugin from './r2dec-plugin.js';
+
+// set by the runtime only with --profile (r2dec.profile).
+var phase = r2dec.phase || function() {};
 
 function main() {
+    if (radare2) {
+        // --replay: radare2 is served from a trace recorded with pddT.
+        plugin([...process.args]);
+        return;
+    }
+    if (r2dec.profile) {
+        r2dec.profile(true);
+    }
+    phase('fetch');
     try {
+        // the runtime can be reused (--server), names must restart from 0
+        // and the shared data must not leak from the previous request.
+        Variable.resetNames();
+        CCalls.resetPrinted();
+        Shared.xrefs = null;
         const test = new TestSuite();
-        var Shared = Global();
         Shared.evars = test.evars;
         Shared.argdb = test.data.argdb;
         Shared.printer = new Printer();
@@ -17,11 +37,15 @@ function main() {
         // af seems to break renaming.
         /* asm.pseudo breaks things.. */
         if (test.data.graph && test.data.graph.length > 0) {
+            phase('pre');
             var p = new libdec.core.session(test.data, architecture, Shared.evars);
             var arch_context = architecture.context(test.data);
             libdec.core.analysis.pre(p, architecture, arch_context);
+            phase('decompile');
             libdec.core.decompile(p, architecture, arch_context);
+            phase('post');
             libdec.core.analysis.post(p, architecture, arch_context);
+            phase('print');
             libdec.core.print(p);
             Shared.printer.flushOutput(Shared.context.lines, Shared.context.errors, Shared.context.log, Shared.evars.extra);
         } else {
@@ -33,6 +57,9 @@ function main() {
         console.log('File:', filename);
         console.log(error);
     }
+    if (r2dec.profile) {
+        console.log(JSON.stringify({ r2dec_profile: r2dec.profile(true) }));
+    }
 }
 
-main();
\ No newline at end of file
+r2dec.main = main;
\ No newline at end of file
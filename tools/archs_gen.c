@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: 2023 Giovanni Dante Grazioli <deroad@libero.it>
+// SPDX-License-Identifier: BSD-3-Clause
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+typedef struct {
+	const char *name; // name of the module under js/libdec/arch/
+	const char *ident; // javascript identifier used in the import
+	const char *aliases[4];
+} arch_t;
+
+static const arch_t archs[] = {
+	{ "6502", "_6502", { NULL } },
+	{ "8051", "_8051", { NULL } },
+	{ "arm", "arm", { NULL } },
+	{ "avr", "avr", { NULL } },
+	{ "dalvik", "dalvik", { NULL } },
+	{ "m68k", "m68k", { NULL } },
+	{ "mips", "mips", { NULL } },
+	{ "nds32", "nds32", { NULL } },
+	{ "ppc", "ppc", { NULL } },
+	{ "riscv", "riscv", { NULL } },
+	{ "sh", "sh", { NULL } },
+	{ "sparc", "sparc", { NULL } },
+	{ "stm8", "stm8", { NULL } },
+	{ "v850", "v850", { NULL } },
+	{ "wasm", "wasm", { NULL } },
+	{ "x86", "x86", { NULL } },
+	{ "sbf", "sbf", { "bpf", "sbpf", "ebpf", NULL } },
+};
+
+#define N_ARCHS (sizeof(archs) / sizeof(archs[0]))
+
+static int find_arch(const char *name) {
+	for (size_t i = 0; i < N_ARCHS; ++i) {
+		if (!strcmp(archs[i].name, name)) {
+			return (int)i;
+		}
+		for (size_t j = 0; archs[i].aliases[j]; ++j) {
+			if (!strcmp(archs[i].aliases[j], name)) {
+				return (int)i;
+			}
+		}
+	}
+	return -1;
+}
+
+static void print_key(FILE *output, const char *name) {
+	if (name[0] >= '0' && name[0] <= '9') {
+		fprintf(output, "\t'%s': ", name);
+	} else {
+		fprintf(output, "\t%s: ", name);
+	}
+}
+
+int main(int argc, char const *argv[]) {
+	if (argc < 3) {
+		printf("usage %s <archs.js> <all|arch> [arch ...]\n", argv[0]);
+		return 1;
+	}
+
+	int selected[N_ARCHS] = { 0 };
+	int all = 0;
+	for (int i = 2; i < argc; ++i) {
+		if (!strcmp(argv[i], "all")) {
+			all = 1;
+			continue;
+		}
+		int idx = find_arch(argv[i]);
+		if (idx < 0) {
+			printf("Error: unknown architecture '%s'\n", argv[i]);
+			return 1;
+		}
+		selected[idx] = 1;
+	}
+
+	FILE *output = fopen(argv[1], "wb");
+	if (!output) {
+		printf("Error opening output file %s\n", argv[1]);
+		return 1;
+	}
+
+	fprintf(output, "// generated by archs_gen, do not edit.\n\n");
+	for (size_t i = 0; i < N_ARCHS; ++i) {
+		if (all || selected[i]) {
+			fprintf(output, "import %s from './arch/%s.js';\n", archs[i].ident, archs[i].name);
+		}
+	}
+
+	fprintf(output, "\nexport default {\n");
+	int first = 1;
+	for (size_t i = 0; i < N_ARCHS; ++i) {
+		if (!all && !selected[i]) {
+			continue;
+		}
+		if (!first) {
+			fprintf(output, ",\n");
+		}
+		print_key(output, archs[i].name);
+		fprintf(output, "%s", archs[i].ident);
+		for (size_t j = 0; archs[i].aliases[j]; ++j) {
+			fprintf(output, ",\n");
+			print_key(output, archs[i].aliases[j]);
+			fprintf(output, "%s", archs[i].ident);
+		}
+		first = 0;
+	}
+	fprintf(output, "\n};\n");
+
+	fclose(output);
+	return 0;
+}
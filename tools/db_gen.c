@@ -0,0 +1,268 @@
+// SPDX-FileCopyrightText: 2026 Giovanni Dante Grazioli <deroad@kumo.xn--q9jyb4c>
+// SPDX-License-Identifier: BSD-3-Clause
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define MAX_FIELDS 4
+
+typedef struct {
+	unsigned long number;
+	char *fields[MAX_FIELDS]; // name, args and comment of a syscall
+} syscall_t;
+
+typedef struct {
+	unsigned long number;
+	char *archs;
+	char *comment;
+	syscall_t *syscalls;
+	size_t n_syscalls;
+} interrupt_t;
+
+typedef struct {
+	char *name;
+	char *required;
+	char *varargs;
+} call_t;
+
+static void *grow(void *array, size_t count, size_t size) {
+	if (count & (count - 1)) {
+		return array;
+	}
+	array = realloc(array, (count ? count * 2 : 16) * size);
+	if (!array) {
+		printf("Error: out of memory\n");
+		exit(1);
+	}
+	return array;
+}
+
+/**
+ * Splits the line on tabs; missing fields are NULL.
+ */
+static int split(char *line, char *fields[], int max) {
+	line[strcspn(line, "\r\n")] = 0;
+	int n = 0;
+	memset(fields, 0, max * sizeof(char *));
+	for (char *p = line; p && n < max;) {
+		char *tab = strchr(p, '\t');
+		if (tab) {
+			*tab = 0;
+		}
+		fields[n++] = *p ? strdup(p) : NULL;
+		p = tab ? tab + 1 : NULL;
+	}
+	return n;
+}
+
+static int parse_hex(const char *text, unsigned long *value) {
+	char *end = NULL;
+	if (!text || !*text) {
+		return 0;
+	}
+	*value = strtoul(text, &end, 16);
+	return !*end;
+}
+
+static int is_number(const char *text) {
+	if (text && *text == '-') {
+		text++;
+	}
+	if (!text || !*text) {
+		return 0;
+	}
+	return strspn(text, "0123456789") == strlen(text);
+}
+
+static void print_string(FILE *output, const char *str) {
+	if (!str) {
+		fprintf(output, "NULL");
+		return;
+	}
+	fputc('"', output);
+	for (; *str; str++) {
+		if (*str == '"' || *str == '\\') {
+			fputc('\\', output);
+		}
+		fputc(*str, output);
+	}
+	fputc('"', output);
+}
+
+static int compare_syscall(const void *a, const void *b) {
+	unsigned long x = ((const syscall_t *)a)->number, y = ((const syscall_t *)b)->number;
+	return x < y ? -1 : (x > y);
+}
+
+static int compare_interrupt(const void *a, const void *b) {
+	unsigned long x = ((const interrupt_t *)a)->number, y = ((const interrupt_t *)b)->number;
+	return x < y ? -1 : (x > y);
+}
+
+static int compare_call(const void *a, const void *b) {
+	return strcmp(((const call_t *)a)->name, ((const call_t *)b)->name);
+}
+
+static FILE *open_input(const char *file) {
+	FILE *input = fopen(file, "rb");
+	if (!input) {
+		printf("Error opening input file %s\n", file);
+		exit(1);
+	}
+	return input;
+}
+
+static interrupt_t *read_syscalls(const char *file, size_t *n_interrupts) {
+	FILE *input = open_input(file);
+	interrupt_t *interrupts = NULL;
+	char line[1024];
+	char *fields[MAX_FIELDS];
+	size_t n = 0, lineno = 0;
+	while (fgets(line, sizeof(line), input)) {
+		lineno++;
+		if (line[0] == '#' || line[0] == '\n') {
+			continue;
+		}
+		split(line, fields, MAX_FIELDS);
+		if (fields[0] && !strcmp(fields[0], "int")) {
+			interrupts = grow(interrupts, n, sizeof(interrupt_t));
+			interrupt_t *in = &interrupts[n++];
+			memset(in, 0, sizeof(interrupt_t));
+			if (!parse_hex(fields[1], &in->number) || !fields[2]) {
+				printf("Error: %s:%zu: invalid interrupt\n", file, lineno);
+				exit(1);
+			}
+			in->archs = fields[2];
+			in->comment = fields[3];
+			continue;
+		}
+		syscall_t sc = { 0 };
+		if (!n || !parse_hex(fields[0], &sc.number) || (fields[2] && !is_number(fields[2]))) {
+			printf("Error: %s:%zu: invalid syscall\n", file, lineno);
+			exit(1);
+		}
+		memcpy(sc.fields, fields + 1, sizeof(char *) * (MAX_FIELDS - 1));
+		interrupt_t *in = &interrupts[n - 1];
+		in->syscalls = grow(in->syscalls, in->n_syscalls, sizeof(syscall_t));
+		in->syscalls[in->n_syscalls++] = sc;
+	}
+	fclose(input);
+
+	qsort(interrupts, n, sizeof(interrupt_t), compare_interrupt);
+	for (size_t i = 0; i < n; ++i) {
+		if (i > 0 && interrupts[i - 1].number == interrupts[i].number) {
+			printf("Error: %s: duplicated interrupt %lx\n", file, interrupts[i].number);
+			exit(1);
+		}
+		interrupt_t *in = &interrupts[i];
+		qsort(in->syscalls, in->n_syscalls, sizeof(syscall_t), compare_syscall);
+		for (size_t j = 1; j < in->n_syscalls; ++j) {
+			if (in->syscalls[j - 1].number == in->syscalls[j].number) {
+				printf("Error: %s: duplicated syscall %lx of interrupt %lx\n", file, in->syscalls[j].number, in->number);
+				exit(1);
+			}
+		}
+	}
+	*n_interrupts = n;
+	return interrupts;
+}
+
+static call_t *read_calls(const char *file, size_t *n_calls) {
+	FILE *input = open_input(file);
+	call_t *calls = NULL;
+	char line[1024];
+	char *fields[MAX_FIELDS];
+	size_t n = 0, lineno = 0;
+	while (fgets(line, sizeof(line), input)) {
+		lineno++;
+		if (line[0] == '#' || line[0] == '\n') {
+			continue;
+		}
+		split(line, fields, MAX_FIELDS);
+		if (!fields[0] || !is_number(fields[1]) || !fields[2] || strcmp(fields[2], "0") & strcmp(fields[2], "1")) {
+			printf("Error: %s:%zu: invalid call\n", file, lineno);
+			exit(1);
+		}
+		calls = grow(calls, n, sizeof(call_t));
+		calls[n++] = (call_t){ fields[0], fields[1], fields[2] };
+	}
+	fclose(input);
+
+	qsort(calls, n, sizeof(call_t), compare_call);
+	for (size_t i = 1; i < n; ++i) {
+		if (!strcmp(calls[i - 1].name, calls[i].name)) {
+			printf("Error: %s: duplicated call %s\n", file, calls[i].name);
+			exit(1);
+		}
+	}
+	*n_calls = n;
+	return calls;
+}
+
+int main(int argc, char const *argv[]) {
+	if (argc != 4) {
+		printf("usage %s <db_tables.h> <syscalls.tsv> <macros.tsv>\n", argv[0]);
+		return 1;
+	}
+
+	size_t n_interrupts = 0, n_calls = 0, n_syscalls = 0;
+	interrupt_t *interrupts = read_syscalls(argv[2], &n_interrupts);
+	call_t *calls = read_calls(argv[3], &n_calls);
+
+	FILE *output = fopen(argv[1], "wb");
+	if (!output) {
+		printf("Error opening output file %s\n", argv[1]);
+		return 1;
+	}
+
+	fprintf(output, "#ifndef DB_TABLES_H\n");
+	fprintf(output, "#define DB_TABLES_H\n\n");
+	fprintf(output, "/* generated by db_gen from '%s' and '%s', do not edit. */\n\n", argv[2], argv[3]);
+
+	for (size_t i = 0; i < n_interrupts; ++i) {
+		const interrupt_t *in = &interrupts[i];
+		if (!in->n_syscalls) {
+			continue;
+		}
+		fprintf(output, "static const db_syscall_t db_syscalls_%lx[] = {\n", in->number);
+		for (size_t j = 0; j < in->n_syscalls; ++j) {
+			const syscall_t *sc = &in->syscalls[j];
+			fprintf(output, "\t{ 0x%lx, ", sc->number);
+			print_string(output, sc->fields[0]);
+			fprintf(output, ", %s, ", sc->fields[1] ? sc->fields[1] : "-1");
+			print_string(output, sc->fields[2]);
+			fprintf(output, " },\n");
+		}
+		fprintf(output, "};\n\n");
+		n_syscalls += in->n_syscalls;
+	}
+
+	fprintf(output, "static const db_interrupt_t db_interrupts[] = {\n");
+	for (size_t i = 0; i < n_interrupts; ++i) {
+		const interrupt_t *in = &interrupts[i];
+		fprintf(output, "\t{ 0x%lx, ", in->number);
+		print_string(output, in->archs);
+		fprintf(output, ", ");
+		print_string(output, in->comment);
+		if (in->n_syscalls) {
+			fprintf(output, ", db_syscalls_%lx, %zu },\n", in->number, in->n_syscalls);
+		} else {
+			fprintf(output, ", NULL, 0 },\n");
+		}
+	}
+	fprintf(output, "};\n\n");
+
+	fprintf(output, "static const db_call_t db_calls[] = {\n");
+	for (size_t i = 0; i < n_calls; ++i) {
+		const call_t *call = &calls[i];
+		fprintf(output, "\t{ ");
+		print_string(output, call->name);
+		fprintf(output, ", %s, %s },\n", call->required, call->varargs);
+	}
+	fprintf(output, "};\n\n");
+	fprintf(output, "#endif /* DB_TABLES_H */\n");
+
+	fclose(output);
+	printf("r2dec db: %zu interrupts, %zu syscalls, %zu calls\n", n_interrupts, n_syscalls, n_calls);
+	return 0;
+}
@@ -6,9 +6,37 @@
 
 const char search[] = "const uint8_t qjsc_";
 
+/* counts the modules and the bytecode bytes of a qjsc output */
+static int bytecode_size(const char *path, unsigned long *n_modules, unsigned long *total_size) {
+	char line[1024];
+	FILE *input = fopen(path, "rb");
+	if (!input) {
+		printf("Error opening input file %s\n", path);
+		return 0;
+	}
+
+	size_t search_size = sizeof(search) - 1;
+	*n_modules = *total_size = 0;
+	while (fgets(line, sizeof(line), input)) {
+		char *p = strncmp(line, search, search_size) ? NULL : strchr(line + search_size, '[');
+		if (p) {
+			(*n_modules)++;
+			*total_size += strtoul(p + 1, NULL, 10);
+		}
+	}
+	fclose(input);
+	return 1;
+}
+
 int main(int argc, char const *argv[]) {
-	if (argc != 3) {
-		printf("usage %s <bytecode.h> <bytecode_mod.h>\n", argv[0]);
+	if (argc != 3 && argc != 4) {
+		printf("usage %s <bytecode.h> <bytecode_mod.h> [<full bytecode.h>]\n", argv[0]);
+		return 1;
+	}
+
+	/* with -Darchs, the bytecode of all the architectures is the reference */
+	unsigned long full_modules = 0, full_size = 0;
+	if (argc == 4 && !bytecode_size(argv[3], &full_modules, &full_size)) {
 		return 1;
 	}
 
@@ -34,6 +62,7 @@ int main(int argc, char const *argv[]) {
 	fprintf(output, "static inline int js_load_all_modules(JSContext *ctx) {\n");
 	fprintf(output, "\treturn ");
 	int first = 1;
+	unsigned long n_modules = 0, total_size = 0;
 
 	size_t search_size = sizeof(search) - 1;
 	while (fgets(line, sizeof(line), input)) {
@@ -45,6 +74,8 @@ int main(int argc, char const *argv[]) {
 
 		char *p = strchr(line + search_size, '[');
 		*p = 0;
+		n_modules++;
+		total_size += strtoul(p + 1, NULL, 10);
 
 		p = line + search_size;
 		fprintf(output, "js_add_module(ctx, qjsc_%s, qjsc_%s_size)", p, p);
@@ -54,9 +85,18 @@ int main(int argc, char const *argv[]) {
 		fprintf(output, "1");
 	}
 	fprintf(output, ";\n}\n\n");
+	fprintf(output, "#define R2DEC_BYTECODE_MODULES (%lu)\n", n_modules);
+	fprintf(output, "#define R2DEC_BYTECODE_SIZE (%lu)\n\n", total_size);
 	fprintf(output, "#endif /* BYTECODE_MOD_H */\n");
 
 	fclose(input);
 	fclose(output);
+	if (argc == 4) {
+		long delta = (long)full_size - (long)total_size;
+		printf("r2dec bytecode: %lu modules, %lu bytes (all architectures: %lu modules, %lu bytes, %ld bytes less)\n",
+			n_modules, total_size, full_modules, full_size, delta);
+	} else {
+		printf("r2dec bytecode: %lu modules, %lu bytes\n", n_modules, total_size);
+	}
 	return 0;
 }
@@ -63,6 +63,7 @@ typedef struct namelist_t {
 static namelist_t cname_list;
 static namelist_t cmodule_list;
 static namelist_t init_module_list;
+static namelist_t remap_module_list;
 static OutputTypeEnum output_type;
 static FILE *outfile;
 static const char *c_ident_prefix = "qjsc_";
@@ -329,8 +330,20 @@ JSModuleDef *jsc_module_loader(JSContext *ctx,
         uint8_t *buf;
         JSValue func_val;
         char cname[1024];
+        const char *filename = module_name;
+        int i;
+
+        /* a remapped module keeps its name (so its relative imports
+           still resolve) but its source is read from another file */
+        for(i = 0; i < remap_module_list.count; i++) {
+            e = &remap_module_list.array[i];
+            if (js__has_suffix(module_name, e->name)) {
+                filename = e->short_name;
+                break;
+            }
+        }
 
-        buf = js_load_file(ctx, &buf_len, module_name);
+        buf = js_load_file(ctx, &buf_len, filename);
         if (!buf) {
             JS_ThrowReferenceError(ctx, "could not load module filename '%s'",
                                    module_name);
@@ -432,6 +445,7 @@ void help(void)
            "-D module_name         compile a dynamically loaded module or worker\n"
            "-M module_name[,cname] add initialization code for an external C module\n"
            "-p prefix   set the prefix of the generated C names\n"
+           "-R suffix=file         load the modules ending with 'suffix' from 'file'\n"
            "-s          strip the source code, specify twice to also strip debug info\n"
            "-S n        set the maximum stack size to 'n' bytes (default=%d)\n",
            JS_GetVersion(),
@@ -467,7 +481,7 @@ int main(int argc, char **argv)
     namelist_add(&cmodule_list, "bjson", "bjson", 0);
 
     for(;;) {
-        c = getopt(argc, argv, "ho:N:mn:bxesvM:p:S:D:");
+        c = getopt(argc, argv, "ho:N:mn:bxesvM:p:S:D:R:");
         if (c == -1)
             break;
         switch(c) {
@@ -510,6 +524,20 @@ int main(int argc, char **argv)
         case 'D':
             namelist_add(&dynamic_module_list, optarg, NULL, 0);
             break;
+        case 'R':
+            {
+                char suffix[1024];
+                char *p;
+                js__pstrcpy(suffix, sizeof(suffix), optarg);
+                p = strchr(suffix, '=');
+                if (!p || p == suffix || !p[1]) {
+                    fprintf(stderr, "invalid remap '%s', expected suffix=file\n", optarg);
+                    exit(1);
+                }
+                *p = '\0';
+                namelist_add(&remap_module_list, suffix, p + 1, 0);
+            }
+            break;
         case 's':
             strip++;
             break;
@@ -645,5 +673,6 @@ int main(int argc, char **argv)
     namelist_free(&cname_list);
     namelist_free(&cmodule_list);
     namelist_free(&init_module_list);
+    namelist_free(&remap_module_list);
     return 0;
 }